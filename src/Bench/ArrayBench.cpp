@@ -0,0 +1,229 @@
+// Benchmark for DqnArray growth. Pushes ARRAY_BENCH_NUM_PUSHES elements one at a time into one big
+// array and into many small ones, each starting at the capacity the Winjump core starts its arrays
+// at, with the old 1.2x growth factor, the 2x default and with the whole count reserved up front.
+// The single array is also grown in place on a virtual memory stack, with and without huge pages.
+// Reports the push throughput and how many times the array was relocated, then checks a type that
+// isn't trivially copyable survives relocation, insertion, removal and resizing with every element
+// constructed and destructed exactly once.
+#include "Bench.h"
+
+#define ARRAY_BENCH_NUM_PUSHES       1000000
+#define ARRAY_BENCH_MAX_ARRAYS       10000
+#define ARRAY_BENCH_NUM_RUNS         5
+#define ARRAY_BENCH_INITIAL_CAPACITY 4
+#define ARRAY_BENCH_OLD_GROWTH       1.2f
+#define ARRAY_BENCH_VIRTUAL_RESERVE  DQN_MEGABYTE(256)
+
+typedef struct BenchItem
+{
+	u64 window;
+	u32 pid;
+	u32 index;
+} BenchItem;
+
+// NOTE: Not trivially copyable, it points into itself so a memcpy'd relocation leaves it pointing
+// at the old allocation
+struct BenchSelfRef
+{
+	u32  value;
+	u32 *self;
+
+	BenchSelfRef()                          : value(0), self(&value) { globalNumLive++; }
+	BenchSelfRef(const u32 v)               : value(v), self(&value) { globalNumLive++; }
+	BenchSelfRef(const BenchSelfRef &other) : value(other.value), self(&value) { globalNumLive++; }
+	BenchSelfRef(BenchSelfRef &&other)      : value(other.value), self(&value) { globalNumLive++; }
+	~BenchSelfRef()                                                          { globalNumLive--; }
+	BenchSelfRef &operator=(const BenchSelfRef &other) { value = other.value; return *this; }
+
+	bool IsValid() const { return self == &value; }
+
+	static i32 globalNumLive;
+};
+i32 BenchSelfRef::globalNumLive;
+
+FILE_SCOPE u32 globalNumRelocations;
+FILE_SCOPE void BenchCountingCallback(DqnMemAPICallbackInfo info, DqnMemAPICallbackResult *result)
+{
+	if (info.type == DqnMemAPICallbackType_Realloc) globalNumRelocations++;
+
+	DqnMemAPI defaultAPI = DqnMemAPI_DefaultUseCalloc();
+	defaultAPI.callback(info, result);
+}
+
+FILE_SCOPE DqnMemAPI BenchCountingMemAPI()
+{
+	DqnMemAPI result = {};
+	result.callback  = BenchCountingCallback;
+	return result;
+}
+
+struct BenchPushResult
+{
+	BenchTimer timer;
+	u32        numRelocations;
+	u64        capacity;
+};
+
+// Push ARRAY_BENCH_NUM_PUSHES items spread evenly over numArrays arrays.
+// growthFactor: 0 reserves each array's share up front.
+FILE_SCOPE BenchPushResult BenchPush(const f32 growthFactor, const u32 numArrays)
+{
+	LOCAL_PERSIST DqnArray<BenchItem> arrays[ARRAY_BENCH_MAX_ARRAYS];
+	u32 pushesPerArray = ARRAY_BENCH_NUM_PUSHES / numArrays;
+
+	BenchPushResult result = {};
+	for (u32 run = 0; run < ARRAY_BENCH_NUM_RUNS; run++)
+	{
+		for (u32 i = 0; i < numArrays; i++)
+		{
+			arrays[i] = {};
+			DQN_ASSERT_HARD(DqnArray_Init(&arrays[i], ARRAY_BENCH_INITIAL_CAPACITY, BenchCountingMemAPI()));
+			arrays[i].growthFactor = growthFactor;
+		}
+
+		globalNumRelocations = 0;
+		BenchItem item       = {};
+		BenchTimer_Start(&result.timer);
+		for (u32 i = 0; i < numArrays; i++)
+		{
+			DqnArray<BenchItem> *array = &arrays[i];
+			if (growthFactor == 0) DQN_ASSERT_HARD(DqnArray_Reserve(array, pushesPerArray));
+
+			for (u32 j = 0; j < pushesPerArray; j++)
+			{
+				item.pid = j;
+				DQN_ASSERT_HARD(DqnArray_Push(array, item));
+			}
+		}
+		BenchTimer_Stop(&result.timer);
+		BenchTimer_EndRun(&result.timer);
+
+		result.numRelocations = globalNumRelocations;
+		result.capacity       = arrays[0].capacity;
+		for (u32 i = 0; i < numArrays; i++) DqnArray_Free(&arrays[i]);
+	}
+
+	return result;
+}
+
+// Push ARRAY_BENCH_NUM_PUSHES items into one array allocated from a virtual memory stack, which is
+// the stack's only allocation so every grow extends it in place. The stack is cleared between runs
+// like a per frame arena, keeping its pages, and only decommitted at the end.
+FILE_SCOPE BenchPushResult BenchPushVirtual(const u32 virtualFlags)
+{
+	DqnMemStack stack = {};
+	DQN_ASSERT_HARD(DqnMemStack_InitWithVirtualMem(&stack, ARRAY_BENCH_VIRTUAL_RESERVE, virtualFlags));
+
+	BenchPushResult result = {};
+	for (u32 run = 0; run < ARRAY_BENCH_NUM_RUNS; run++)
+	{
+		DqnArray<BenchItem> array = {};
+		DQN_ASSERT_HARD(DqnArray_Init(&array, ARRAY_BENCH_INITIAL_CAPACITY, DqnMemAPI_StackAllocator(&stack)));
+
+		u32 numRelocations = 0;
+		BenchItem item     = {};
+		BenchTimer_Start(&result.timer);
+		for (u32 j = 0; j < ARRAY_BENCH_NUM_PUSHES; j++)
+		{
+			BenchItem *prevData = array.data;
+			item.pid            = j;
+			DQN_ASSERT_HARD(DqnArray_Push(&array, item));
+			if (array.data != prevData) numRelocations++;
+		}
+		BenchTimer_Stop(&result.timer);
+		BenchTimer_EndRun(&result.timer);
+
+		result.numRelocations = numRelocations;
+		result.capacity       = array.capacity;
+		DqnArray_Free(&array);
+		DqnMemStack_ClearCurrBlock(&stack, false);
+	}
+
+	// NOTE: Clearing keeps the pages, check decommitting returns all but the first commit
+	DQN_ASSERT_HARD(stack.block->committed >= ARRAY_BENCH_NUM_PUSHES * sizeof(BenchItem));
+	DQN_ASSERT_HARD(DqnMemStack_DecommitUnused(&stack));
+	DQN_ASSERT_HARD(stack.block->committed <= stack.block->commitSize);
+	DqnMemStack_Free(&stack);
+	return result;
+}
+
+FILE_SCOPE void BenchPrint(BenchTable *const table, const char *const name, const BenchPushResult result)
+{
+	BenchTable_Row(table, name, result.timer.bestMs);
+	printf(" %11u %11llu\n", result.numRelocations, (unsigned long long)result.capacity);
+}
+
+FILE_SCOPE void BenchRun(const u32 numArrays)
+{
+	BenchTable table = {};
+	table.nameWidth  = 16;
+	table.numOps     = ARRAY_BENCH_NUM_PUSHES;
+	table.opsName    = "pushes";
+
+	printf("%d array(s) of %d items\n", numArrays, ARRAY_BENCH_NUM_PUSHES / numArrays);
+	BenchTable_Header(&table, "Relocations    Capacity");
+	BenchPrint(&table, "1.2x (previous)", BenchPush(ARRAY_BENCH_OLD_GROWTH, numArrays));
+	BenchPrint(&table, "2x (default)",    BenchPush(DQN_ARRAY_GROWTH_FACTOR, numArrays));
+	BenchPrint(&table, "Reserved",        BenchPush(0, numArrays));
+	if (numArrays == 1)
+	{
+		BenchPrint(&table, "Virtual arena", BenchPushVirtual(0));
+		BenchPrint(&table, "Virtual, 2MB",  BenchPushVirtual(DqnMemStackVirtualFlag_HugePages));
+	}
+	printf("\n");
+}
+
+FILE_SCOPE bool BenchSelfRefIsOdd(const BenchSelfRef *const item, void *const userData)
+{
+	return (item->value & 1) != 0;
+}
+
+// return: FALSE if any element was left pointing outside the array or wasn't destructed.
+FILE_SCOPE bool BenchValidateNonTrivial()
+{
+	bool result = true;
+	{
+		DqnArray<BenchSelfRef> array = {};
+		DqnArray_Init(&array, 1);
+		for (u32 i = 0; i < 10000; i++)
+			result &= (DqnArray_Push(&array, BenchSelfRef(i)) != NULL);
+
+		DqnArray_RemoveStable(&array, 0);
+		DqnArray_Remove(&array, 10);
+		DqnArray_Pop(&array);
+		result &= DqnArray_Resize(&array, array.count + 5000);
+		result &= DqnArray_Reserve(&array, array.capacity * 3);
+		result &= DqnArray_Resize(&array, 100);
+
+		// NOTE: Insert more than are after the index so the shift runs into uninitialised slots
+		BenchSelfRef inserted[] = {BenchSelfRef(100000), BenchSelfRef(100001), BenchSelfRef(100002)};
+		result &= (DqnArray_InsertN(&array, 98, inserted, DQN_ARRAY_COUNT(inserted)) != NULL);
+		result &= (array.data[98].value == 100000 && array.data[101].value == 99);
+		result &= DqnArray_EraseRange(&array, 98, DQN_ARRAY_COUNT(inserted));
+		result &= (DqnArray_RemoveIf(&array, BenchSelfRefIsOdd, NULL, 1) == 49);
+
+		for (u64 i = 0; i < array.count; i++) result &= array.data[i].IsValid();
+		result &= (array.data[0].value == 1 && array.data[5].value == 10);
+		result &= (BenchSelfRef::globalNumLive == (i32)array.count + (i32)DQN_ARRAY_COUNT(inserted));
+		DqnArray_Free(&array);
+	}
+
+	result &= (BenchSelfRef::globalNumLive == 0);
+	return result;
+}
+
+int main(int argc, char *argv[])
+{
+	printf("DqnArray Growth Benchmark\n");
+	printf("Pushes: %d of %d byte items, Initial capacity: %d, Best of %d runs\n\n", ARRAY_BENCH_NUM_PUSHES,
+	       (i32)sizeof(BenchItem), ARRAY_BENCH_INITIAL_CAPACITY, ARRAY_BENCH_NUM_RUNS);
+
+	// NOTE: One big array where realloc can often extend in place, then many small ones like the
+	// core's per frame arrays where every relocation is a copy
+	BenchRun(1);
+	BenchRun(ARRAY_BENCH_MAX_ARRAYS);
+
+	BenchChecks checks = {};
+	BenchChecks_Add(&checks, "Relocating, inserting and removing non-trivial elements", BenchValidateNonTrivial());
+	return BenchChecks_Report(&checks, "Non-trivial relocation");
+}
@@ -0,0 +1,141 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// Shared by the benchmarks of the dqn library, each is one translation unit that includes this
+// first so it carries the dqn implementation. A benchmark only holds its workload and its checks:
+// each case is timed over a number of runs with a BenchTimer which keeps the best, printed as a row
+// of a BenchTable against a baseline, and every check is recorded in BenchChecks which prints the
+// result and gives the exit code.
+#define DQN_IMPLEMENTATION
+#define DQN_PLATFORM_HEADER
+#if defined(_WIN32)
+	#define DQN_WIN32_IMPLEMENTATION
+#else
+	#define DQN_UNIX_IMPLEMENTATION
+#endif
+#include "../dqn.h"
+
+#include <stdio.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Timing
+////////////////////////////////////////////////////////////////////////////////
+// NOTE: A run can be timed in parts with Start and Stop, so setup and checks in between aren't
+// counted. EndRun keeps the run's total if it's the best so far.
+typedef struct BenchTimer
+{
+	f64 bestMs;
+	f64 runMs;   // Time so far in the current run
+	f64 startMs;
+	u32 numRuns;
+} BenchTimer;
+
+FILE_SCOPE void BenchTimer_Start(BenchTimer *const timer)
+{
+	timer->startMs = DqnTimer_NowInMs();
+}
+
+FILE_SCOPE void BenchTimer_Stop(BenchTimer *const timer)
+{
+	timer->runMs += DqnTimer_NowInMs() - timer->startMs;
+}
+
+// return: The time of the run that ended.
+FILE_SCOPE f64 BenchTimer_EndRun(BenchTimer *const timer)
+{
+	f64 result = timer->runMs;
+	if (timer->numRuns == 0 || result < timer->bestMs) timer->bestMs = result;
+	timer->runMs = 0;
+	timer->numRuns++;
+	return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Printing
+////////////////////////////////////////////////////////////////////////////////
+typedef struct BenchTable
+{
+	i32         nameWidth;
+	f64         numOps;     // Ops per run, 0 leaves out the throughput column
+	const char *opsName;    // Printed as "M <opsName>/s"
+	f64         baselineMs; // Rows are compared against this, set by the first row if 0
+} BenchTable;
+
+// Print the table's header row.
+// columns: The header of the benchmark's own columns, NULL if it has none.
+FILE_SCOPE void BenchTable_Header(const BenchTable *const table, const char *const columns)
+{
+	printf("  %-*s %11s", table->nameWidth, "", "Time");
+	if (table->numOps > 0) printf(" %*s", 12 + DqnStr_Len(table->opsName), "Throughput");
+	printf(" %7s", "Speedup");
+	if (columns) printf(" %s", columns);
+	printf("\n");
+}
+
+// Print the name, best time, throughput and speed up over the baseline of a row. The benchmark
+// prints any columns of its own after it, each starting with a space, and ends the line.
+FILE_SCOPE void BenchTable_Row(BenchTable *const table, const char *const name, const f64 bestMs)
+{
+	if (table->baselineMs == 0) table->baselineMs = bestMs;
+
+	printf("  %-*s %8.3f ms", table->nameWidth, name, bestMs);
+	if (table->numOps > 0) printf(" %7.1f M %s/s", (table->numOps / 1000.0) / bestMs, table->opsName);
+	printf(" %6.2fx", table->baselineMs / bestMs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Checking
+////////////////////////////////////////////////////////////////////////////////
+typedef struct BenchChecks
+{
+	u32 numChecks;
+	u32 numFailed;
+} BenchChecks;
+
+// Record a check, a failed check is printed by name straight away.
+// return: passed
+FILE_SCOPE bool BenchChecks_Add(BenchChecks *const checks, const char *const name, const bool passed)
+{
+	checks->numChecks++;
+	if (!passed)
+	{
+		checks->numFailed++;
+		printf("  FAILED: %s\n", name);
+	}
+
+	return passed;
+}
+
+// Print whether every check passed under summary, i.e. "Alignment and overlap".
+// return: The exit code for main(), 0 if every check passed.
+FILE_SCOPE int BenchChecks_Report(const BenchChecks *const checks, const char *const summary)
+{
+	bool valid = (checks->numFailed == 0);
+	printf("%s: %s\n", summary, valid ? "OK" : "INVALID");
+	return valid ? 0 : 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Threading
+////////////////////////////////////////////////////////////////////////////////
+// Start a worker per hardware thread but one, the main thread helps whilst it waits on the queue.
+// numThreads: Set to the number of worker threads started.
+// return:     FALSE if the threads could not be created, after printing why.
+FILE_SCOPE bool BenchJobQueue_Init(DqnJobQueue *const queue, DqnJob *const jobList, const u32 jobListSize,
+                                   u32 *const numThreads)
+{
+	u32 numCores = 0, numThreadsPerCore = 0;
+	DqnPlatform_GetNumThreadsAndCores(&numCores, &numThreadsPerCore);
+	*numThreads = DQN_MAX(numCores * numThreadsPerCore, 2) - 1;
+
+	*queue = {};
+	if (!DqnJobQueue_Init(queue, jobList, jobListSize, *numThreads))
+	{
+		printf("DqnJobQueue_Init() failed\n");
+		return false;
+	}
+
+	return true;
+}
+
+#endif /* BENCH_H */
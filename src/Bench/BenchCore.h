@@ -0,0 +1,290 @@
+#ifndef BENCH_CORE_H
+#define BENCH_CORE_H
+
+// Shared by the benchmarks that drive the Winjump core. A synthetic window source stands in for
+// EnumWindows(), a null list view counts the edits it's sent and BenchUpdate() runs the core the
+// same way Winjump_Update() does.
+#include "../WinjumpCore.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+FILE_SCOPE const wchar_t *const BENCH_TITLE_WORDS[] = {
+    L"Inbox",  L"Project", L"Report", L"Meeting",  L"Notes", L"Budget", L"Release",  L"Design",
+    L"Review", L"Search",  L"Build",  L"Terminal", L"Music", L"Photos", L"Settings", L"Calendar",
+};
+
+FILE_SCOPE const wchar_t *const BENCH_EXE_NAMES[] = {
+    L"firefox.exe", L"chrome.exe", L"code.exe",  L"explorer.exe", L"outlook.exe",
+    L"slack.exe",   L"spotify.exe", L"devenv.exe", L"cmd.exe",      L"gvim.exe",
+};
+
+typedef struct BenchWindow
+{
+	u32     id;
+	u32     pid;
+	wchar_t title[128];
+	i32     titleLen;
+} BenchWindow;
+
+typedef struct BenchWindowSource
+{
+	DqnArray<BenchWindow> windows;
+	DqnRandPCGState       rnd;
+	u32                   nextId;
+	u32                   numProcesses;
+	DqnLock               resolveLock; // Hold to keep exe resolves pending on the job threads
+} BenchWindowSource;
+
+typedef struct BenchListView
+{
+	i32 numRows;
+	u32 numEdits;
+} BenchListView;
+
+////////////////////////////////////////////////////////////////////////////////
+// Synthetic Window Source
+////////////////////////////////////////////////////////////////////////////////
+FILE_SCOPE void BenchWindowRetitle(BenchWindowSource *const bench, BenchWindow *const window)
+{
+	const wchar_t *word1 = BENCH_TITLE_WORDS[DqnRnd_PCGRange(&bench->rnd, 0, DQN_ARRAY_COUNT(BENCH_TITLE_WORDS) - 1)];
+	const wchar_t *word2 = BENCH_TITLE_WORDS[DqnRnd_PCGRange(&bench->rnd, 0, DQN_ARRAY_COUNT(BENCH_TITLE_WORDS) - 1)];
+	window->titleLen     = swprintf(window->title, DQN_ARRAY_COUNT(window->title), L"%ls %ls #%d",
+	                                word1, word2, DqnRnd_PCGRange(&bench->rnd, 0, 9999));
+}
+
+FILE_SCOPE void BenchWindowCreate(BenchWindowSource *const bench, BenchWindow *const window)
+{
+	window->id  = ++bench->nextId; // NOTE: 0 is never a valid handle
+	window->pid = 1000 + (u32)DqnRnd_PCGRange(&bench->rnd, 0, bench->numProcesses - 1);
+	BenchWindowRetitle(bench, window);
+}
+
+FILE_SCOPE void BenchSourceEnumerate(WinjumpWindowSource *const source, WinjumpCore *const core)
+{
+	BenchWindowSource *bench = (BenchWindowSource *)source->userData;
+	for (i32 i = 0; i < (i32)bench->windows.count; i++)
+	{
+		BenchWindow *window = &bench->windows.data[i];
+		if (!WinjumpCore_PushWindow(core, (WinjumpWindowHandle)(size_t)window->id, window->pid,
+		                            window->title, window->titleLen))
+			return;
+	}
+}
+
+FILE_SCOPE i32 BenchSourceResolveExe(WinjumpWindowSource *const source, const u32 pid,
+                                     wchar_t *const exe, const i32 exeSize)
+{
+	BenchWindowSource *bench = (BenchWindowSource *)source->userData;
+	DqnLock_Acquire(&bench->resolveLock);
+	DqnLock_Release(&bench->resolveLock);
+
+	i32 result = swprintf(exe, exeSize, L"%ls", BENCH_EXE_NAMES[pid % DQN_ARRAY_COUNT(BENCH_EXE_NAMES)]);
+	return DQN_MAX(result, 0);
+}
+
+// return: FALSE if out of memory.
+FILE_SCOPE bool BenchSourceInit(BenchWindowSource *const bench, WinjumpWindowSource *const source,
+                                const u32 seed)
+{
+	*bench = {};
+	DqnRnd_PCGInitWithSeed(&bench->rnd, seed);
+	if (!DqnArray_Init(&bench->windows, 1024)) return false;
+	if (!DqnLock_Init(&bench->resolveLock))    return false;
+
+	*source            = {};
+	source->Enumerate  = BenchSourceEnumerate;
+	source->ResolveExe = BenchSourceResolveExe;
+	source->userData   = bench;
+	return true;
+}
+
+FILE_SCOPE void BenchSourceResize(BenchWindowSource *const bench, const i32 numWindows)
+{
+	DqnArray_Clear(&bench->windows);
+	bench->numProcesses = DQN_MAX(numWindows / 4, 1);
+	for (i32 i = 0; i < numWindows; i++)
+	{
+		BenchWindow window = {};
+		BenchWindowCreate(bench, &window);
+		DqnArray_Push(&bench->windows, window);
+	}
+}
+
+// Retitle percent of the windows, and replace a fifth as many with new ones so the table size
+// stays steady.
+FILE_SCOPE void BenchSourceChurn(BenchWindowSource *const bench, const i32 percent)
+{
+	i32 numWindows = (i32)bench->windows.count;
+	if (numWindows == 0) return;
+
+	i32 numRetitle = DQN_MAX((numWindows * percent) / 100, 1);
+	for (i32 i = 0; i < numRetitle; i++)
+	{
+		BenchWindow *window = &bench->windows.data[DqnRnd_PCGRange(&bench->rnd, 0, numWindows - 1)];
+		BenchWindowRetitle(bench, window);
+	}
+
+	i32 numReplace = DQN_MAX(numRetitle / 5, 1);
+	for (i32 i = 0; i < numReplace; i++)
+	{
+		u32 index = (u32)DqnRnd_PCGRange(&bench->rnd, 0, numWindows - 1);
+		DqnArray_RemoveStable(&bench->windows, index);
+
+		BenchWindow window = {};
+		BenchWindowCreate(bench, &window);
+		DqnArray_Push(&bench->windows, window);
+	}
+}
+
+// Apply numEvents window creations, retitles and destructions, like a storm of windows opening and
+// closing. Creations and destructions are biased to keep the table near targetWindows and some new
+// windows belong to new processes, so exes keep being resolved.
+FILE_SCOPE void BenchSourceStorm(BenchWindowSource *const bench, const i32 numEvents, const i32 targetWindows)
+{
+	for (i32 i = 0; i < numEvents; i++)
+	{
+		i32 numWindows = (i32)bench->windows.count;
+		i32 op         = DqnRnd_PCGRange(&bench->rnd, 0, 2);
+		if (numWindows < (targetWindows * 9) / 10)  op = 0;
+		if (numWindows > (targetWindows * 11) / 10) op = 2;
+
+		if (op == 0 || numWindows == 0)
+		{
+			if (DqnRnd_PCGRange(&bench->rnd, 0, 4) == 0) bench->numProcesses++;
+
+			BenchWindow window = {};
+			BenchWindowCreate(bench, &window);
+			DqnArray_Push(&bench->windows, window);
+		}
+		else if (op == 1)
+		{
+			BenchWindowRetitle(bench, &bench->windows.data[DqnRnd_PCGRange(&bench->rnd, 0, numWindows - 1)]);
+		}
+		else
+		{
+			DqnArray_RemoveStable(&bench->windows, (u64)DqnRnd_PCGRange(&bench->rnd, 0, numWindows - 1));
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Null List View
+////////////////////////////////////////////////////////////////////////////////
+FILE_SCOPE void BenchViewSetRow(WinjumpListView *const view, const i32 index, const WinjumpProgram *const program)
+{
+	BenchListView *bench = (BenchListView *)view->userData;
+	DQN_ASSERT(index < bench->numRows);
+	bench->numEdits++;
+}
+
+FILE_SCOPE void BenchViewAddRow(WinjumpListView *const view, const WinjumpProgram *const program)
+{
+	BenchListView *bench = (BenchListView *)view->userData;
+	bench->numRows++;
+	bench->numEdits++;
+}
+
+FILE_SCOPE void BenchViewRemoveRow(WinjumpListView *const view, const i32 index)
+{
+	BenchListView *bench = (BenchListView *)view->userData;
+	DQN_ASSERT(index == bench->numRows - 1);
+	bench->numRows--;
+	bench->numEdits++;
+}
+
+FILE_SCOPE void BenchViewInit(BenchListView *const bench, WinjumpListView *const view)
+{
+	*bench          = {};
+	*view           = {};
+	view->SetRow    = BenchViewSetRow;
+	view->AddRow    = BenchViewAddRow;
+	view->RemoveRow = BenchViewRemoveRow;
+	view->userData  = bench;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Measuring
+////////////////////////////////////////////////////////////////////////////////
+#define BENCH_MAX_SAMPLES 65536 // Samples past this are dropped, keep BenchTimings in static storage
+
+typedef struct BenchTimings
+{
+	f32 samples[BENCH_MAX_SAMPLES];
+	u32 numSamples;
+	u32 numUpdates;
+	u32 numEdits;
+	u64 numAllocs; // DqnMem allocations and reallocations
+} BenchTimings;
+
+FILE_SCOPE bool BenchF32IsLessThan(const void *const val1, const void *const val2)
+{
+	bool result = (*(const f32 *)val1) < (*(const f32 *)val2);
+	return result;
+}
+
+FILE_SCOPE void BenchTimingsPrint(const char *const name, BenchTimings *const timings)
+{
+	if (timings->numSamples == 0) return;
+
+	Dqn_QuickSort(timings->samples, timings->numSamples, BenchF32IsLessThan);
+	f32 p50 = timings->samples[(u32)((timings->numSamples - 1) * 0.50f)];
+	f32 p99 = timings->samples[(u32)((timings->numSamples - 1) * 0.99f)];
+	f32 max = timings->samples[timings->numSamples - 1];
+	printf("  %-22s %8.3f %8.3f %8.3f ms  %6.2f updates, %8.1f list edits, %6.2f allocs\n", name, p50,
+	       p99, max, (f32)timings->numUpdates / timings->numSamples,
+	       (f32)timings->numEdits / timings->numSamples, (f32)timings->numAllocs / timings->numSamples);
+}
+
+// return: The value after name on the command line, at least 1, or defaultValue if it's not given.
+FILE_SCOPE i32 BenchArgToInt(const int argc, char *argv[], const char *const name, const i32 defaultValue)
+{
+	for (i32 i = 1; i + 1 < argc; i++)
+	{
+		if (strcmp(argv[i], name) == 0) return DQN_MAX(atoi(argv[i + 1]), 1);
+	}
+
+	return defaultValue;
+}
+
+FILE_SCOPE u64 BenchNumAllocs()
+{
+	DqnMemStats stats = DqnMem_GetStats();
+	u64 result        = stats.numAllocs + stats.numReallocs;
+	return result;
+}
+
+// Run Winjump_Update()'s core work, updating again until the filter finishes as the event loop
+// does, and record the time to the final result.
+// timings: Optional, the sample to record into.
+// return:  FALSE if out of memory.
+FILE_SCOPE bool BenchUpdate(WinjumpCore *const core, WinjumpListView *const view,
+                            const wchar_t *const search, const i32 searchLen,
+                            BenchTimings *const timings)
+{
+	BenchListView *benchView = (BenchListView *)view->userData;
+	u32 startEdits           = benchView->numEdits;
+	u64 startAllocs          = BenchNumAllocs();
+	f64 startMs              = DqnTimer_NowInMs();
+
+	bool filterFinished = false;
+	while (!filterFinished)
+	{
+		if (!WinjumpCore_Update(core, search, searchLen, &filterFinished)) return false;
+		if (!WinjumpCore_ListSync(core, view)) return false;
+		if (timings) timings->numUpdates++;
+	}
+
+	if (timings && timings->numSamples < DQN_ARRAY_COUNT(timings->samples))
+	{
+		timings->samples[timings->numSamples++] = (f32)(DqnTimer_NowInMs() - startMs);
+		timings->numEdits  += benchView->numEdits - startEdits;
+		timings->numAllocs += BenchNumAllocs() - startAllocs;
+	}
+
+	return true;
+}
+
+#endif /* BENCH_CORE_H */
@@ -0,0 +1,178 @@
+// Benchmark for the platform independent Winjump core on synthetic window tables. A fake window
+// source stands in for EnumWindows() so enumeration, friendly name reuse, filtering, next character
+// speculation and the list diff are timed the same way Winjump_Update() drives them. For each table
+// size it reports the cost of a stable and a churning enumeration and the keystroke-to-result
+// latency of typing then deleting a set of queries, and checks the results against a brute force
+// search, including when the exes only resolve after the search is typed.
+#include "BenchCore.h"
+
+#define NUM_ENUMERATIONS 50
+#define CHURN_PERCENT    5 // Windows retitled per churning enumeration, a fifth as many are replaced
+
+// NOTE: No digits, numbers in the search select by list index which the brute force check ignores
+FILE_SCOPE const wchar_t *const QUERIES[] = {
+    L"firefox", L"meeting notes", L"code.exe", L"sett", L"review - slack", L"zzz",
+};
+
+// NOTE: Compares against the first snapshot, which is the full list from before typing started
+FILE_SCOPE bool BenchResultsAreValid(const WinjumpCore *const core, const BenchListView *const view,
+                                     const wchar_t *const search, const i32 searchLen)
+{
+	if (view->numRows != WinjumpCore_NumProgramsToDisplay(core)) return false;
+	if (core->programArraySnapshotStack.count == 0) return (core->programArray.count == 0);
+
+	const DqnArray<WinjumpProgram> *fullList = &core->programArraySnapshotStack.data[0];
+	i32 numExpected = 0;
+	for (i32 i = 0; i < (i32)fullList->count; i++)
+	{
+		const WinjumpProgram *program = &fullList->data[i];
+		if (DqnWStr_HasSubstring(program->friendlyName, program->friendlyNameLen, search, searchLen))
+			numExpected++;
+	}
+
+	bool result = (numExpected == WinjumpCore_NumProgramsToDisplay(core));
+	return result;
+}
+
+// Type each query a character at a time then delete it again.
+// speculate: Run the next character speculation between keystrokes, like the event loop when idle
+// return:    FALSE if the results were wrong or out of memory.
+FILE_SCOPE bool BenchTypeQueries(WinjumpCore *const core, WinjumpListView *const view,
+                                 const bool speculate, BenchTimings *const timings)
+{
+	BenchListView *benchView = (BenchListView *)view->userData;
+	for (i32 queryIndex = 0; queryIndex < DQN_ARRAY_COUNT(QUERIES); queryIndex++)
+	{
+		// NOTE: Enumerate right before typing so the first keystroke doesn't pay for a stale table
+		core->enumerateSchedule.windowsChanged = true;
+		if (!BenchUpdate(core, view, L"", 0, NULL)) return false;
+
+		const wchar_t *query = QUERIES[queryIndex];
+		i32 queryLen         = DqnWStr_Len(query);
+		for (i32 len = 1; len <= queryLen; len++)
+		{
+			if (!BenchUpdate(core, view, query, len, timings)) return false;
+			if (speculate) WinjumpCore_SpeculateNextChars(core);
+		}
+
+		if (!BenchResultsAreValid(core, benchView, query, queryLen)) return false;
+
+		for (i32 len = queryLen - 1; len >= 0; len--)
+		{
+			if (!BenchUpdate(core, view, query, len, timings)) return false;
+			if (len > 0 && !BenchResultsAreValid(core, benchView, query, len)) return false;
+		}
+	}
+
+	return true;
+}
+
+// Type part of an exe name whilst the exes are still resolving, then let them resolve. Windows that
+// only match on their exe have to appear once it arrives.
+// return: FALSE if the results were wrong or out of memory.
+FILE_SCOPE bool BenchTypeBeforeExeResolves(WinjumpCore *const core, WinjumpListView *const view,
+                                           BenchWindowSource *const benchSource)
+{
+	const wchar_t *const QUERY = L"spotify";
+	const i32 QUERY_LEN        = DqnWStr_Len(QUERY);
+
+	// NOTE: New windows for new processes so every exe goes through the job queue
+	DqnLock_Acquire(&benchSource->resolveLock);
+	BenchSourceResize(benchSource, 200);
+	for (i32 i = 0; i < (i32)benchSource->windows.count; i++)
+		benchSource->windows.data[i].pid += 1000000;
+
+	core->enumerateSchedule.windowsChanged = true;
+	bool result = BenchUpdate(core, view, L"", 0, NULL);
+	for (i32 len = 1; result && len <= QUERY_LEN; len++)
+		result = BenchUpdate(core, view, QUERY, len, NULL);
+	result &= (WinjumpCore_NumProgramsToDisplay(core) == 0);
+
+	DqnLock_Release(&benchSource->resolveLock);
+	DqnJobQueue_BlockAndCompleteAllJobs(&core->jobQueue);
+	result = result && BenchUpdate(core, view, QUERY, QUERY_LEN, NULL);
+	result = result && BenchResultsAreValid(core, (BenchListView *)view->userData, QUERY, QUERY_LEN);
+	result &= (WinjumpCore_NumProgramsToDisplay(core) > 0);
+
+	result = result && BenchUpdate(core, view, L"", 0, NULL);
+	return result;
+}
+
+int main(int argc, char *argv[])
+{
+	BenchWindowSource benchSource = {};
+	WinjumpWindowSource source    = {};
+	BenchListView benchView       = {};
+	WinjumpListView view          = {};
+	BenchViewInit(&benchView, &view);
+	if (!BenchSourceInit(&benchSource, &source, 0x5eed))
+	{
+		printf("BenchSourceInit() failed\n");
+		return 1;
+	}
+
+	LOCAL_PERSIST WinjumpCore core = {};
+	if (!WinjumpCore_Init(&core, &source))
+	{
+		printf("WinjumpCore_Init() failed\n");
+		return 1;
+	}
+
+	printf("Winjump Core Benchmark\n");
+	printf("Enumerations: %d per case, Churn: %d%% retitled, Queries: %d\n", NUM_ENUMERATIONS,
+	       CHURN_PERCENT, (i32)DQN_ARRAY_COUNT(QUERIES));
+
+	bool allValid           = true;
+	const i32 TABLE_SIZES[] = {100, 1000, 10000};
+	for (i32 sizeIndex = 0; sizeIndex < DQN_ARRAY_COUNT(TABLE_SIZES); sizeIndex++)
+	{
+		i32 numWindows = TABLE_SIZES[sizeIndex];
+		BenchSourceResize(&benchSource, numWindows);
+
+		// NOTE: Resolve every exe up front, afterwards only new processes go through the job queue
+		core.enumerateSchedule.windowsChanged = true;
+		bool valid = BenchUpdate(&core, &view, L"", 0, NULL);
+		DqnJobQueue_BlockAndCompleteAllJobs(&core.jobQueue);
+		valid &= BenchUpdate(&core, &view, L"", 0, NULL);
+
+		LOCAL_PERSIST BenchTimings stable, churn, typing, speculated;
+		stable = churn = typing = speculated = {};
+		for (i32 i = 0; valid && i < NUM_ENUMERATIONS; i++)
+		{
+			core.enumerateSchedule.windowsChanged = true;
+			valid &= BenchUpdate(&core, &view, L"", 0, &stable);
+		}
+
+		for (i32 i = 0; valid && i < NUM_ENUMERATIONS; i++)
+		{
+			BenchSourceChurn(&benchSource, CHURN_PERCENT);
+			core.enumerateSchedule.windowsChanged = true;
+			valid &= BenchUpdate(&core, &view, L"", 0, &churn);
+		}
+
+		valid &= BenchTypeQueries(&core, &view, false, &typing);
+
+		u32 startHits   = core.speculation.numHits;
+		u32 startMisses = core.speculation.numMisses;
+		valid &= BenchTypeQueries(&core, &view, true, &speculated);
+		u32 numHits     = core.speculation.numHits - startHits;
+		u32 numGuesses  = numHits + (core.speculation.numMisses - startMisses);
+
+		printf("\n%d windows                     p50      p99      max\n", numWindows);
+		BenchTimingsPrint("Enumerate, stable", &stable);
+		BenchTimingsPrint("Enumerate, churn", &churn);
+		BenchTimingsPrint("Keystroke", &typing);
+		BenchTimingsPrint("Keystroke, speculated", &speculated);
+		printf("  Speculation hits:      %d%%\n", (numGuesses > 0) ? (i32)((numHits * 100.0f) / numGuesses) : 0);
+		printf("  Results:               %s\n", valid ? "OK" : "MISMATCH");
+		allValid &= valid;
+	}
+
+	bool lateExeValid = BenchTypeBeforeExeResolves(&core, &view, &benchSource);
+	printf("\nExe resolved after typing: %s\n", lateExeValid ? "OK" : "MISMATCH");
+	allValid &= lateExeValid;
+
+	WinjumpCore_Free(&core);
+	DqnArray_Free(&benchSource.windows);
+	return allValid ? 0 : 1;
+}
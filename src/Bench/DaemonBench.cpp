@@ -0,0 +1,232 @@
+// Load test for the query daemon (see WinjumpDaemon.h). Concurrent clients each hold a connection
+// to the daemon and send queries back to back whilst the main thread churns a synthetic window
+// table and republishes it, like Winjump keeping the table warm underneath them. Reports the
+// queries per second served and the round trip latency of each query, then checks the daemon's
+// answers against filtering the same table with the core.
+//
+// Usage: winjump_daemon_bench [-clients N] [-windows N] [-seconds N]
+//   -clients Concurrent connections, default 8, at most DAEMON_BENCH_MAX_CLIENTS
+//   -windows Size of the window table, default 2000
+//   -seconds How long to run for, default 5
+#include "BenchCore.h"
+#include "../WinjumpDaemon.h"
+
+#if defined(_WIN32)
+	#define VC_EXTRALEAN 1
+	#define WIN32_LEAN_AND_MEAN 1
+	#include <Windows.h>
+	#define DAEMON_BENCH_ADDRESS "\\\\.\\pipe\\winjump_daemon_bench"
+#else
+	#include <unistd.h>
+	#define DAEMON_BENCH_ADDRESS "winjump_daemon_bench.sock"
+#endif
+
+#define DAEMON_BENCH_DEFAULT_CLIENTS     8
+#define DAEMON_BENCH_DEFAULT_WINDOWS     2000
+#define DAEMON_BENCH_DEFAULT_SECONDS     5
+#define DAEMON_BENCH_MAX_CLIENTS         16
+#define DAEMON_BENCH_PUBLISH_INTERVAL_MS 100 // The table churns and is republished this often
+
+// NOTE: The empty query matches the whole table, so responses span many chunks
+FILE_SCOPE const wchar_t *const DAEMON_BENCH_QUERIES[] = {
+    L"fire", L"inbox", L"code.exe", L"notes - outlook", L"zzz", L"12", L"re", L"",
+};
+
+typedef struct DaemonBenchShared
+{
+	bool volatile isRunning;
+	i32 volatile  numQueries;
+	i32 volatile  numFailed; // Clients that couldn't connect or lost their connection
+	i32 volatile  numSamples;
+	f32           samples[BENCH_MAX_SAMPLES]; // Round trip of each query, samples past the max are dropped
+} DaemonBenchShared;
+
+typedef struct DaemonBenchClient
+{
+	DaemonBenchShared *shared;
+	i32                index;
+} DaemonBenchClient;
+
+FILE_SCOPE void DaemonBenchSleepMs(const u32 ms)
+{
+#if defined(_WIN32)
+	Sleep(ms);
+#else
+	usleep(ms * 1000);
+#endif
+}
+
+// NOTE: Runs on a job queue thread for the whole benchmark, one job per client
+FILE_SCOPE void DaemonBenchClientJob(DqnJobQueue *const queue, void *const userData)
+{
+	DaemonBenchClient *bench  = (DaemonBenchClient *)userData;
+	DaemonBenchShared *shared = bench->shared;
+
+	WinjumpDaemonClient client = {};
+	if (!WinjumpDaemonClient_Connect(&client, DAEMON_BENCH_ADDRESS))
+	{
+		DqnAtomic_Add32(&shared->numFailed, 1);
+		return;
+	}
+
+	for (i32 queryIndex = bench->index; shared->isRunning; queryIndex++)
+	{
+		const wchar_t *query = DAEMON_BENCH_QUERIES[queryIndex % DQN_ARRAY_COUNT(DAEMON_BENCH_QUERIES)];
+		f64 startMs          = DqnTimer_NowInMs();
+		if (WinjumpDaemonClient_Query(&client, query, DqnWStr_Len(query), NULL, NULL) < 0)
+		{
+			DqnAtomic_Add32(&shared->numFailed, 1);
+			break;
+		}
+
+		f32 roundTripMs = (f32)(DqnTimer_NowInMs() - startMs);
+		i32 sample      = DqnAtomic_Add32(&shared->numSamples, 1) - 1;
+		if (sample < DQN_ARRAY_COUNT(shared->samples)) shared->samples[sample] = roundTripMs;
+		DqnAtomic_Add32(&shared->numQueries, 1);
+	}
+
+	WinjumpDaemonClient_Disconnect(&client);
+}
+
+// Churn the table and bring the core up to date with it, exes included.
+// return: FALSE if out of memory.
+FILE_SCOPE bool DaemonBenchChurn(BenchWindowSource *const bench, WinjumpCore *const core,
+                                 WinjumpListView *const view, const i32 percent)
+{
+	BenchSourceChurn(bench, percent);
+	core->enumerateSchedule.windowsChanged = true;
+	if (!BenchUpdate(core, view, L"", 0, NULL)) return false;
+	DqnJobQueue_BlockAndCompleteAllJobs(&core->jobQueue);
+	return BenchUpdate(core, view, L"", 0, NULL);
+}
+
+// Check each query's number of matches from the daemon against the core filtering the same table.
+// return: The number of queries that differ, -1 if the daemon couldn't be queried.
+FILE_SCOPE i32 DaemonBenchValidate(WinjumpCore *const core, WinjumpListView *const view)
+{
+	WinjumpDaemonClient client = {};
+	if (!WinjumpDaemonClient_Connect(&client, DAEMON_BENCH_ADDRESS)) return -1;
+
+	i32 result = 0;
+	for (i32 i = 0; i < DQN_ARRAY_COUNT(DAEMON_BENCH_QUERIES); i++)
+	{
+		const wchar_t *query = DAEMON_BENCH_QUERIES[i];
+		i32 queryLen         = DqnWStr_Len(query);
+		i32 numMatches       = WinjumpDaemonClient_Query(&client, query, queryLen, NULL, NULL);
+		if (numMatches < 0)
+		{
+			result = -1;
+			break;
+		}
+
+		if (!BenchUpdate(core, view, query, queryLen, NULL)) break;
+		i32 expected = WinjumpCore_NumProgramsToDisplay(core);
+		if (numMatches != expected)
+		{
+			printf("  \"%ls\": daemon matched %d, core matched %d\n", query, numMatches, expected);
+			result++;
+		}
+		BenchUpdate(core, view, L"", 0, NULL);
+	}
+
+	WinjumpDaemonClient_Disconnect(&client);
+	return result;
+}
+
+int main(int argc, char *argv[])
+{
+	i32 numClients = BenchArgToInt(argc, argv, "-clients", DAEMON_BENCH_DEFAULT_CLIENTS);
+	i32 numWindows = BenchArgToInt(argc, argv, "-windows", DAEMON_BENCH_DEFAULT_WINDOWS);
+	i32 numSeconds = BenchArgToInt(argc, argv, "-seconds", DAEMON_BENCH_DEFAULT_SECONDS);
+	numClients     = DQN_MIN(numClients, DAEMON_BENCH_MAX_CLIENTS);
+
+	BenchWindowSource benchSource = {};
+	WinjumpWindowSource source    = {};
+	BenchListView benchView       = {};
+	WinjumpListView view          = {};
+	BenchViewInit(&benchView, &view);
+	if (!BenchSourceInit(&benchSource, &source, 0xda3e))
+	{
+		printf("BenchSourceInit() failed\n");
+		return 1;
+	}
+	BenchSourceResize(&benchSource, numWindows);
+
+	LOCAL_PERSIST WinjumpCore core;
+	LOCAL_PERSIST WinjumpDaemon daemon;
+	if (!WinjumpCore_Init(&core, &source) || !DaemonBenchChurn(&benchSource, &core, &view, 0))
+	{
+		printf("WinjumpCore_Init() failed\n");
+		return 1;
+	}
+
+	if (!WinjumpDaemon_Start(&daemon, DAEMON_BENCH_ADDRESS) || !WinjumpDaemon_Publish(&daemon, &core))
+	{
+		printf("WinjumpDaemon_Start() failed: Could not listen on %s\n", DAEMON_BENCH_ADDRESS);
+		return 1;
+	}
+
+	printf("Winjump Daemon Bench\n");
+	printf("%d clients, %d windows, %ds, republished every %dms\n\n", numClients, numWindows, numSeconds,
+	       DAEMON_BENCH_PUBLISH_INTERVAL_MS);
+
+	LOCAL_PERSIST DaemonBenchShared shared;
+	LOCAL_PERSIST DaemonBenchClient clients[DAEMON_BENCH_MAX_CLIENTS];
+	LOCAL_PERSIST DqnJob jobList[DAEMON_BENCH_MAX_CLIENTS + 1];
+	DqnJobQueue queue = {};
+	shared.isRunning  = true;
+	if (!DqnJobQueue_Init(&queue, jobList, DQN_ARRAY_COUNT(jobList), numClients))
+	{
+		printf("DqnJobQueue_Init() failed\n");
+		return 1;
+	}
+
+	f64 startMs = DqnTimer_NowInMs();
+	for (i32 i = 0; i < numClients; i++)
+	{
+		clients[i].shared = &shared;
+		clients[i].index  = i;
+		DqnJob job        = {DaemonBenchClientJob, &clients[i]};
+		DqnJobQueue_AddJob(&queue, job);
+	}
+
+	bool result      = true;
+	i32 numPublishes = 0;
+	f64 endMs        = startMs + (numSeconds * 1000.0);
+	while (result && DqnTimer_NowInMs() < endMs)
+	{
+		DaemonBenchSleepMs(DAEMON_BENCH_PUBLISH_INTERVAL_MS);
+		result = DaemonBenchChurn(&benchSource, &core, &view, 1) && WinjumpDaemon_Publish(&daemon, &core);
+		numPublishes++;
+	}
+
+	shared.isRunning = false;
+	DqnJobQueue_BlockAndCompleteAllJobs(&queue);
+	f64 elapsedS = (DqnTimer_NowInMs() - startMs) / 1000.0;
+	if (!result)
+	{
+		printf("Out of memory\n");
+		return 1;
+	}
+
+	i32 numSamples = DQN_MIN(shared.numSamples, (i32)DQN_ARRAY_COUNT(shared.samples));
+	if (numSamples > 0)
+	{
+		Dqn_QuickSort(shared.samples, numSamples, BenchF32IsLessThan);
+		printf("                              p50      p99      max\n");
+		printf("  Query round trip     %8.3f %8.3f %8.3f ms\n", shared.samples[(i32)((numSamples - 1) * 0.50f)],
+		       shared.samples[(i32)((numSamples - 1) * 0.99f)], shared.samples[numSamples - 1]);
+	}
+
+	printf("  Queries:             %d, %.0f/s\n", shared.numQueries, shared.numQueries / elapsedS);
+	printf("  Publishes:           %d\n", numPublishes);
+	printf("  Failed clients:      %d\n", shared.numFailed);
+
+	i32 numMismatches = DaemonBenchValidate(&core, &view);
+	printf("  Mismatched queries:  %d\n", numMismatches);
+
+	WinjumpDaemon_Stop(&daemon);
+	WinjumpCore_Free(&core);
+	DqnArray_Free(&benchSource.windows);
+	return (shared.numFailed > 0 || numMismatches != 0) ? 1 : 0;
+}
@@ -0,0 +1,193 @@
+// Benchmark for DqnHashMap against std::unordered_map. Inserts HASH_MAP_BENCH_NUM_KEYS random
+// u64 keys into an empty map and into one reserved up front, looks every key up in a random order,
+// looks up as many keys that aren't in the map, then removes them all. Reports the best of
+// HASH_MAP_BENCH_NUM_RUNS runs of each in millions of operations per second and checks both maps
+// agree on every lookup.
+#include "Bench.h"
+
+#include <unordered_map>
+
+#define HASH_MAP_BENCH_NUM_KEYS 1000000
+#define HASH_MAP_BENCH_NUM_RUNS 3
+
+enum BenchOp
+{
+	BenchOp_Insert,
+	BenchOp_InsertReserved,
+	BenchOp_LookupHit,
+	BenchOp_LookupMiss,
+	BenchOp_Remove,
+	BenchOp_Count,
+};
+
+FILE_SCOPE const char *const BENCH_OP_NAMES[BenchOp_Count] = {
+    "Insert", "Insert, reserved", "Lookup, hit", "Lookup, miss", "Remove",
+};
+
+struct BenchResult
+{
+	BenchTimer timers[BenchOp_Count];
+	u64        checksum; // Sum of the values found by the lookups, must match between the maps
+};
+
+FILE_SCOPE u64 *globalKeys;
+FILE_SCOPE u64 *globalMissingKeys;
+FILE_SCOPE u32 *globalLookupOrder; // Shuffled, so lookups don't walk memory in insertion order
+
+FILE_SCOPE BenchResult BenchDqnHashMap()
+{
+	BenchResult result = {};
+	for (u32 run = 0; run < HASH_MAP_BENCH_NUM_RUNS; run++)
+	{
+		DqnHashMap<u64, u64> map = {};
+		BenchTimer_Start(&result.timers[BenchOp_Insert]);
+		for (u32 i = 0; i < HASH_MAP_BENCH_NUM_KEYS; i++) DqnHashMap_Set(&map, globalKeys[i], (u64)i);
+		BenchTimer_Stop(&result.timers[BenchOp_Insert]);
+		DqnHashMap_Free(&map);
+
+		BenchTimer_Start(&result.timers[BenchOp_InsertReserved]);
+		DqnHashMap_Reserve(&map, HASH_MAP_BENCH_NUM_KEYS);
+		for (u32 i = 0; i < HASH_MAP_BENCH_NUM_KEYS; i++) DqnHashMap_Set(&map, globalKeys[i], (u64)i);
+		BenchTimer_Stop(&result.timers[BenchOp_InsertReserved]);
+
+		u64 checksum = 0;
+		BenchTimer_Start(&result.timers[BenchOp_LookupHit]);
+		for (u32 i = 0; i < HASH_MAP_BENCH_NUM_KEYS; i++)
+		{
+			u64 *value = DqnHashMap_Get(&map, globalKeys[globalLookupOrder[i]]);
+			if (value) checksum += *value;
+		}
+		BenchTimer_Stop(&result.timers[BenchOp_LookupHit]);
+
+		BenchTimer_Start(&result.timers[BenchOp_LookupMiss]);
+		for (u32 i = 0; i < HASH_MAP_BENCH_NUM_KEYS; i++)
+		{
+			u64 *value = DqnHashMap_Get(&map, globalMissingKeys[globalLookupOrder[i]]);
+			if (value) checksum += *value;
+		}
+		BenchTimer_Stop(&result.timers[BenchOp_LookupMiss]);
+
+		BenchTimer_Start(&result.timers[BenchOp_Remove]);
+		for (u32 i = 0; i < HASH_MAP_BENCH_NUM_KEYS; i++) checksum += DqnHashMap_Remove(&map, globalKeys[globalLookupOrder[i]]);
+		BenchTimer_Stop(&result.timers[BenchOp_Remove]);
+
+		result.checksum = checksum + map.count;
+		DqnHashMap_Free(&map);
+		for (i32 op = 0; op < BenchOp_Count; op++) BenchTimer_EndRun(&result.timers[op]);
+	}
+
+	return result;
+}
+
+FILE_SCOPE BenchResult BenchUnorderedMap()
+{
+	BenchResult result = {};
+	for (u32 run = 0; run < HASH_MAP_BENCH_NUM_RUNS; run++)
+	{
+		{
+			std::unordered_map<u64, u64> map;
+			BenchTimer_Start(&result.timers[BenchOp_Insert]);
+			for (u32 i = 0; i < HASH_MAP_BENCH_NUM_KEYS; i++) map[globalKeys[i]] = (u64)i;
+			BenchTimer_Stop(&result.timers[BenchOp_Insert]);
+		}
+
+		std::unordered_map<u64, u64> map;
+		BenchTimer_Start(&result.timers[BenchOp_InsertReserved]);
+		map.reserve(HASH_MAP_BENCH_NUM_KEYS);
+		for (u32 i = 0; i < HASH_MAP_BENCH_NUM_KEYS; i++) map[globalKeys[i]] = (u64)i;
+		BenchTimer_Stop(&result.timers[BenchOp_InsertReserved]);
+
+		u64 checksum = 0;
+		BenchTimer_Start(&result.timers[BenchOp_LookupHit]);
+		for (u32 i = 0; i < HASH_MAP_BENCH_NUM_KEYS; i++)
+		{
+			std::unordered_map<u64, u64>::iterator it = map.find(globalKeys[globalLookupOrder[i]]);
+			if (it != map.end()) checksum += it->second;
+		}
+		BenchTimer_Stop(&result.timers[BenchOp_LookupHit]);
+
+		BenchTimer_Start(&result.timers[BenchOp_LookupMiss]);
+		for (u32 i = 0; i < HASH_MAP_BENCH_NUM_KEYS; i++)
+		{
+			std::unordered_map<u64, u64>::iterator it = map.find(globalMissingKeys[globalLookupOrder[i]]);
+			if (it != map.end()) checksum += it->second;
+		}
+		BenchTimer_Stop(&result.timers[BenchOp_LookupMiss]);
+
+		BenchTimer_Start(&result.timers[BenchOp_Remove]);
+		for (u32 i = 0; i < HASH_MAP_BENCH_NUM_KEYS; i++) checksum += map.erase(globalKeys[globalLookupOrder[i]]);
+		BenchTimer_Stop(&result.timers[BenchOp_Remove]);
+
+		result.checksum = checksum + map.size();
+		for (i32 op = 0; op < BenchOp_Count; op++) BenchTimer_EndRun(&result.timers[op]);
+	}
+
+	return result;
+}
+
+// return: FALSE if overwriting a key in a map at its load limit grew the map or lost the value.
+FILE_SCOPE bool BenchValidateOverwrite()
+{
+	DqnHashMap<u64, u64> map = {};
+	if (!DqnHashMap_Init(&map, 64)) return false;
+
+	// NOTE: The map is full once it's 7/8ths full, the next new key grows it
+	u64 capacity = map.capacity;
+	for (u64 i = 0; i < capacity - (capacity / 8); i++) DqnHashMap_Set(&map, globalKeys[i], i);
+
+	u64 *value  = DqnHashMap_Set(&map, globalKeys[0], (u64)100);
+	bool result = (value && *value == 100 && map.capacity == capacity);
+	DqnHashMap_Free(&map);
+	return result;
+}
+
+int main(int argc, char *argv[])
+{
+	// NOTE: The index in the high bits keeps keys unique and the low bits random. Missing keys are
+	// the same keys with the top bit set, which no index reaches, so they're never in the map
+	globalKeys        = (u64 *)DqnMem_Alloc(HASH_MAP_BENCH_NUM_KEYS * sizeof(u64));
+	globalMissingKeys = (u64 *)DqnMem_Alloc(HASH_MAP_BENCH_NUM_KEYS * sizeof(u64));
+	globalLookupOrder = (u32 *)DqnMem_Alloc(HASH_MAP_BENCH_NUM_KEYS * sizeof(u32));
+	DqnRandPCGState rnd = {};
+	DqnRnd_PCGInitWithSeed(&rnd, 0x4a54);
+	for (u32 i = 0; i < HASH_MAP_BENCH_NUM_KEYS; i++)
+	{
+		globalKeys[i]        = ((u64)i << 32) | DqnRnd_PCGNext(&rnd);
+		globalMissingKeys[i] = globalKeys[i] | (1ULL << 63);
+		globalLookupOrder[i] = i;
+	}
+
+	for (u32 i = HASH_MAP_BENCH_NUM_KEYS - 1; i > 0; i--)
+		DQN_SWAP(u32, globalLookupOrder[i], globalLookupOrder[DqnRnd_PCGRange(&rnd, 0, (i32)i)]);
+
+	printf("DqnHashMap Benchmark\n");
+	printf("Keys: %d random u64, Group probe: %s, Best of %d runs\n\n", HASH_MAP_BENCH_NUM_KEYS,
+#if defined(DQN_HASH_MAP_SSE2)
+	       "SSE2",
+#else
+	       "Scalar",
+#endif
+	       HASH_MAP_BENCH_NUM_RUNS);
+
+	BenchResult dqnResult = BenchDqnHashMap();
+	BenchResult stdResult = BenchUnorderedMap();
+
+	for (i32 op = 0; op < BenchOp_Count; op++)
+	{
+		BenchTable table = {};
+		table.nameWidth  = 14;
+		table.numOps     = HASH_MAP_BENCH_NUM_KEYS;
+		table.opsName    = "ops";
+
+		printf("%s\n", BENCH_OP_NAMES[op]);
+		BenchTable_Header(&table, NULL);
+		BenchTable_Row(&table, "unordered_map", stdResult.timers[op].bestMs); printf("\n");
+		BenchTable_Row(&table, "DqnHashMap",    dqnResult.timers[op].bestMs); printf("\n");
+		printf("\n");
+	}
+
+	BenchChecks checks = {};
+	BenchChecks_Add(&checks, "Lookups agree with unordered_map", dqnResult.checksum == stdResult.checksum);
+	BenchChecks_Add(&checks, "Overwriting at the load limit", BenchValidateOverwrite());
+	return BenchChecks_Report(&checks, "Results");
+}
@@ -0,0 +1,271 @@
+// Benchmark for DqnJobGraph on a synthetic 10,000 node graph. Each node depends on up to
+// MAX_DEPENDENCIES random earlier nodes so the graph is acyclic with a mix of wide and deep
+// sections. Reports the serial time, the graph time on the job queue and the per node overhead of
+// the graph with empty jobs, then checks every node ran after its dependencies. Also checks the
+// DqnTimerWheel fires one shot, periodic and far off tasks on time on a simulated clock.
+#define DQN_IMPLEMENTATION
+#define DQN_PLATFORM_HEADER
+#if defined(_WIN32)
+	#define DQN_WIN32_IMPLEMENTATION
+#else
+	#define DQN_UNIX_IMPLEMENTATION
+#endif
+#include "../dqn.h"
+
+#include <stdio.h>
+
+#define NUM_NODES        10000
+#define MAX_DEPENDENCIES 4
+#define NUM_RUNS         5
+
+typedef struct BenchNode
+{
+	u32 numWorkIterations;
+	u32 dependencies[MAX_DEPENDENCIES];
+	u32 numDependencies;
+
+	i32 volatile completionOrder;
+	u32 result;
+} BenchNode;
+
+FILE_SCOPE BenchNode    globalNodes[NUM_NODES];
+FILE_SCOPE i32 volatile globalCompletionCounter;
+FILE_SCOPE bool         globalDoWork;
+
+// NOTE: A few microseconds of integer work, roughly the cost of a small pipeline stage
+FILE_SCOPE void BenchNodeCallback(DqnJobQueue *const queue, void *const userData)
+{
+	BenchNode *node = (BenchNode *)userData;
+	if (globalDoWork)
+	{
+		u32 hash = (u32)(node - globalNodes) + 1;
+		for (u32 i = 0; i < node->numWorkIterations; i++)
+			hash = (hash ^ (hash >> 15)) * 0x2c1b3c6d + i;
+		node->result = hash;
+	}
+
+	node->completionOrder = DqnAtomic_Add32(&globalCompletionCounter, 1);
+}
+
+FILE_SCOPE bool BenchValidateOrder()
+{
+	for (u32 i = 0; i < NUM_NODES; i++)
+	{
+		BenchNode *node = &globalNodes[i];
+		if (node->completionOrder == 0) return false;
+		for (u32 j = 0; j < node->numDependencies; j++)
+		{
+			if (globalNodes[node->dependencies[j]].completionOrder >= node->completionOrder)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+FILE_SCOPE void BenchResetNodes()
+{
+	globalCompletionCounter = 0;
+	for (u32 i = 0; i < NUM_NODES; i++) globalNodes[i].completionOrder = 0;
+}
+
+// return: The best time in milliseconds over NUM_RUNS.
+FILE_SCOPE f64 BenchRunGraph(DqnJobGraph *const graph, bool *const valid)
+{
+	f64 bestMs = 0;
+	*valid     = true;
+	for (u32 run = 0; run < NUM_RUNS; run++)
+	{
+		BenchResetNodes();
+		f64 startMs = DqnTimer_NowInMs();
+		bool ran    = DqnJobGraph_Run(graph);
+		f64 timeMs  = DqnTimer_NowInMs() - startMs;
+
+		if (!ran || !BenchValidateOrder()) *valid = false;
+		if (run == 0 || timeMs < bestMs) bestMs = timeMs;
+	}
+
+	return bestMs;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Timer Wheel
+////////////////////////////////////////////////////////////////////////////////
+#define TIMER_WHEEL_TICK_MS 10.0
+#define TIMER_WHEEL_STEP_MS 7.0 // Advance by less than a tick and not a multiple of it
+
+typedef struct BenchTimerTask
+{
+	DqnTimerWheelTask task;
+	f64               dueMs;
+	u32               numFired;
+	bool              firedEarly;
+	bool              firedLate;
+} BenchTimerTask;
+
+FILE_SCOPE void BenchTimerTaskCallback(DqnTimerWheelTask *const task, const f64 nowInMs)
+{
+	BenchTimerTask *timer = (BenchTimerTask *)task->userData;
+	timer->numFired++;
+	timer->firedEarly |= (nowInMs < timer->dueMs);
+	timer->firedLate  |= (nowInMs >= timer->dueMs + TIMER_WHEEL_TICK_MS + TIMER_WHEEL_STEP_MS);
+	timer->dueMs      += task->periodInMs; // NOTE: Periodic tasks keep their rate rather than drift
+}
+
+FILE_SCOPE void BenchTimerSchedule(DqnTimerWheel *const wheel, BenchTimerTask *const timer,
+                                   const f64 nowInMs, const f64 delayInMs, const f64 periodInMs)
+{
+	*timer                 = {};
+	timer->task.callback   = BenchTimerTaskCallback;
+	timer->task.userData   = timer;
+	timer->task.periodInMs = periodInMs;
+	timer->dueMs           = nowInMs + delayInMs;
+	DqnTimerWheel_Schedule(wheel, &timer->task, delayInMs);
+}
+
+// NOTE: Drives the wheel with a simulated clock the way the event loop does, sleeping until the
+// next task is due or stepping in small increments, then advancing before scheduling.
+// return: FALSE if a task fired early, late, the wrong number of times or after it was cancelled.
+FILE_SCOPE bool BenchValidateTimerWheel()
+{
+	DqnTimerWheel wheel = {};
+	DqnTimerWheel_Init(&wheel, TIMER_WHEEL_TICK_MS, 0);
+
+	// NOTE: Idle for 5s, then schedule a 2s flush once awake
+	f64 nowMs = 5000;
+	DqnTimerWheel_Advance(&wheel, nowMs);
+
+	BenchTimerTask flush, periodic, far, cancelled;
+	BenchTimerSchedule(&wheel, &flush,     nowMs, 2000, 0);
+	BenchTimerSchedule(&wheel, &periodic,  nowMs, 0,    1000);
+	BenchTimerSchedule(&wheel, &cancelled, nowMs, 3000, 0);
+
+	// NOTE: Far enough to start in the overflow list and cascade through every level
+	const f64 FAR_DELAY_MS = TIMER_WHEEL_TICK_MS * (f64)(1ULL << DQN_TIMER_WHEEL_RANGE_BITS) * 1.5;
+	BenchTimerSchedule(&wheel, &far, nowMs, FAR_DELAY_MS, 0);
+
+	bool result = (DqnTimerWheel_MsUntilNextDue(&wheel, nowMs) == TIMER_WHEEL_TICK_MS);
+	DqnTimerWheel_Cancel(&wheel, &periodic.task);
+	result &= (DqnTimerWheel_MsUntilNextDue(&wheel, nowMs) == 2000);
+	DqnTimerWheel_Schedule(&wheel, &periodic.task, 0);
+
+	const f64 END_MS = nowMs + 20000;
+	for (; nowMs < END_MS; nowMs += TIMER_WHEEL_STEP_MS)
+	{
+		DqnTimerWheel_Advance(&wheel, nowMs);
+		if (nowMs >= 6000 && DqnTimerWheel_IsScheduled(&cancelled.task))
+			DqnTimerWheel_Cancel(&wheel, &cancelled.task);
+	}
+
+	result &= (flush.numFired == 1 && !flush.firedEarly && !flush.firedLate);
+	result &= (periodic.numFired >= 19 && periodic.numFired <= 21);
+	result &= (!periodic.firedEarly && !periodic.firedLate);
+	result &= (cancelled.numFired == 0 && far.numFired == 0);
+
+	// NOTE: Sleep between due times like the event loop so the far task is reached in a few jumps
+	DqnTimerWheel_Cancel(&wheel, &periodic.task);
+	for (u32 i = 0; i < 16 && far.numFired == 0; i++)
+	{
+		f64 msUntilNextDue = DqnTimerWheel_MsUntilNextDue(&wheel, nowMs);
+		if (msUntilNextDue == DQN_TIMER_WHEEL_NO_TASKS) break;
+		nowMs += msUntilNextDue;
+		DqnTimerWheel_Advance(&wheel, nowMs);
+	}
+
+	result &= (far.numFired == 1 && !far.firedEarly && !far.firedLate && wheel.numTasks == 0);
+	return result;
+}
+
+// NOTE: Nodes only depend on earlier nodes, so index order is a valid topological order
+FILE_SCOPE f64 BenchRunSerial()
+{
+	f64 bestMs = 0;
+	for (u32 run = 0; run < NUM_RUNS; run++)
+	{
+		BenchResetNodes();
+		f64 startMs = DqnTimer_NowInMs();
+		for (u32 i = 0; i < NUM_NODES; i++) BenchNodeCallback(NULL, &globalNodes[i]);
+		f64 timeMs = DqnTimer_NowInMs() - startMs;
+		if (run == 0 || timeMs < bestMs) bestMs = timeMs;
+	}
+
+	return bestMs;
+}
+
+int main(int argc, char *argv[])
+{
+	u32 numCores = 0, numThreadsPerCore = 0;
+	DqnPlatform_GetNumThreadsAndCores(&numCores, &numThreadsPerCore);
+	u32 numThreads = DQN_MAX(numCores * numThreadsPerCore, 2) - 1; // NOTE: The main thread helps
+
+	LOCAL_PERSIST DqnJob jobList[NUM_NODES + 1];
+	DqnJobQueue queue = {};
+	if (!DqnJobQueue_Init(&queue, jobList, DQN_ARRAY_COUNT(jobList), numThreads))
+	{
+		printf("DqnJobQueue_Init() failed\n");
+		return 1;
+	}
+
+	LOCAL_PERSIST DqnJobGraphNode graphNodes[NUM_NODES];
+	LOCAL_PERSIST DqnJobGraphEdge graphEdges[NUM_NODES * MAX_DEPENDENCIES];
+	DqnJobGraph graph = {};
+	DqnJobGraph_Init(&graph, &queue, graphNodes, DQN_ARRAY_COUNT(graphNodes), graphEdges,
+	                 DQN_ARRAY_COUNT(graphEdges));
+
+	DqnRandPCGState rnd = {};
+	DqnRnd_PCGInitWithSeed(&rnd, 0x5eed);
+
+	u32 numEdges = 0;
+	for (u32 i = 0; i < NUM_NODES; i++)
+	{
+		BenchNode *node         = &globalNodes[i];
+		node->numWorkIterations = (u32)DqnRnd_PCGRange(&rnd, 500, 2000);
+
+		u32 nodeIndex = DqnJobGraph_AddNode(&graph, BenchNodeCallback, node);
+		DQN_ASSERT(nodeIndex == i);
+		if (i == 0) continue;
+
+		// NOTE: Mostly depend on recent nodes to make chains, occasionally reach far back
+		u32 numDependencies = (u32)DqnRnd_PCGRange(&rnd, 0, MAX_DEPENDENCIES);
+		for (u32 j = 0; j < numDependencies; j++)
+		{
+			i32 window = (DqnRnd_PCGRange(&rnd, 0, 9) == 0) ? (i32)i : DQN_MIN((i32)i, 64);
+			u32 dependsOn = i - (u32)DqnRnd_PCGRange(&rnd, 1, window);
+
+			bool duplicate = false;
+			for (u32 k = 0; k < node->numDependencies; k++)
+				duplicate |= (node->dependencies[k] == dependsOn);
+			if (duplicate) continue;
+
+			node->dependencies[node->numDependencies++] = dependsOn;
+			DQN_ASSERT(DqnJobGraph_AddDependency(&graph, i, dependsOn));
+			numEdges++;
+		}
+	}
+
+	printf("DqnJobGraph Benchmark\n");
+	printf("Nodes: %d, Edges: %d, Worker Threads: %d (+ main thread), Best of %d runs\n\n",
+	       NUM_NODES, numEdges, numThreads, NUM_RUNS);
+
+	bool allValid = true;
+	bool valid;
+
+	globalDoWork   = true;
+	f64 serialMs   = BenchRunSerial();
+	f64 graphMs    = BenchRunGraph(&graph, &valid);
+	allValid      &= valid;
+
+	globalDoWork   = false;
+	f64 emptyMs    = BenchRunGraph(&graph, &valid);
+	allValid      &= valid;
+
+	printf("Serial:             %8.3f ms\n", serialMs);
+	printf("Graph:              %8.3f ms (%.2fx)\n", graphMs, serialMs / graphMs);
+	printf("Graph, empty jobs:  %8.3f ms (%.3f us/node overhead)\n", emptyMs,
+	       (emptyMs * 1000.0) / NUM_NODES);
+	printf("Dependency order:   %s\n", allValid ? "OK" : "VIOLATED");
+
+	bool wheelValid = BenchValidateTimerWheel();
+	printf("Timer wheel:        %s\n", wheelValid ? "OK" : "INVALID");
+	return (allValid && wheelValid) ? 0 : 1;
+}
@@ -0,0 +1,286 @@
+// Benchmark for DqnMemPool against calloc per object. Keeps a random set of fixed size objects alive,
+// like windows coming and going, by repeatedly freeing or allocating a random slot, then frees them
+// all. Runs it with calloc/free, a DqnMemPool and a DqnMemPoolThreadCache over a pool, reporting the
+// throughput and how many bytes each holds per byte of live objects at the end of the churn. Then
+// runs the churn on every worker of a job queue sharing one pool through thread caches, checking no
+// object is ever handed to two slots at once.
+#include "Bench.h"
+
+#include <stdlib.h>
+
+// NOTE: glibc can report the heap held by calloc, elsewhere only the pool's overhead is known
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+	#include <malloc.h>
+	#define MEM_POOL_BENCH_HAS_MALLINFO 1
+#endif
+
+#define MEM_POOL_BENCH_NUM_SLOTS      100000
+#define MEM_POOL_BENCH_NUM_OPS        4000000
+#define MEM_POOL_BENCH_NUM_RUNS       5
+#define MEM_POOL_BENCH_ITEMS_PER_SLAB 1024
+#define MEM_POOL_BENCH_NUM_JOBS       8
+#define MEM_POOL_BENCH_JOB_SLOTS      10000
+#define MEM_POOL_BENCH_JOB_OPS        500000
+
+// NOTE: Roughly a list node or job record, 32 bytes which calloc rounds up to a 48 byte chunk
+typedef struct BenchObject
+{
+	u64 window;
+	u32 pid;
+	u32 slot;
+	u64 next;
+	u64 prev;
+} BenchObject;
+
+enum BenchMode
+{
+	BenchMode_Calloc,
+	BenchMode_Pool,
+	BenchMode_ThreadCache,
+	BenchMode_Count,
+};
+
+FILE_SCOPE const char *const BENCH_MODE_NAMES[BenchMode_Count] = {
+    "calloc/free", "DqnMemPool", "Thread cache",
+};
+
+struct BenchAllocator
+{
+	BenchMode             mode;
+	DqnMemPool           *pool;
+	DqnMemPoolThreadCache cache;
+};
+
+FILE_SCOPE inline BenchObject *BenchAlloc(BenchAllocator *const allocator)
+{
+	switch (allocator->mode)
+	{
+		case BenchMode_Calloc:      return (BenchObject *)DqnMem_Calloc(sizeof(BenchObject));
+		case BenchMode_Pool:        return (BenchObject *)DqnMemPool_Alloc(allocator->pool);
+		case BenchMode_ThreadCache: return (BenchObject *)DqnMemPoolThreadCache_Alloc(&allocator->cache);
+		default:                    return NULL;
+	}
+}
+
+FILE_SCOPE inline void BenchFree(BenchAllocator *const allocator, BenchObject *const object)
+{
+	switch (allocator->mode)
+	{
+		case BenchMode_Calloc:      DqnMem_Free(object);                                    break;
+		case BenchMode_Pool:        DqnMemPool_FreeItem(allocator->pool, object);           break;
+		case BenchMode_ThreadCache: DqnMemPoolThreadCache_FreeItem(&allocator->cache, object); break;
+		default:                    break;
+	}
+}
+
+// Fill half the slots, then free or allocate a random slot numOps times.
+// return: FALSE if an object was changed whilst it was alive, i.e. handed out twice.
+FILE_SCOPE bool BenchChurn(BenchAllocator *const allocator, BenchObject **const slots, const u32 numSlots,
+                           const u32 numOps, const u32 seed)
+{
+	DqnRandPCGState rnd = {};
+	DqnRnd_PCGInitWithSeed(&rnd, seed);
+
+	bool result = true;
+	for (u32 i = 0; i < numSlots; i += 2)
+	{
+		slots[i]       = BenchAlloc(allocator);
+		slots[i]->slot = i;
+	}
+
+	for (u32 op = 0; op < numOps; op++)
+	{
+		u32 i = DqnRnd_PCGNext(&rnd) % numSlots;
+		if (slots[i])
+		{
+			result &= (slots[i]->slot == i);
+			BenchFree(allocator, slots[i]);
+			slots[i] = NULL;
+		}
+		else
+		{
+			slots[i]       = BenchAlloc(allocator);
+			slots[i]->slot = i;
+		}
+	}
+
+	return result;
+}
+
+FILE_SCOPE u32 BenchFreeAll(BenchAllocator *const allocator, BenchObject **const slots, const u32 numSlots)
+{
+	u32 result = 0;
+	for (u32 i = 0; i < numSlots; i++)
+	{
+		if (!slots[i]) continue;
+		BenchFree(allocator, slots[i]);
+		slots[i] = NULL;
+		result++;
+	}
+
+	return result;
+}
+
+FILE_SCOPE size_t BenchHeapBytes()
+{
+#if defined(MEM_POOL_BENCH_HAS_MALLINFO)
+	struct mallinfo2 info = mallinfo2();
+	return info.arena + info.hblkhd;
+#else
+	return 0;
+#endif
+}
+
+struct BenchResult
+{
+	BenchTimer timer;
+	f64        bytesPerLiveByte; // 0 if unknown
+};
+
+FILE_SCOPE BenchResult BenchRun(const BenchMode mode, BenchChecks *const checks)
+{
+	LOCAL_PERSIST BenchObject *slots[MEM_POOL_BENCH_NUM_SLOTS];
+
+	DqnLock lock = {};
+	DQN_ASSERT_HARD(DqnLock_Init(&lock));
+
+	// NOTE: The heap keeps what it grew by between runs, so measure it against before the first
+	size_t heapStart   = BenchHeapBytes();
+	BenchResult result = {};
+	bool valid         = true;
+	for (u32 run = 0; run < MEM_POOL_BENCH_NUM_RUNS; run++)
+	{
+		DqnMemPool pool = {};
+		DQN_ASSERT_HARD(DqnMemPool_Init(&pool, sizeof(BenchObject), MEM_POOL_BENCH_ITEMS_PER_SLAB));
+
+		BenchAllocator allocator = {};
+		allocator.mode           = mode;
+		allocator.pool           = &pool;
+		DqnMemPoolThreadCache_Init(&allocator.cache, &pool, &lock);
+
+		BenchTimer_Start(&result.timer);
+		valid &= BenchChurn(&allocator, slots, MEM_POOL_BENCH_NUM_SLOTS, MEM_POOL_BENCH_NUM_OPS, 0x9001);
+		BenchTimer_Stop(&result.timer);
+
+		// NOTE: Measure what each allocator holds whilst the churned set is still alive
+		u32 numLive = 0;
+		for (u32 i = 0; i < MEM_POOL_BENCH_NUM_SLOTS; i++) numLive += (slots[i] != NULL);
+
+		size_t heldBytes = (mode == BenchMode_Calloc) ? BenchHeapBytes() - heapStart
+		                                              : pool.numSlabs * (size_t)MEM_POOL_BENCH_ITEMS_PER_SLAB * pool.itemSize;
+		result.bytesPerLiveByte = (heldBytes == 0) ? 0 : (f64)heldBytes / ((f64)numLive * sizeof(BenchObject));
+
+		BenchTimer_Start(&result.timer);
+		u32 numFreed = BenchFreeAll(&allocator, slots, MEM_POOL_BENCH_NUM_SLOTS);
+		DqnMemPoolThreadCache_Flush(&allocator.cache);
+		BenchTimer_Stop(&result.timer);
+		BenchTimer_EndRun(&result.timer);
+
+		valid &= (numFreed == numLive && pool.numItemsInUse == 0);
+		DqnMemPool_Free(&pool);
+	}
+
+	BenchChecks_Add(checks, BENCH_MODE_NAMES[mode], valid);
+	DqnLock_Delete(&lock);
+	return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Shared Pool
+////////////////////////////////////////////////////////////////////////////////
+struct BenchJob
+{
+	BenchAllocator allocator;
+	BenchObject   *slots[MEM_POOL_BENCH_JOB_SLOTS];
+	u32            seed;
+	bool           valid;
+};
+
+FILE_SCOPE void BenchJobCallback(DqnJobQueue *const queue, void *const userData)
+{
+	BenchJob *job = (BenchJob *)userData;
+	job->valid    = BenchChurn(&job->allocator, job->slots, MEM_POOL_BENCH_JOB_SLOTS, MEM_POOL_BENCH_JOB_OPS, job->seed);
+	BenchFreeAll(&job->allocator, job->slots, MEM_POOL_BENCH_JOB_SLOTS);
+	if (job->allocator.mode == BenchMode_ThreadCache) DqnMemPoolThreadCache_Flush(&job->allocator.cache);
+}
+
+FILE_SCOPE f64 BenchRunShared(DqnJobQueue *const queue, const BenchMode mode, BenchChecks *const checks)
+{
+	LOCAL_PERSIST BenchJob jobs[MEM_POOL_BENCH_NUM_JOBS];
+
+	DqnLock lock = {};
+	DQN_ASSERT_HARD(DqnLock_Init(&lock));
+	DqnMemPool pool = {};
+	DQN_ASSERT_HARD(DqnMemPool_Init(&pool, sizeof(BenchObject), MEM_POOL_BENCH_ITEMS_PER_SLAB));
+
+	BenchTimer timer = {};
+	BenchTimer_Start(&timer);
+	for (u32 i = 0; i < MEM_POOL_BENCH_NUM_JOBS; i++)
+	{
+		BenchJob *job       = &jobs[i];
+		job->allocator      = {};
+		job->allocator.mode = mode;
+		job->allocator.pool = &pool;
+		job->seed           = 0x1000 + i;
+		DqnMemPoolThreadCache_Init(&job->allocator.cache, &pool, &lock);
+
+		DqnJob queueJob   = {};
+		queueJob.callback = BenchJobCallback;
+		queueJob.userData = job;
+		DQN_ASSERT_HARD(DqnJobQueue_AddJob(queue, queueJob));
+	}
+	DqnJobQueue_BlockAndCompleteAllJobs(queue);
+	BenchTimer_Stop(&timer);
+	f64 result = BenchTimer_EndRun(&timer);
+
+	bool valid = (pool.numItemsInUse == 0);
+	for (u32 i = 0; i < MEM_POOL_BENCH_NUM_JOBS; i++) valid &= jobs[i].valid;
+	BenchChecks_Add(checks, "Shared pool", valid);
+
+	DqnMemPool_Free(&pool);
+	DqnLock_Delete(&lock);
+	return result;
+}
+
+int main(int argc, char *argv[])
+{
+	printf("DqnMemPool Benchmark\n");
+	printf("Objects: %d byte, Slots: %d, Ops: %d, Items per slab: %d, Best of %d runs\n\n",
+	       (i32)sizeof(BenchObject), MEM_POOL_BENCH_NUM_SLOTS, MEM_POOL_BENCH_NUM_OPS,
+	       MEM_POOL_BENCH_ITEMS_PER_SLAB, MEM_POOL_BENCH_NUM_RUNS);
+
+	BenchChecks checks = {};
+	BenchTable table   = {};
+	table.nameWidth    = 14;
+	table.numOps       = MEM_POOL_BENCH_NUM_OPS;
+	table.opsName      = "ops";
+
+	BenchTable_Header(&table, "Bytes held per live byte");
+	for (i32 mode = 0; mode < BenchMode_Count; mode++)
+	{
+		BenchResult result = BenchRun((BenchMode)mode, &checks);
+		BenchTable_Row(&table, BENCH_MODE_NAMES[mode], result.timer.bestMs);
+		if (result.bytesPerLiveByte > 0) printf(" %24.2f\n", result.bytesPerLiveByte);
+		else                             printf(" %24s\n", "n/a");
+	}
+
+	LOCAL_PERSIST DqnJob jobList[MEM_POOL_BENCH_NUM_JOBS + 1];
+	DqnJobQueue queue = {};
+	u32 numThreads    = 0;
+	if (!BenchJobQueue_Init(&queue, jobList, DQN_ARRAY_COUNT(jobList), &numThreads)) return 1;
+
+	printf("\n%d jobs of %d ops, Worker Threads: %d (+ main thread)\n", MEM_POOL_BENCH_NUM_JOBS,
+	       MEM_POOL_BENCH_JOB_OPS, numThreads);
+
+	BenchTable sharedTable = {};
+	sharedTable.nameWidth  = 14;
+	sharedTable.numOps     = MEM_POOL_BENCH_NUM_JOBS * MEM_POOL_BENCH_JOB_OPS;
+	sharedTable.opsName    = "ops";
+
+	BenchTable_Header(&sharedTable, NULL);
+	BenchTable_Row(&sharedTable, "calloc/free",  BenchRunShared(&queue, BenchMode_Calloc, &checks));      printf("\n");
+	BenchTable_Row(&sharedTable, "Thread cache", BenchRunShared(&queue, BenchMode_ThreadCache, &checks)); printf("\n");
+
+	printf("\n");
+	return BenchChecks_Report(&checks, "Results");
+}
@@ -0,0 +1,165 @@
+// Benchmark for DqnMemStack block growth with a mixed size allocation pattern. Each frame pushes
+// MEM_STACK_BENCH_NUM_PUSHES allocations, mostly small with a tail of large ones and some 64 byte
+// aligned SIMD buffers, into a temp region on a stack that starts with a 64KB block, then ends the
+// region. Compares sizing new blocks like the current one (the previous policy) against geometric
+// growth with a cap, and malloc per allocation. Reports the time and heap allocations per frame and
+// the bytes held per byte pushed, then checks every allocation is aligned and none overlap.
+#include "Bench.h"
+
+#define MEM_STACK_BENCH_NUM_PUSHES    20000
+#define MEM_STACK_BENCH_NUM_FRAMES    20
+#define MEM_STACK_BENCH_INITIAL_BLOCK DQN_KILOBYTE(64)
+#define MEM_STACK_BENCH_SIMD_ALIGN    64
+
+struct BenchPush
+{
+	u32 size;
+	u32 alignment; // 0 for the stack's alignment
+};
+
+FILE_SCOPE BenchPush globalPushes[MEM_STACK_BENCH_NUM_PUSHES];
+FILE_SCOPE u8       *globalResults[MEM_STACK_BENCH_NUM_PUSHES];
+FILE_SCOPE u64       globalBytesPerFrame;
+
+struct BenchResult
+{
+	BenchTimer timer;
+	f64        allocsPerFrame;
+	f64        bytesHeldPerByte;
+};
+
+// growthFactor: 0 mallocs each allocation instead of using a stack.
+FILE_SCOPE BenchResult BenchRun(const f32 growthFactor, const size_t maxBlockSize)
+{
+	DqnMemStack stack = {};
+	DQN_ASSERT_HARD(DqnMemStack_Init(&stack, MEM_STACK_BENCH_INITIAL_BLOCK, false));
+	stack.blockGrowthFactor = growthFactor;
+	stack.maxBlockSize      = maxBlockSize;
+
+	BenchResult result = {};
+	u64 numAllocs      = 0;
+	for (u32 frame = 0; frame < MEM_STACK_BENCH_NUM_FRAMES; frame++)
+	{
+		u64 allocsStart = DqnMem_GetStats().numAllocs;
+		BenchTimer_Start(&result.timer);
+		if (growthFactor == 0)
+		{
+			for (u32 i = 0; i < MEM_STACK_BENCH_NUM_PUSHES; i++)
+				globalResults[i] = (u8 *)DqnMem_Alloc(globalPushes[i].size);
+			for (u32 i = 0; i < MEM_STACK_BENCH_NUM_PUSHES; i++)
+				DqnMem_Free(globalResults[i]);
+		}
+		else
+		{
+			DqnMemStackTempRegion region = {};
+			DqnMemStackTempRegion_Begin(&region, &stack);
+			for (u32 i = 0; i < MEM_STACK_BENCH_NUM_PUSHES; i++)
+				globalResults[i] = (u8 *)DqnMemStack_Push(&stack, globalPushes[i].size, globalPushes[i].alignment);
+
+			// NOTE: Measure what the stack holds at its peak, before the region gives the blocks back
+			BenchTimer_Stop(&result.timer);
+			size_t heldBytes = 0;
+			for (DqnMemStackBlock *block = stack.block; block; block = block->prevBlock)
+				heldBytes += block->size;
+			result.bytesHeldPerByte = (f64)heldBytes / (f64)globalBytesPerFrame;
+
+			BenchTimer_Start(&result.timer);
+			DqnMemStackTempRegion_End(region);
+		}
+		BenchTimer_Stop(&result.timer);
+
+		// NOTE: The first frame is the same for every policy, after it only the growth differs
+		BenchTimer_EndRun(&result.timer);
+		numAllocs += DqnMem_GetStats().numAllocs - allocsStart;
+	}
+
+	result.allocsPerFrame = (f64)numAllocs / MEM_STACK_BENCH_NUM_FRAMES;
+	DqnMemStack_Free(&stack);
+	return result;
+}
+
+FILE_SCOPE void BenchPrint(BenchTable *const table, const char *const name, const BenchResult result)
+{
+	BenchTable_Row(table, name, result.timer.bestMs);
+	printf(" %12.1f", result.allocsPerFrame);
+	if (result.bytesHeldPerByte > 0) printf(" %26.2f\n", result.bytesHeldPerByte);
+	else                             printf(" %26s\n", "n/a");
+}
+
+// return: FALSE if an allocation is misaligned or overlaps another.
+FILE_SCOPE bool BenchValidate()
+{
+	DqnMemStack stack = {};
+	DQN_ASSERT_HARD(DqnMemStack_Init(&stack, MEM_STACK_BENCH_INITIAL_BLOCK, false));
+	stack.maxBlockSize = DQN_KILOBYTE(256); // NOTE: Force pushes larger than the cap into their own blocks
+
+	bool result = true;
+	for (u32 i = 0; i < MEM_STACK_BENCH_NUM_PUSHES; i++)
+	{
+		const BenchPush *push = &globalPushes[i];
+		u8 *ptr               = (u8 *)DqnMemStack_Push(&stack, push->size, push->alignment);
+		u32 alignment         = DQN_MAX(push->alignment, stack.byteAlign);
+
+		result          &= (ptr && ((size_t)ptr & (alignment - 1)) == 0);
+		globalResults[i] = ptr;
+		memset(ptr, (u8)i, push->size);
+	}
+
+	for (u32 i = 0; i < MEM_STACK_BENCH_NUM_PUSHES && result; i++)
+	{
+		for (u32 j = 0; j < globalPushes[i].size; j++)
+			result &= (globalResults[i][j] == (u8)i);
+	}
+
+	// NOTE: Popping the last allocation leaves the stack exactly as it was before it, padding and all,
+	// so an allocation under it can be popped straight after
+	DqnMemStackBlock *block = stack.block;
+	size_t usedBefore       = block->used;
+	void *small             = DqnMemStack_Push(&stack, 12, 4);
+	void *simd              = DqnMemStack_Push(&stack, 100, MEM_STACK_BENCH_SIMD_ALIGN);
+	result                 &= (stack.block == block && ((size_t)simd & (MEM_STACK_BENCH_SIMD_ALIGN - 1)) == 0);
+	result                 &= DqnMemStack_Pop(&stack, simd, 100, MEM_STACK_BENCH_SIMD_ALIGN);
+	result                 &= DqnMemStack_Pop(&stack, small, 12, 4);
+	result                 &= (block->used == usedBefore);
+
+	DqnMemStack_Free(&stack);
+	return result;
+}
+
+int main(int argc, char *argv[])
+{
+	// NOTE: Mostly small allocations with a long tail, like strings and nodes with the occasional
+	// big buffer, and every 10th is a SIMD buffer
+	DqnRandPCGState rnd = {};
+	DqnRnd_PCGInitWithSeed(&rnd, 0x57ac);
+	for (u32 i = 0; i < MEM_STACK_BENCH_NUM_PUSHES; i++)
+	{
+		BenchPush *push = &globalPushes[i];
+		i32 bucket      = DqnRnd_PCGRange(&rnd, 0, 99);
+		if (bucket < 70)      push->size = (u32)DqnRnd_PCGRange(&rnd, 8, 64);
+		else if (bucket < 95) push->size = (u32)DqnRnd_PCGRange(&rnd, 64, 1024);
+		else                  push->size = (u32)DqnRnd_PCGRange(&rnd, 1024, DQN_KILOBYTE(32));
+
+		push->alignment      = (i % 10 == 0) ? MEM_STACK_BENCH_SIMD_ALIGN : 0;
+		globalBytesPerFrame += push->size;
+	}
+
+	printf("DqnMemStack Block Growth Benchmark\n");
+	printf("Pushes: %d mixed size, %.1f MB per frame, Initial block: %d KB, Best of %d frames\n\n",
+	       MEM_STACK_BENCH_NUM_PUSHES, globalBytesPerFrame / (1024.0 * 1024.0),
+	       (i32)(MEM_STACK_BENCH_INITIAL_BLOCK / 1024), MEM_STACK_BENCH_NUM_FRAMES);
+
+	BenchTable table = {};
+	table.nameWidth  = 20;
+
+	BenchTable_Header(&table, "Allocs/frame Bytes held per byte pushed");
+	BenchPrint(&table, "Same size (previous)", BenchRun(1.0f, DQN_MEM_STACK_MAX_BLOCK_SIZE));
+	BenchPrint(&table, "2x, 64MB cap",         BenchRun(2.0f, DQN_MEGABYTE(64)));
+	BenchPrint(&table, "2x, 1MB cap",          BenchRun(2.0f, DQN_MEGABYTE(1)));
+	BenchPrint(&table, "malloc per push",      BenchRun(0, 0));
+	printf("\n");
+
+	BenchChecks checks = {};
+	BenchChecks_Add(&checks, "Aligned, non-overlapping pushes", BenchValidate());
+	return BenchChecks_Report(&checks, "Alignment and overlap");
+}
@@ -0,0 +1,227 @@
+// Benchmark for DqnMemStackConcurrent. Runs MEM_STACK_CONCURRENT_BENCH_NUM_JOBS jobs on a DqnJobQueue
+// that each push MEM_STACK_CONCURRENT_BENCH_PUSHES small allocations onto one shared stack and fill
+// them, like workers building parts of one result, then frees everything at once. Compares the lock
+// free stack against a DqnMemStack behind a DqnLock and malloc per allocation. Reports the best of
+// MEM_STACK_CONCURRENT_BENCH_NUM_RUNS runs and checks every allocation is aligned and none overlap.
+#include "Bench.h"
+
+#define MEM_STACK_CONCURRENT_BENCH_NUM_JOBS      8
+#define MEM_STACK_CONCURRENT_BENCH_PUSHES        250000
+#define MEM_STACK_CONCURRENT_BENCH_NUM_RUNS      5
+#define MEM_STACK_CONCURRENT_BENCH_INITIAL_BLOCK DQN_KILOBYTE(64)
+#define MEM_STACK_CONCURRENT_BENCH_ALIGN         8
+
+enum BenchMode
+{
+	BenchMode_Malloc,
+	BenchMode_LockedStack,
+	BenchMode_Concurrent,
+	BenchMode_Count,
+};
+
+FILE_SCOPE const char *const BENCH_MODE_NAMES[BenchMode_Count] = {
+    "malloc/free", "Locked stack", "Concurrent",
+};
+
+struct BenchShared
+{
+	BenchMode             mode;
+	DqnLock               lock;
+	DqnMemStack           stack;
+	DqnMemStackConcurrent concurrentStack;
+};
+
+struct BenchJob
+{
+	BenchShared *shared;
+	u32          index;
+	u32          sizes[MEM_STACK_CONCURRENT_BENCH_PUSHES];
+	u32         *results[MEM_STACK_CONCURRENT_BENCH_PUSHES];
+};
+
+FILE_SCOPE BenchJob globalJobs[MEM_STACK_CONCURRENT_BENCH_NUM_JOBS];
+
+FILE_SCOPE inline u32 BenchTag(const u32 jobIndex, const u32 pushIndex)
+{
+	return (jobIndex << 24) | pushIndex;
+}
+
+FILE_SCOPE void BenchJobCallback(DqnJobQueue *const queue, void *const userData)
+{
+	BenchJob *job       = (BenchJob *)userData;
+	BenchShared *shared = job->shared;
+	for (u32 i = 0; i < MEM_STACK_CONCURRENT_BENCH_PUSHES; i++)
+	{
+		u32 size = job->sizes[i];
+		u32 *ptr = NULL;
+		switch (shared->mode)
+		{
+			case BenchMode_Malloc: ptr = (u32 *)DqnMem_Alloc(size); break;
+
+			case BenchMode_LockedStack:
+			{
+				DqnLock_Acquire(&shared->lock);
+				ptr = (u32 *)DqnMemStack_Push(&shared->stack, size);
+				DqnLock_Release(&shared->lock);
+			}
+			break;
+
+			case BenchMode_Concurrent: ptr = (u32 *)DqnMemStackConcurrent_Push(&shared->concurrentStack, size); break;
+			default: break;
+		}
+
+		// NOTE: Every word gets the push's own tag, so an overlap leaves another push's tag behind
+		job->results[i] = ptr;
+		if (!ptr) continue;
+		u32 tag = BenchTag(job->index, i);
+		for (u32 j = 0; j < size / sizeof(u32); j++) ptr[j] = tag;
+	}
+}
+
+// return: FALSE if a push failed, was misaligned or overlapped another.
+FILE_SCOPE bool BenchValidate(const BenchMode mode)
+{
+	bool result = true;
+	for (u32 jobIndex = 0; jobIndex < MEM_STACK_CONCURRENT_BENCH_NUM_JOBS; jobIndex++)
+	{
+		const BenchJob *job = &globalJobs[jobIndex];
+		for (u32 i = 0; i < MEM_STACK_CONCURRENT_BENCH_PUSHES && result; i++)
+		{
+			const u32 *ptr = job->results[i];
+			result &= (ptr != NULL);
+			if (!ptr) break;
+			if (mode != BenchMode_Malloc) result &= (((size_t)ptr & (MEM_STACK_CONCURRENT_BENCH_ALIGN - 1)) == 0);
+
+			u32 tag = BenchTag(jobIndex, i);
+			for (u32 j = 0; j < job->sizes[i] / sizeof(u32); j++) result &= (ptr[j] == tag);
+		}
+	}
+
+	return result;
+}
+
+struct BenchResult
+{
+	BenchTimer timer;
+	i32        numBlocks;
+};
+
+FILE_SCOPE BenchResult BenchRun(DqnJobQueue *const queue, const BenchMode mode, BenchChecks *const checks)
+{
+	LOCAL_PERSIST BenchShared shared;
+	shared      = {};
+	shared.mode = mode;
+	DQN_ASSERT_HARD(DqnLock_Init(&shared.lock));
+
+	BenchResult result = {};
+	for (u32 run = 0; run < MEM_STACK_CONCURRENT_BENCH_NUM_RUNS; run++)
+	{
+		// NOTE: Timed from an empty stack to everything freed, so growing the stack is counted
+		BenchTimer_Start(&result.timer);
+		bool initialised = true;
+		if (mode == BenchMode_LockedStack)
+			initialised = DqnMemStack_Init(&shared.stack, MEM_STACK_CONCURRENT_BENCH_INITIAL_BLOCK, false, MEM_STACK_CONCURRENT_BENCH_ALIGN);
+		else if (mode == BenchMode_Concurrent)
+			initialised = DqnMemStackConcurrent_Init(&shared.concurrentStack, MEM_STACK_CONCURRENT_BENCH_INITIAL_BLOCK, MEM_STACK_CONCURRENT_BENCH_ALIGN);
+		DQN_ASSERT_HARD(initialised);
+
+		for (u32 i = 0; i < MEM_STACK_CONCURRENT_BENCH_NUM_JOBS; i++)
+		{
+			globalJobs[i].shared = &shared;
+			DqnJob queueJob      = {};
+			queueJob.callback    = BenchJobCallback;
+			queueJob.userData    = &globalJobs[i];
+			DQN_ASSERT_HARD(DqnJobQueue_AddJob(queue, queueJob));
+		}
+		DqnJobQueue_BlockAndCompleteAllJobs(queue);
+		BenchTimer_Stop(&result.timer);
+
+		// NOTE: Validate before anything is freed, then time the free on its own
+		if (run == 0) BenchChecks_Add(checks, BENCH_MODE_NAMES[mode], BenchValidate(mode));
+
+		BenchTimer_Start(&result.timer);
+		if (mode == BenchMode_Malloc)
+		{
+			for (u32 i = 0; i < MEM_STACK_CONCURRENT_BENCH_NUM_JOBS; i++)
+			{
+				for (u32 j = 0; j < MEM_STACK_CONCURRENT_BENCH_PUSHES; j++) DqnMem_Free(globalJobs[i].results[j]);
+			}
+		}
+		else if (mode == BenchMode_LockedStack)
+		{
+			result.numBlocks = 0;
+			for (DqnMemStackBlock *block = shared.stack.block; block; block = block->prevBlock) result.numBlocks++;
+			DqnMemStack_Free(&shared.stack);
+		}
+		else
+		{
+			result.numBlocks = shared.concurrentStack.numBlocks;
+			DqnMemStackConcurrent_Free(&shared.concurrentStack);
+		}
+		BenchTimer_Stop(&result.timer);
+		BenchTimer_EndRun(&result.timer);
+	}
+
+	DqnLock_Delete(&shared.lock);
+	return result;
+}
+
+// return: FALSE if clearing didn't keep exactly the newest block, reset.
+FILE_SCOPE bool BenchValidateClear()
+{
+	DqnMemStackConcurrent stack = {};
+	if (!DqnMemStackConcurrent_Init(&stack, 64, MEM_STACK_CONCURRENT_BENCH_ALIGN)) return false;
+
+	for (u32 i = 0; i < 100; i++) DqnMemStackConcurrent_Push(&stack, 24);
+	DqnMemStackConcurrentBlock *newest = stack.block;
+	bool result                        = (stack.numBlocks > 1);
+
+	DqnMemStackConcurrent_Clear(&stack);
+	result &= (stack.block == newest && stack.numBlocks == 1 && !newest->prevBlock);
+	result &= (DqnMemStackConcurrent_Push(&stack, 24) == newest->memory);
+
+	DqnMemStackConcurrent_Free(&stack);
+	return result;
+}
+
+int main(int argc, char *argv[])
+{
+	// NOTE: Small records of 16 to 128 bytes, multiples of 8 so every byte is tagged
+	DqnRandPCGState rnd = {};
+	DqnRnd_PCGInitWithSeed(&rnd, 0xc0c0);
+	for (u32 i = 0; i < MEM_STACK_CONCURRENT_BENCH_NUM_JOBS; i++)
+	{
+		globalJobs[i].index = i;
+		for (u32 j = 0; j < MEM_STACK_CONCURRENT_BENCH_PUSHES; j++)
+			globalJobs[i].sizes[j] = 8 * (u32)DqnRnd_PCGRange(&rnd, 2, 16);
+	}
+
+	LOCAL_PERSIST DqnJob jobList[MEM_STACK_CONCURRENT_BENCH_NUM_JOBS + 1];
+	DqnJobQueue queue = {};
+	u32 numThreads    = 0;
+	if (!BenchJobQueue_Init(&queue, jobList, DQN_ARRAY_COUNT(jobList), &numThreads)) return 1;
+
+	printf("DqnMemStackConcurrent Benchmark\n");
+	printf("%d jobs of %d pushes, Worker Threads: %d (+ main thread), Best of %d runs\n\n",
+	       MEM_STACK_CONCURRENT_BENCH_NUM_JOBS, MEM_STACK_CONCURRENT_BENCH_PUSHES, numThreads,
+	       MEM_STACK_CONCURRENT_BENCH_NUM_RUNS);
+
+	BenchChecks checks = {};
+	BenchTable table   = {};
+	table.nameWidth    = 14;
+	table.numOps       = MEM_STACK_CONCURRENT_BENCH_NUM_JOBS * MEM_STACK_CONCURRENT_BENCH_PUSHES;
+	table.opsName      = "pushes";
+
+	BenchTable_Header(&table, "Blocks");
+	for (i32 mode = 0; mode < BenchMode_Count; mode++)
+	{
+		BenchResult result = BenchRun(&queue, (BenchMode)mode, &checks);
+		BenchTable_Row(&table, BENCH_MODE_NAMES[mode], result.timer.bestMs);
+		if (result.numBlocks > 0) printf(" %6d\n", result.numBlocks);
+		else                      printf(" %6s\n", "n/a");
+	}
+	printf("\n");
+
+	BenchChecks_Add(&checks, "Clear", BenchValidateClear());
+	return BenchChecks_Report(&checks, "Alignment, overlap and clear");
+}
@@ -0,0 +1,272 @@
+// Load test for the shared memory window table (see WinjumpSharedTable.h). Reader threads each map
+// the region by name, as another process would, and scan the whole table back to back whilst the
+// main thread churns a synthetic window table and republishes it as fast as it changes. Reports the
+// reads per second, how long a scan takes, how often a publish tore a read and how long publishing
+// took, then checks every read that was accepted against what the writer published.
+//
+// Usage: winjump_shared_table_bench [-readers N] [-windows N] [-seconds N]
+//   -readers Concurrent readers, default 4, at most SHARED_BENCH_MAX_READERS
+//   -windows Size of the window table, default 2000
+//   -seconds How long to run for, default 5
+#include "BenchCore.h"
+#include "../WinjumpSharedTable.h"
+
+#if defined(_WIN32)
+	#define SHARED_BENCH_NAME "Local\\WinjumpSharedTableBench"
+#else
+	#define SHARED_BENCH_NAME "/winjump_shared_table_bench"
+#endif
+
+#define SHARED_BENCH_DEFAULT_READERS 4
+#define SHARED_BENCH_DEFAULT_WINDOWS 2000
+#define SHARED_BENCH_DEFAULT_SECONDS 5
+#define SHARED_BENCH_MAX_READERS     16
+#define SHARED_BENCH_HISTORY_SIZE    1024 // Published generations remembered for checking reads against
+
+// NOTE: What the writer published for a generation, readers compare their hash of a read against it
+typedef struct SharedBenchPublish
+{
+	i32 volatile generation; // -1 whilst being written
+	u64          hash;
+} SharedBenchPublish;
+
+typedef struct SharedBenchShared
+{
+	bool volatile isRunning;
+	i32 volatile  numReads;
+	i32 volatile  numTorn;     // Reads a publish overlapped, retried
+	i32 volatile  numChecked;  // Accepted reads whose generation was still in the history
+	i32 volatile  numMismatch; // Accepted reads that differ from what was published, a broken seqlock
+	i32 volatile  numFailed;   // Readers that couldn't open the region
+	i32 volatile  numSamples;
+	f32           samples[BENCH_MAX_SAMPLES]; // Time to scan the table, including retries
+	SharedBenchPublish history[SHARED_BENCH_HISTORY_SIZE];
+} SharedBenchShared;
+
+// NOTE: FNV-1a over the table as a reader sees it
+FILE_SCOPE u64 SharedBenchHash(u64 hash, const void *const data, const size_t size)
+{
+	const u8 *bytes = (const u8 *)data;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= (u64)bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+// Hash the table and count the entries with an exe, the sort of scan a status bar would do.
+// return: FALSE if the read was torn and pointed outside the region.
+FILE_SCOPE bool SharedBenchScan(const WinjumpSharedTableReader *const reader, u64 *const hash,
+                                i32 *const numWithExe)
+{
+	*hash       = 14695981039346656037ULL;
+	*numWithExe = 0;
+
+	i32 numEntries                         = 0;
+	const WinjumpSharedTableEntry *entries = WinjumpSharedTableReader_GetEntries(reader, &numEntries);
+	for (i32 i = 0; i < numEntries; i++)
+	{
+		const WinjumpSharedTableEntry *entry = &entries[i];
+		const u16 *text                      = WinjumpSharedTableReader_GetText(reader, entry);
+		if (!text) return false;
+
+		*hash = SharedBenchHash(*hash, &entry->window, sizeof(entry->window));
+		*hash = SharedBenchHash(*hash, &entry->pid, sizeof(entry->pid));
+		*hash = SharedBenchHash(*hash, text, sizeof(u16) * (entry->titleLen + entry->exeLen));
+		if (entry->exeLen > 0) (*numWithExe)++;
+	}
+
+	return true;
+}
+
+// NOTE: Runs on a job queue thread for the whole benchmark, one job per reader
+FILE_SCOPE void SharedBenchReaderJob(DqnJobQueue *const queue, void *const userData)
+{
+	SharedBenchShared *shared       = (SharedBenchShared *)userData;
+	WinjumpSharedTableReader reader = {};
+	if (!WinjumpSharedTableReader_Open(&reader, SHARED_BENCH_NAME))
+	{
+		DqnAtomic_Add32(&shared->numFailed, 1);
+		return;
+	}
+
+	const WinjumpSharedTableHeader *header = WinjumpSharedTableReader_GetHeader(&reader);
+	while (shared->isRunning)
+	{
+		f64 startMs    = DqnTimer_NowInMs();
+		u64 hash       = 0;
+		u32 generation = 0;
+		for (;;)
+		{
+			i32 numWithExe = 0;
+			u32 sequence   = WinjumpSharedTableReader_BeginRead(&reader);
+			generation     = header->generation;
+			bool scanned   = SharedBenchScan(&reader, &hash, &numWithExe);
+			if (WinjumpSharedTableReader_EndRead(&reader, sequence) && scanned) break;
+			DqnAtomic_Add32(&shared->numTorn, 1);
+		}
+
+		f32 scanMs = (f32)(DqnTimer_NowInMs() - startMs);
+		i32 sample = DqnAtomic_Add32(&shared->numSamples, 1) - 1;
+		if (sample < DQN_ARRAY_COUNT(shared->samples)) shared->samples[sample] = scanMs;
+		DqnAtomic_Add32(&shared->numReads, 1);
+
+		// NOTE: The generation is only remembered once the writer has hashed it, and is gone once
+		// it's been overwritten, so not every read can be checked
+		SharedBenchPublish *publish = &shared->history[generation % SHARED_BENCH_HISTORY_SIZE];
+		i32 generationBefore        = DqnAtomic_CompareSwap32(&publish->generation, 0, 0);
+		u64 publishedHash           = publish->hash;
+		i32 generationAfter         = DqnAtomic_CompareSwap32(&publish->generation, 0, 0);
+		if (generationBefore != (i32)generation || generationAfter != (i32)generation) continue;
+
+		DqnAtomic_Add32(&shared->numChecked, 1);
+		if (publishedHash != hash) DqnAtomic_Add32(&shared->numMismatch, 1);
+	}
+
+	WinjumpSharedTableReader_Close(&reader);
+}
+
+// Churn the table and bring the core up to date with it, exes included.
+// return: FALSE if out of memory.
+FILE_SCOPE bool SharedBenchChurn(BenchWindowSource *const bench, WinjumpCore *const core,
+                                 WinjumpListView *const view, const i32 percent)
+{
+	BenchSourceChurn(bench, percent);
+	core->enumerateSchedule.windowsChanged = true;
+	if (!BenchUpdate(core, view, L"", 0, NULL)) return false;
+	DqnJobQueue_BlockAndCompleteAllJobs(&core->jobQueue);
+	return BenchUpdate(core, view, L"", 0, NULL);
+}
+
+// Remember what was just published, hashed through the writer's own view of the region.
+FILE_SCOPE void SharedBenchRecordPublish(SharedBenchShared *const shared, const WinjumpSharedTable *const table)
+{
+	WinjumpSharedTableReader writerView = {};
+	writerView.region                   = table->region;
+	writerView.regionSize               = (u32)WINJUMP_SHARED_TABLE_SIZE;
+
+	u64 hash       = 0;
+	i32 numWithExe = 0;
+	u32 generation = WinjumpSharedTableReader_GetHeader(&writerView)->generation;
+	SharedBenchScan(&writerView, &hash, &numWithExe);
+
+	SharedBenchPublish *publish = &shared->history[generation % SHARED_BENCH_HISTORY_SIZE];
+	DqnAtomic_CompareSwap32(&publish->generation, -1, publish->generation);
+	publish->hash = hash;
+	DqnAtomic_CompareSwap32(&publish->generation, (i32)generation, -1);
+}
+
+int main(int argc, char *argv[])
+{
+	i32 numReaders = BenchArgToInt(argc, argv, "-readers", SHARED_BENCH_DEFAULT_READERS);
+	i32 numWindows = BenchArgToInt(argc, argv, "-windows", SHARED_BENCH_DEFAULT_WINDOWS);
+	i32 numSeconds = BenchArgToInt(argc, argv, "-seconds", SHARED_BENCH_DEFAULT_SECONDS);
+	numReaders     = DQN_MIN(numReaders, SHARED_BENCH_MAX_READERS);
+
+	BenchWindowSource benchSource = {};
+	WinjumpWindowSource source    = {};
+	BenchListView benchView       = {};
+	WinjumpListView view          = {};
+	BenchViewInit(&benchView, &view);
+	if (!BenchSourceInit(&benchSource, &source, 0x5a7e))
+	{
+		printf("BenchSourceInit() failed\n");
+		return 1;
+	}
+	BenchSourceResize(&benchSource, numWindows);
+
+	LOCAL_PERSIST WinjumpCore core;
+	LOCAL_PERSIST SharedBenchShared shared;
+	WinjumpSharedTable table = {};
+	if (!WinjumpCore_Init(&core, &source) || !SharedBenchChurn(&benchSource, &core, &view, 0))
+	{
+		printf("WinjumpCore_Init() failed\n");
+		return 1;
+	}
+
+	if (!WinjumpSharedTable_Create(&table, SHARED_BENCH_NAME))
+	{
+		printf("WinjumpSharedTable_Create() failed: Could not create %s\n", SHARED_BENCH_NAME);
+		return 1;
+	}
+
+	for (i32 i = 0; i < DQN_ARRAY_COUNT(shared.history); i++)
+		shared.history[i].generation = -1;
+
+	WinjumpSharedTable_Publish(&table, &core);
+	SharedBenchRecordPublish(&shared, &table);
+
+	printf("Winjump Shared Table Bench\n");
+	printf("%d readers, %d windows, %ds, republished on every change\n\n", numReaders, numWindows, numSeconds);
+
+	LOCAL_PERSIST DqnJob jobList[SHARED_BENCH_MAX_READERS + 1];
+	DqnJobQueue queue = {};
+	shared.isRunning  = true;
+	if (!DqnJobQueue_Init(&queue, jobList, DQN_ARRAY_COUNT(jobList), numReaders))
+	{
+		printf("DqnJobQueue_Init() failed\n");
+		return 1;
+	}
+
+	f64 startMs = DqnTimer_NowInMs();
+	for (i32 i = 0; i < numReaders; i++)
+	{
+		DqnJob job = {SharedBenchReaderJob, &shared};
+		DqnJobQueue_AddJob(&queue, job);
+	}
+
+	LOCAL_PERSIST BenchTimings publishTimings;
+	bool result = true;
+	f64 endMs   = startMs + (numSeconds * 1000.0);
+	while (result && DqnTimer_NowInMs() < endMs)
+	{
+		result = SharedBenchChurn(&benchSource, &core, &view, 1);
+
+		f64 publishStartMs = DqnTimer_NowInMs();
+		WinjumpSharedTable_Publish(&table, &core);
+		if (publishTimings.numSamples < DQN_ARRAY_COUNT(publishTimings.samples))
+			publishTimings.samples[publishTimings.numSamples++] = (f32)(DqnTimer_NowInMs() - publishStartMs);
+
+		SharedBenchRecordPublish(&shared, &table);
+	}
+
+	shared.isRunning = false;
+	DqnJobQueue_BlockAndCompleteAllJobs(&queue);
+	f64 elapsedS = (DqnTimer_NowInMs() - startMs) / 1000.0;
+	if (!result)
+	{
+		printf("Out of memory\n");
+		return 1;
+	}
+
+	printf("                              p50      p99      max\n");
+	i32 numSamples = DQN_MIN(shared.numSamples, (i32)DQN_ARRAY_COUNT(shared.samples));
+	if (numSamples > 0)
+	{
+		Dqn_QuickSort(shared.samples, numSamples, BenchF32IsLessThan);
+		printf("  Table scan           %8.3f %8.3f %8.3f ms\n", shared.samples[(i32)((numSamples - 1) * 0.50f)],
+		       shared.samples[(i32)((numSamples - 1) * 0.99f)], shared.samples[numSamples - 1]);
+	}
+
+	if (publishTimings.numSamples > 0)
+	{
+		u32 numPublishes = publishTimings.numSamples;
+		Dqn_QuickSort(publishTimings.samples, numPublishes, BenchF32IsLessThan);
+		printf("  Publish              %8.3f %8.3f %8.3f ms\n",
+		       publishTimings.samples[(u32)((numPublishes - 1) * 0.50f)],
+		       publishTimings.samples[(u32)((numPublishes - 1) * 0.99f)], publishTimings.samples[numPublishes - 1]);
+		printf("  Publishes:           %u, %.0f/s\n", numPublishes, numPublishes / elapsedS);
+	}
+
+	f32 tornPercent = (shared.numReads > 0) ? (shared.numTorn * 100.0f) / (shared.numReads + shared.numTorn) : 0;
+	printf("  Reads:               %d, %.0f/s\n", shared.numReads, shared.numReads / elapsedS);
+	printf("  Torn and retried:    %d, %.2f%%\n", shared.numTorn, tornPercent);
+	printf("  Checked reads:       %d, %d mismatched\n", shared.numChecked, shared.numMismatch);
+	printf("  Failed readers:      %d\n", shared.numFailed);
+
+	WinjumpSharedTable_Destroy(&table);
+	WinjumpCore_Free(&core);
+	DqnArray_Free(&benchSource.windows);
+	return (shared.numFailed > 0 || shared.numMismatch > 0) ? 1 : 0;
+}
@@ -0,0 +1,196 @@
+// Soak test for the Winjump core under a storm of windows being created, retitled and destroyed.
+// Frames run back to back, each applying the window events due since the last frame and then the
+// work of Winjump_Update(), with a simulated user typing and deleting searches so enumeration,
+// snapshots, filtering and speculation all stay busy. At every report interval it prints the
+// resident memory, live DqnMem allocations and frame times, and at the end the growth of each
+// since warm up. Fails if live allocations keep growing, which means something isn't freed.
+//
+// Usage: winjump_soak [-seconds N] [-windows N] [-rate N]
+//   -seconds How long to run for, default 60. Pass i.e. 14400 for a 4 hour soak.
+//   -windows The size the window table hovers around, default 2000
+//   -rate    Window events per second, default 5000
+#include "BenchCore.h"
+
+#if defined(_WIN32)
+	#define VC_EXTRALEAN 1
+	#define WIN32_LEAN_AND_MEAN 1
+	#include <Windows.h>
+	#include <Psapi.h> // For win32 GetProcessMemoryInfo()
+#else
+	#include <unistd.h>
+#endif
+
+#define SOAK_DEFAULT_SECONDS 60
+#define SOAK_DEFAULT_WINDOWS 2000
+#define SOAK_DEFAULT_RATE    5000
+#define SOAK_NUM_REPORTS     12 // Report intervals over the run, the first is warm up
+#define SOAK_KEYSTROKE_EVERY 3  // Frames per keystroke, the frames in between are idle
+
+// NOTE: Live allocations move with the snapshot stack depth and friendly name arena blocks, only
+// growth past this between warm up and the end is reported as a leak.
+#define SOAK_LIVE_ALLOCS_SLACK 64
+
+FILE_SCOPE const wchar_t *const SOAK_QUERIES[] = {
+    L"firefox", L"meeting notes", L"code.exe", L"sett", L"review - slack", L"zzz", L"12",
+};
+
+FILE_SCOPE size_t SoakResidentBytes()
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS memCounter = {};
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &memCounter, sizeof(memCounter))) return 0;
+	return memCounter.WorkingSetSize;
+#else
+	FILE *file = fopen("/proc/self/statm", "r");
+	if (!file) return 0;
+
+	unsigned long numPages = 0, numResidentPages = 0;
+	i32 numRead = fscanf(file, "%lu %lu", &numPages, &numResidentPages);
+	fclose(file);
+	if (numRead != 2) return 0;
+	return (size_t)numResidentPages * (size_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+FILE_SCOPE i64 SoakLiveAllocs()
+{
+	DqnMemStats stats = DqnMem_GetStats();
+	i64 result        = (i64)(stats.numAllocs - stats.numFrees);
+	return result;
+}
+
+typedef struct SoakSample
+{
+	size_t residentBytes;
+	i64    liveAllocs;
+	f32    frameP50Ms;
+	f32    frameP99Ms;
+} SoakSample;
+
+// Summarise the interval's frame times and reset them for the next one.
+FILE_SCOPE SoakSample SoakTakeSample(BenchTimings *const frames)
+{
+	SoakSample result    = {};
+	result.residentBytes = SoakResidentBytes();
+	result.liveAllocs    = SoakLiveAllocs();
+	if (frames->numSamples > 0)
+	{
+		Dqn_QuickSort(frames->samples, frames->numSamples, BenchF32IsLessThan);
+		result.frameP50Ms = frames->samples[(u32)((frames->numSamples - 1) * 0.50f)];
+		result.frameP99Ms = frames->samples[(u32)((frames->numSamples - 1) * 0.99f)];
+	}
+
+	*frames = {};
+	return result;
+}
+
+int main(int argc, char *argv[])
+{
+	i32 numSeconds    = BenchArgToInt(argc, argv, "-seconds", SOAK_DEFAULT_SECONDS);
+	i32 targetWindows = BenchArgToInt(argc, argv, "-windows", SOAK_DEFAULT_WINDOWS);
+	i32 eventsPerS    = BenchArgToInt(argc, argv, "-rate", SOAK_DEFAULT_RATE);
+
+	BenchWindowSource benchSource = {};
+	WinjumpWindowSource source    = {};
+	BenchListView benchView       = {};
+	WinjumpListView view          = {};
+	BenchViewInit(&benchView, &view);
+	if (!BenchSourceInit(&benchSource, &source, 0x50a4))
+	{
+		printf("BenchSourceInit() failed\n");
+		return 1;
+	}
+	BenchSourceResize(&benchSource, targetWindows);
+
+	LOCAL_PERSIST WinjumpCore core;
+	if (!WinjumpCore_Init(&core, &source))
+	{
+		printf("WinjumpCore_Init() failed\n");
+		return 1;
+	}
+
+	printf("Winjump Soak\n");
+	printf("%ds, ~%d windows, %d window events/s\n\n", numSeconds, targetWindows, eventsPerS);
+	printf("  time   resident     live allocs   frames   frame p50   frame p99   window events\n");
+
+	LOCAL_PERSIST BenchTimings frames;
+	SoakSample warmUp    = {};
+	SoakSample last      = {};
+	f64 startMs          = DqnTimer_NowInMs();
+	f64 endMs            = startMs + (numSeconds * 1000.0);
+	f64 reportIntervalMs = (numSeconds * 1000.0) / SOAK_NUM_REPORTS;
+	f64 nextReportMs     = startMs + reportIntervalMs;
+	f64 lastFrameMs      = startMs;
+	f64 eventsDue        = 0;
+	u64 numEvents        = 0;
+	i32 numReports       = 0;
+	u32 numFrames        = 0;
+	i32 queryIndex       = 0;
+	i32 queryStep        = 0; // Keystrokes into the query, typing it then deleting it
+	bool result          = true;
+
+	for (f64 nowMs = startMs; result && numReports < SOAK_NUM_REPORTS; nowMs = DqnTimer_NowInMs())
+	{
+		// NOTE: Window events only mark the table as changed, like the WinEvent hook, and the core
+		// decides when to enumerate
+		eventsDue += eventsPerS * ((nowMs - lastFrameMs) / 1000.0);
+		lastFrameMs = nowMs;
+		i32 numDue  = (i32)eventsDue;
+		eventsDue  -= numDue;
+		if (numDue > 0)
+		{
+			BenchSourceStorm(&benchSource, numDue, targetWindows);
+			core.enumerateSchedule.windowsChanged = true;
+			numEvents += numDue;
+		}
+
+		const wchar_t *query = SOAK_QUERIES[queryIndex];
+		i32 queryLen         = DqnWStr_Len(query);
+		i32 searchLen        = (queryStep <= queryLen) ? queryStep : (queryLen * 2) - queryStep;
+		result               = BenchUpdate(&core, &view, query, searchLen, &frames);
+		numFrames++;
+
+		bool isKeystrokeFrame = (numFrames % SOAK_KEYSTROKE_EVERY) == 0;
+		if (!isKeystrokeFrame)
+		{
+			WinjumpCore_SpeculateNextChars(&core);
+			continue;
+		}
+
+		// NOTE: Only sample between queries, so the snapshot stack is empty each time
+		if (++queryStep <= queryLen * 2) continue;
+		queryStep  = 0;
+		queryIndex = (queryIndex + 1) % DQN_ARRAY_COUNT(SOAK_QUERIES);
+		if (nowMs < nextReportMs && nowMs < endMs) continue;
+
+		u32 numIntervalFrames = frames.numSamples;
+		last                  = SoakTakeSample(&frames);
+		if (numReports++ == 0) warmUp = last;
+		nextReportMs += reportIntervalMs;
+
+		printf("%6.1fs %8.2f MiB %15lld %8u %8.3f ms %8.3f ms %15llu\n", (nowMs - startMs) / 1000.0,
+		       last.residentBytes / (1024.0 * 1024.0), (long long)last.liveAllocs, numIntervalFrames,
+		       last.frameP50Ms, last.frameP99Ms, (unsigned long long)numEvents);
+	}
+
+	if (!result)
+	{
+		printf("Out of memory\n");
+		return 1;
+	}
+
+	// NOTE: Growth is from the end of the first interval, once the arrays and arenas have grown to size
+	i64 liveGrowth     = last.liveAllocs - warmUp.liveAllocs;
+	f64 residentGrowth = ((f64)last.residentBytes - (f64)warmUp.residentBytes) / (1024.0 * 1024.0);
+	f32 frameDrift     = (warmUp.frameP50Ms > 0) ? (last.frameP50Ms / warmUp.frameP50Ms) : 0;
+	bool leaked        = (liveGrowth > SOAK_LIVE_ALLOCS_SLACK);
+
+	printf("\nSince warm up\n");
+	printf("  Resident:    %+.2f MiB\n", residentGrowth);
+	printf("  Live allocs: %+lld%s\n", (long long)liveGrowth, leaked ? " LEAKING" : "");
+	printf("  Frame p50:   %.2fx\n", frameDrift);
+
+	WinjumpCore_Free(&core);
+	DqnArray_Free(&benchSource.windows);
+	return leaked ? 1 : 0;
+}
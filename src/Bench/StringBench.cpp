@@ -0,0 +1,264 @@
+// Benchmark for DqnString. Sets STRING_BENCH_NUM_STRINGS names of mixed length, mostly short like
+// exe names with a tail of long window titles, then frees them all. Compares malloc per name,
+// DqnString on the default memAPI and DqnString on a DqnMemStack, reporting the time and heap
+// allocations per name. Then checks the move from inline to heap storage at DQN_STRING_INLINE_LEN
+// for char and wchar_t, geometric growth on append, DqnString_Sprintf past the inline storage,
+// strings backed by a stack and that freeing a string makes it inline again.
+#include "Bench.h"
+
+#define STRING_BENCH_NUM_STRINGS 100000
+#define STRING_BENCH_NUM_RUNS    5
+#define STRING_BENCH_MAX_LEN     96
+
+enum BenchMode
+{
+	BenchMode_Malloc,
+	BenchMode_String,
+	BenchMode_StackString,
+	BenchMode_Count,
+};
+
+FILE_SCOPE const char *const BENCH_MODE_NAMES[BenchMode_Count] = {
+    "malloc per name", "DqnString", "DqnString on stack",
+};
+
+FILE_SCOPE char      globalNames[STRING_BENCH_NUM_STRINGS][STRING_BENCH_MAX_LEN + 1];
+FILE_SCOPE i32       globalNameLens[STRING_BENCH_NUM_STRINGS];
+FILE_SCOPE char     *globalMallocNames[STRING_BENCH_NUM_STRINGS];
+FILE_SCOPE DqnString globalStrings[STRING_BENCH_NUM_STRINGS];
+
+struct BenchResult
+{
+	BenchTimer timer;
+	f64        allocsPerString;
+};
+
+FILE_SCOPE BenchResult BenchRun(const BenchMode mode, BenchChecks *const checks)
+{
+	DqnMemStack stack = {};
+	DQN_ASSERT_HARD(DqnMemStack_Init(&stack, DQN_MEGABYTE(1), false));
+
+	BenchResult result = {};
+	bool valid         = true;
+	for (u32 run = 0; run < STRING_BENCH_NUM_RUNS; run++)
+	{
+		DqnMemAPI memAPI = (mode == BenchMode_StackString) ? DqnMemAPI_StackAllocator(&stack)
+		                                                    : DqnMemAPI_DefaultUseCalloc();
+		u64 allocsStart = DqnMem_GetStats().numAllocs;
+		BenchTimer_Start(&result.timer);
+
+		// NOTE: The strings are dropped with the region instead of freed one by one
+		DqnMemStackTempRegion region = {};
+		if (mode == BenchMode_StackString) DqnMemStackTempRegion_Begin(&region, &stack);
+		for (u32 i = 0; i < STRING_BENCH_NUM_STRINGS; i++)
+		{
+			if (mode == BenchMode_Malloc)
+			{
+				i32 len              = DqnStr_Len(globalNames[i]);
+				globalMallocNames[i] = (char *)DqnMem_Alloc((size_t)len + 1);
+				memcpy(globalMallocNames[i], globalNames[i], (size_t)len + 1);
+			}
+			else
+			{
+				DqnString_Init(&globalStrings[i], memAPI);
+				valid &= globalStrings[i].Set(globalNames[i]);
+			}
+		}
+		BenchTimer_Stop(&result.timer);
+		u64 numAllocs = DqnMem_GetStats().numAllocs - allocsStart;
+
+		// NOTE: Check before anything is freed, then time the free with the sets
+		if (run == 0)
+		{
+			for (u32 i = 0; i < STRING_BENCH_NUM_STRINGS; i++)
+			{
+				const char *str = (mode == BenchMode_Malloc) ? globalMallocNames[i] : globalStrings[i].Str();
+				valid &= (DqnStr_Cmp(str, globalNames[i]) == 0);
+				if (mode != BenchMode_Malloc) valid &= (globalStrings[i].len == globalNameLens[i]);
+			}
+		}
+
+		BenchTimer_Start(&result.timer);
+		if (mode == BenchMode_Malloc)
+		{
+			for (u32 i = 0; i < STRING_BENCH_NUM_STRINGS; i++) DqnMem_Free(globalMallocNames[i]);
+		}
+		else if (mode == BenchMode_String)
+		{
+			for (u32 i = 0; i < STRING_BENCH_NUM_STRINGS; i++) DqnString_Free(&globalStrings[i]);
+		}
+		else
+		{
+			DqnMemStackTempRegion_End(region);
+		}
+		BenchTimer_Stop(&result.timer);
+		BenchTimer_EndRun(&result.timer);
+
+		result.allocsPerString = (f64)numAllocs / STRING_BENCH_NUM_STRINGS;
+	}
+
+	BenchChecks_Add(checks, BENCH_MODE_NAMES[mode], valid);
+	DqnMemStack_Free(&stack);
+	return result;
+}
+
+// return: FALSE if a string of DQN_STRING_INLINE_LEN characters allocated, one more didn't move to
+//         the heap intact, or freeing it didn't leave it empty and inline.
+template <typename T>
+FILE_SCOPE bool BenchValidateInlineToHeap()
+{
+	const i32 inlineLen = DQN_STRING_INLINE_LEN(T);
+	T src[64];
+	for (i32 i = 0; i < DQN_ARRAY_COUNT(src); i++) src[i] = (T)('a' + (i % 26));
+
+	DqnBasicString<T> str = {};
+	DqnMemStats start     = DqnMem_GetStats();
+	bool result           = str.Set(src, inlineLen);
+	result &= (str.Str() == str.inlineStr && str.len == inlineLen && str.Str()[inlineLen] == 0);
+	result &= (DqnMem_GetStats().numAllocs == start.numAllocs);
+
+	result &= str.Append(src + inlineLen, 1);
+	result &= (str.Str() != str.inlineStr && str.len == inlineLen + 1 && str.Str()[inlineLen + 1] == 0);
+	result &= (memcmp(str.Str(), src, sizeof(T) * (inlineLen + 1)) == 0);
+	result &= (DqnMem_GetStats().numAllocs == start.numAllocs + 1);
+
+	str.Free();
+	result &= (DqnMem_GetStats().numFrees == start.numFrees + 1);
+	result &= (str.len == 0 && str.Str() == str.inlineStr && str.Str()[0] == 0);
+
+	// NOTE: Once freed it's usable again and short strings stay inline
+	result &= (str.Set(src, inlineLen) && str.Str() == str.inlineStr);
+	result &= (DqnMem_GetStats().numAllocs == start.numAllocs + 1);
+	str.Free();
+	return result;
+}
+
+// return: FALSE if appending a character at a time lost characters or reallocated more than
+//         doubling the capacity each time would.
+FILE_SCOPE bool BenchValidateAppend()
+{
+	DqnString str     = {};
+	DqnMemStats start = DqnMem_GetStats();
+	bool result       = true;
+	for (i32 i = 0; i < 1000; i++)
+	{
+		char c = (char)('a' + (i % 26));
+		result &= str.Append(&c, 1);
+	}
+
+	// NOTE: 1 allocation to leave the inline storage, then 23 doubles past 1000 in 6 reallocs
+	DqnMemStats end = DqnMem_GetStats();
+	result &= (end.numAllocs - start.numAllocs == 1 && end.numReallocs - start.numReallocs <= 6);
+	result &= (str.len == 1000 && str.max >= 1000 && str.Str()[1000] == 0);
+	for (i32 i = 0; i < str.len; i++) result &= (str.Str()[i] == (char)('a' + (i % 26)));
+
+	str.Free();
+	return result;
+}
+
+// return: FALSE if DqnString_Sprintf output differs from Dqn_snprintf, short or past the inline
+//         storage.
+FILE_SCOPE bool BenchValidateSprintf()
+{
+	char expected[128];
+	DqnString str = {};
+
+	i32 len     = Dqn_snprintf(expected, DQN_ARRAY_COUNT(expected), "%2d: %s", 7, "vim.exe");
+	bool result = DqnString_Sprintf(&str, "%2d: %s", 7, "vim.exe");
+	result &= (str.Str() == str.inlineStr && str.len == len && DqnStr_Cmp(str.Str(), expected) == 0);
+
+	len     = Dqn_snprintf(expected, DQN_ARRAY_COUNT(expected), "%2d: %s - %s", 12,
+	                       "Inbox - someone@example.com - Outlook", "outlook.exe");
+	result &= DqnString_Sprintf(&str, "%2d: %s - %s", 12, "Inbox - someone@example.com - Outlook",
+	                            "outlook.exe");
+	result &= (len > DQN_STRING_INLINE_LEN(char));
+	result &= (str.Str() != str.inlineStr && str.len == len && DqnStr_Cmp(str.Str(), expected) == 0);
+
+	// NOTE: Shorter output reuses the allocation
+	char *allocStr = str.Str();
+	len            = Dqn_snprintf(expected, DQN_ARRAY_COUNT(expected), "%d", 42);
+	result &= DqnString_Sprintf(&str, "%d", 42);
+	result &= (str.Str() == allocStr && str.len == len && DqnStr_Cmp(str.Str(), expected) == 0);
+
+	str.Free();
+	return result;
+}
+
+// return: FALSE if a string on a DqnMemStack didn't allocate from the stack, couldn't grow on it or
+//         didn't give the memory back to it when freed.
+FILE_SCOPE bool BenchValidateStack()
+{
+	DqnMemStack stack = {};
+	if (!DqnMemStack_Init(&stack, DQN_KILOBYTE(4), false)) return false;
+
+	char src[STRING_BENCH_MAX_LEN];
+	for (i32 i = 0; i < DQN_ARRAY_COUNT(src); i++) src[i] = (char)('A' + (i % 26));
+
+	DqnString str = {};
+	DqnString_Init(&str, DqnMemAPI_StackAllocator(&stack));
+	DqnMemStats start = DqnMem_GetStats();
+
+	bool result           = str.Set(src, 40);
+	const u8 *blockStart  = stack.block->memory;
+	const u8 *ptr         = (const u8 *)str.Str();
+	result               &= (ptr >= blockStart && ptr < blockStart + stack.block->used);
+
+	// NOTE: The string is the stack's last allocation, so it grows in place
+	result &= str.Append(src + 40, 50);
+	result &= ((const u8 *)str.Str() == ptr && str.len == 90 && memcmp(str.Str(), src, 90) == 0);
+	result &= (DqnMem_GetStats().numAllocs == start.numAllocs);
+
+	str.Free();
+	result &= (stack.block->used == 0 && str.Str() == str.inlineStr && str.len == 0);
+
+	DqnMemStack_Free(&stack);
+	return result;
+}
+
+int main(int argc, char *argv[])
+{
+	// NOTE: Mostly short names that fit inline, with a tail of long titles that don't
+	DqnRandPCGState rnd = {};
+	DqnRnd_PCGInitWithSeed(&rnd, 0x57a1);
+	i32 numInline = 0;
+	for (u32 i = 0; i < STRING_BENCH_NUM_STRINGS; i++)
+	{
+		i32 len = (DqnRnd_PCGRange(&rnd, 0, 99) < 70) ? DqnRnd_PCGRange(&rnd, 4, 20)
+		                                              : DqnRnd_PCGRange(&rnd, 24, STRING_BENCH_MAX_LEN);
+		for (i32 j = 0; j < len; j++) globalNames[i][j] = (char)DqnRnd_PCGRange(&rnd, 'a', 'z');
+		globalNames[i][len] = 0;
+		globalNameLens[i]   = len;
+		if (len <= DQN_STRING_INLINE_LEN(char)) numInline++;
+	}
+
+	printf("DqnString Benchmark\n");
+	printf("Names: %d, %d%% fit inline, Inline length: %d char %d wchar_t, Best of %d runs\n\n",
+	       STRING_BENCH_NUM_STRINGS, (numInline * 100) / STRING_BENCH_NUM_STRINGS,
+	       DQN_STRING_INLINE_LEN(char), DQN_STRING_INLINE_LEN(wchar_t), STRING_BENCH_NUM_RUNS);
+
+	BenchChecks checks = {};
+	BenchTable table   = {};
+	table.nameWidth    = 18;
+
+	BenchTable_Header(&table, "Allocs/name");
+	for (i32 mode = 0; mode < BenchMode_Count; mode++)
+	{
+		BenchResult result = BenchRun((BenchMode)mode, &checks);
+		BenchTable_Row(&table, BENCH_MODE_NAMES[mode], result.timer.bestMs);
+		printf(" %11.2f\n", result.allocsPerString);
+	}
+	printf("\n");
+
+	// NOTE: wchar_t is 2 bytes on Win32 and 4 elsewhere, so far fewer fit inline off Win32
+	const i32 expectedWideInlineLen = (sizeof(wchar_t) == 2) ? 11 : 5;
+	bool inlineLenValid             = (DQN_STRING_INLINE_BYTES != 24) ||
+	                      (DQN_STRING_INLINE_LEN(char) == 23 && DQN_STRING_INLINE_LEN(wchar_t) == expectedWideInlineLen);
+
+	BenchChecks_Add(&checks, "Inline length",           inlineLenValid);
+	BenchChecks_Add(&checks, "Inline to heap, char",    BenchValidateInlineToHeap<char>());
+	BenchChecks_Add(&checks, "Inline to heap, wchar_t", BenchValidateInlineToHeap<wchar_t>());
+	BenchChecks_Add(&checks, "Append",                  BenchValidateAppend());
+	BenchChecks_Add(&checks, "Sprintf",                 BenchValidateSprintf());
+	BenchChecks_Add(&checks, "Stack",                   BenchValidateStack());
+	return BenchChecks_Report(&checks, "Inline to heap, append, sprintf, stack and free");
+}
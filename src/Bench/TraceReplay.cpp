@@ -0,0 +1,283 @@
+// Replays a recorded Winjump session (see WinjumpTrace.h) against the core. Window tables are fed
+// through a source that serves the recorded snapshots and exes, and each recorded edit of the
+// search box is timed from the edit to the final result in the list, the same work
+// Winjump_Update() does per keystroke. The session is replayed with and without next character
+// speculation between keystrokes and reports the p50/p99/max keystroke-to-result latency and the
+// allocations per keystroke.
+//
+// Usage: winjump_trace_replay <trace>            Replay a trace recorded with Winjump -record-trace
+//        winjump_trace_replay -generate <trace>  Record a synthetic session to trace, then replay it
+#include "BenchCore.h"
+#include "../WinjumpTrace.h"
+
+#include <string.h>
+
+typedef struct ReplayExe
+{
+	u32     pid;
+	wchar_t exe[256];
+	i32     exeLen;
+} ReplayExe;
+
+typedef struct ReplaySource
+{
+	const WinjumpTrace      *trace;
+	const WinjumpTraceEvent *snapshot; // The table served to the core, NULL before the first one
+	DqnArray<ReplayExe>      exes;     // Last recorded exe of each pid, read only once replay starts
+} ReplaySource;
+
+////////////////////////////////////////////////////////////////////////////////
+// Replay Window Source
+////////////////////////////////////////////////////////////////////////////////
+FILE_SCOPE void ReplaySourceEnumerate(WinjumpWindowSource *const source, WinjumpCore *const core)
+{
+	ReplaySource *replay = (ReplaySource *)source->userData;
+	if (!replay->snapshot) return;
+
+	for (i32 i = 0; i < replay->snapshot->numWindows; i++)
+	{
+		const WinjumpTraceWindow *window = &replay->trace->windows.data[replay->snapshot->firstWindow + i];
+		if (!WinjumpCore_PushWindow(core, (WinjumpWindowHandle)(size_t)window->window, window->pid,
+		                            window->title, window->titleLen))
+			return;
+	}
+}
+
+// NOTE: Called from the exe resolve threads, the exe table is immutable by now
+FILE_SCOPE i32 ReplaySourceResolveExe(WinjumpWindowSource *const source, const u32 pid,
+                                      wchar_t *const exe, const i32 exeSize)
+{
+	ReplaySource *replay = (ReplaySource *)source->userData;
+	for (i32 i = 0; i < (i32)replay->exes.count; i++)
+	{
+		const ReplayExe *entry = &replay->exes.data[i];
+		if (entry->pid != pid) continue;
+
+		i32 result = DQN_MIN(entry->exeLen, exeSize - 1);
+		memcpy(exe, entry->exe, result * sizeof(wchar_t));
+		exe[result] = 0;
+		return result;
+	}
+
+	return 0;
+}
+
+// return: FALSE if out of memory.
+FILE_SCOPE bool ReplaySourceInit(ReplaySource *const replay, WinjumpWindowSource *const source,
+                                 const WinjumpTrace *const trace)
+{
+	*replay       = {};
+	replay->trace = trace;
+	if (!DqnArray_Init(&replay->exes, 64)) return false;
+
+	for (i32 i = 0; i < (i32)trace->events.count; i++)
+	{
+		const WinjumpTraceEvent *event = &trace->events.data[i];
+		if (event->type != WinjumpTraceRecord_Exe) continue;
+
+		ReplayExe *entry = NULL;
+		for (i32 j = 0; !entry && j < (i32)replay->exes.count; j++)
+		{
+			if (replay->exes.data[j].pid == event->pid) entry = &replay->exes.data[j];
+		}
+
+		if (!entry) entry = DqnArray_Push(&replay->exes, ReplayExe{});
+		if (!entry) return false;
+
+		entry->pid    = event->pid;
+		entry->exeLen = event->textLen;
+		memcpy(entry->exe, event->text, sizeof(entry->exe));
+	}
+
+	*source            = {};
+	source->Enumerate  = ReplaySourceEnumerate;
+	source->ResolveExe = ReplaySourceResolveExe;
+	source->userData   = replay;
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Replay
+////////////////////////////////////////////////////////////////////////////////
+// Apply each event of the trace to a fresh core in order.
+// speculate: Run the next character speculation before each keystroke, like the event loop when idle
+// return:    FALSE if out of memory.
+FILE_SCOPE bool ReplayTrace(const WinjumpTrace *const trace, WinjumpCore *const core, const bool speculate,
+                            BenchTimings *const timings, f32 *const hitRate)
+{
+	ReplaySource replay        = {};
+	WinjumpWindowSource source = {};
+	BenchListView benchView    = {};
+	WinjumpListView view       = {};
+	BenchViewInit(&benchView, &view);
+	if (!ReplaySourceInit(&replay, &source, trace)) return false;
+	if (!WinjumpCore_Init(core, &source)) return false;
+
+	bool result        = true;
+	wchar_t query[256] = {};
+	i32 queryLen       = 0;
+	for (i32 i = 0; result && i < (i32)trace->events.count; i++)
+	{
+		const WinjumpTraceEvent *event = &trace->events.data[i];
+		switch (event->type)
+		{
+			// NOTE: A window event makes the app update, which enumerates unless the search is in
+			// progress. Exes are settled straight away so the keystrokes measure filtering, not
+			// how quickly the jobs happened to run.
+			case WinjumpTraceRecord_Snapshot:
+			{
+				replay.snapshot = event;
+				core->enumerateSchedule.windowsChanged = true;
+				result = BenchUpdate(core, &view, query, queryLen, NULL);
+				DqnJobQueue_BlockAndCompleteAllJobs(&core->jobQueue);
+				result = result && BenchUpdate(core, &view, query, queryLen, NULL);
+			}
+			break;
+
+			case WinjumpTraceRecord_Query:
+			{
+				if (speculate) WinjumpCore_SpeculateNextChars(core);
+
+				queryLen = event->textLen;
+				memcpy(query, event->text, sizeof(query));
+				result = BenchUpdate(core, &view, query, queryLen, timings);
+			}
+			break;
+
+			default: break;
+		}
+	}
+
+	u32 numGuesses = core->speculation.numHits + core->speculation.numMisses;
+	*hitRate       = (numGuesses > 0) ? ((core->speculation.numHits * 100.0f) / numGuesses) : 0;
+
+	WinjumpCore_Free(core);
+	DqnArray_Free(&replay.exes);
+	return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Synthetic Session
+////////////////////////////////////////////////////////////////////////////////
+#define GENERATE_NUM_WINDOWS 1000
+
+FILE_SCOPE const wchar_t *const GENERATE_QUERIES[] = {
+    L"firefox", L"meeting notes", L"code.exe", L"sett", L"review - slack", L"zzz",
+};
+
+// Record typing and deleting each query over a synthetic window table that churns in between, for
+// trying the replay without a recording from Windows.
+// return: FALSE if out of memory or the trace could not be written.
+FILE_SCOPE bool GenerateTrace(const char *const path, WinjumpCore *const core)
+{
+	BenchWindowSource benchSource = {};
+	WinjumpWindowSource source    = {};
+	BenchListView benchView       = {};
+	WinjumpListView view          = {};
+	BenchViewInit(&benchView, &view);
+	if (!BenchSourceInit(&benchSource, &source, 0x5eed)) return false;
+	BenchSourceResize(&benchSource, GENERATE_NUM_WINDOWS);
+
+	LOCAL_PERSIST WinjumpTraceRecorder recorder;
+	if (!WinjumpTraceRecorder_Init(&recorder, &source)) return false;
+	if (!WinjumpCore_Init(core, &recorder.source)) return false;
+
+	bool result = true;
+	for (i32 queryIndex = 0; result && queryIndex < DQN_ARRAY_COUNT(GENERATE_QUERIES); queryIndex++)
+	{
+		BenchSourceChurn(&benchSource, 5);
+		core->enumerateSchedule.windowsChanged = true;
+		result = BenchUpdate(core, &view, L"", 0, NULL);
+		DqnJobQueue_BlockAndCompleteAllJobs(&core->jobQueue);
+
+		const wchar_t *query = GENERATE_QUERIES[queryIndex];
+		i32 queryLen         = DqnWStr_Len(query);
+		for (i32 len = 1; result && len <= queryLen; len++)
+		{
+			WinjumpTraceRecorder_RecordQuery(&recorder, query, len);
+			result = BenchUpdate(core, &view, query, len, NULL);
+		}
+
+		for (i32 len = queryLen - 1; result && len >= 0; len--)
+		{
+			WinjumpTraceRecorder_RecordQuery(&recorder, query, len);
+			result = BenchUpdate(core, &view, query, len, NULL);
+		}
+	}
+
+	WinjumpCore_Free(core);
+	result = result && WinjumpTraceRecorder_Write(&recorder, path);
+	WinjumpTraceRecorder_Free(&recorder);
+	DqnArray_Free(&benchSource.windows);
+	return result;
+}
+
+int main(int argc, char *argv[])
+{
+	// NOTE: Each core starts its own exe resolve threads which are never joined, so every run gets
+	// its own core.
+	LOCAL_PERSIST WinjumpCore generateCore, cores[2];
+	const char *path = NULL;
+	if (argc == 2)
+	{
+		path = argv[1];
+	}
+	else if (argc == 3 && strcmp(argv[1], "-generate") == 0)
+	{
+		path = argv[2];
+		if (!GenerateTrace(path, &generateCore))
+		{
+			printf("Could not record a synthetic session to %s\n", path);
+			return 1;
+		}
+	}
+	else
+	{
+		printf("Usage: winjump_trace_replay <trace>\n");
+		printf("       winjump_trace_replay -generate <trace>\n");
+		return 1;
+	}
+
+	LOCAL_PERSIST WinjumpTrace trace;
+	if (!WinjumpTrace_Read(&trace, path))
+	{
+		printf("Could not read trace %s\n", path);
+		return 1;
+	}
+
+	i32 numSnapshots = 0, numExes = 0, numQueries = 0;
+	for (i32 i = 0; i < (i32)trace.events.count; i++)
+	{
+		switch (trace.events.data[i].type)
+		{
+			case WinjumpTraceRecord_Snapshot: numSnapshots++; break;
+			case WinjumpTraceRecord_Exe:      numExes++;      break;
+			case WinjumpTraceRecord_Query:    numQueries++;   break;
+			default: break;
+		}
+	}
+
+	f64 durationMs = (trace.events.count > 0) ? trace.events.data[trace.events.count - 1].timeMs : 0;
+	printf("Winjump Trace Replay\n");
+	printf("%s: %.1fs, %d snapshots, %d exes, %d keystrokes\n", path, durationMs / 1000.0, numSnapshots,
+	       numExes, numQueries);
+
+	LOCAL_PERSIST BenchTimings typing, speculated;
+	f32 hitRate = 0, speculatedHitRate = 0;
+	bool result = ReplayTrace(&trace, &cores[0], false, &typing, &hitRate);
+	result      = result && ReplayTrace(&trace, &cores[1], true, &speculated, &speculatedHitRate);
+	if (!result)
+	{
+		printf("Replay ran out of memory\n");
+		WinjumpTrace_Free(&trace);
+		return 1;
+	}
+
+	printf("\n                              p50      p99      max\n");
+	BenchTimingsPrint("Keystroke", &typing);
+	BenchTimingsPrint("Keystroke, speculated", &speculated);
+	printf("  Speculation hits:      %d%%\n", (i32)speculatedHitRate);
+
+	WinjumpTrace_Free(&trace);
+	return 0;
+}
@@ -0,0 +1,35 @@
+@REM Build the benchmarks for Visual Studio compiler. Run your copy of vcvars32.bat or vcvarsall.bat to setup command-line compiler.
+@echo OFF
+
+REM Check if build tool is on path
+REM >nul, 2>nul will remove the output text from the where command
+where cl.exe >nul 2>nul
+if %errorlevel%==1 (
+	echo MSVC CL not on path, please add it to path to build by command line.
+	goto end
+)
+
+REM Drop compilation files into build folder
+IF NOT EXIST ..\..\bin mkdir ..\..\bin
+pushd ..\..\bin
+
+REM Benchmarks are built optimised, O2 maximise speed
+set compileFlags=-EHa- -GR- -Oi -MT -Z7 -W4 -WX -wd4100 -wd4201 -wd4189 -wd4505 -O2
+
+cl %compileFlags% ..\src\Bench\JobGraphBench.cpp /link -subsystem:CONSOLE /nologo /OUT:"jobgraph_bench.exe"
+cl %compileFlags% ..\src\Bench\ArrayBench.cpp /link -subsystem:CONSOLE /nologo /OUT:"array_bench.exe"
+REM The std::unordered_map baseline needs exception handling on, the STL headers raise C4530 without it
+cl %compileFlags% -EHsc ..\src\Bench\HashMapBench.cpp /link -subsystem:CONSOLE /nologo /OUT:"hashmap_bench.exe"
+cl %compileFlags% ..\src\Bench\MemPoolBench.cpp /link -subsystem:CONSOLE /nologo /OUT:"mempool_bench.exe"
+cl %compileFlags% ..\src\Bench\MemStackBench.cpp /link -subsystem:CONSOLE /nologo /OUT:"memstack_bench.exe"
+cl %compileFlags% ..\src\Bench\MemStackConcurrentBench.cpp /link -subsystem:CONSOLE /nologo /OUT:"memstack_concurrent_bench.exe"
+cl %compileFlags% ..\src\Bench\StringBench.cpp /link -subsystem:CONSOLE /nologo /OUT:"string_bench.exe"
+cl %compileFlags% ..\src\Bench\CoreBench.cpp ..\src\UnityBuild\CoreUnityBuild.cpp /link -subsystem:CONSOLE /nologo /OUT:"winjump_core_bench.exe" Advapi32.lib
+cl %compileFlags% ..\src\Bench\TraceReplay.cpp ..\src\UnityBuild\CoreUnityBuild.cpp /link -subsystem:CONSOLE /nologo /OUT:"winjump_trace_replay.exe" Advapi32.lib
+cl %compileFlags% ..\src\Bench\SoakBench.cpp ..\src\UnityBuild\CoreUnityBuild.cpp /link -subsystem:CONSOLE /nologo /OUT:"winjump_soak.exe" Psapi.lib Advapi32.lib
+cl %compileFlags% ..\src\Bench\DaemonBench.cpp ..\src\UnityBuild\CoreUnityBuild.cpp /link -subsystem:CONSOLE /nologo /OUT:"winjump_daemon_bench.exe" Advapi32.lib
+cl %compileFlags% ..\src\Bench\SharedTableBench.cpp ..\src\UnityBuild\CoreUnityBuild.cpp /link -subsystem:CONSOLE /nologo /OUT:"winjump_shared_table_bench.exe" Advapi32.lib
+
+popd
+
+:end
@@ -137,12 +137,7 @@ HFONT Config_ReadFromDisk(WinjumpState *state)
 		if (RegisterHotKey(client, WIN32_GUID_HOTKEY_ACTIVATE_APP, hotkey.win32ModifierKey,
 		                   hotkey.win32VirtualKey))
 		{
-			char hotkeyString[32] = {};
-			Winjump_HotkeyToString(hotkey, hotkeyString, DQN_ARRAY_COUNT(hotkeyString));
-
-			char newWindowTitle[256] = {};
-			Dqn_sprintf(newWindowTitle, "Winjump | Press %s to activate Winjump", hotkeyString);
-			SetWindowText(state->window[WinjumpWindow_MainClient].handle, newWindowTitle);
+			Winjump_SetActivateTitle(client, hotkey);
 		}
 		else
 		{
@@ -200,27 +195,30 @@ void Config_WriteToDisk(WinjumpState *state)
 	////////////////////////////////////////////////////////////////////////
 	LOGFONTW logFont = {};
 	GetObjectW(state->font, sizeof(logFont), &logFont);
-	// NOTE: The maximum number of bytes a utf-8 character can be is 4.
-	// Since we are using wchar_t with Windows, but utf-8 elsewhere, and in
+	// NOTE: Since we are using wchar_t with Windows, but utf-8 elsewhere, and in
 	// the ini code, we need to convert wchar safely to utf8 before storing.
-	i32 fontNameMaxLen    = LF_FACESIZE * 4;
-	char *fontName        = (char *)calloc(1, fontNameMaxLen);
+	// Measure it first, typical font names like "Tahoma" fit inline without allocating.
+	DqnString fontName    = {};
+	i32 fontNameLen       = WideCharToMultiByte(CP_UTF8, 0, logFont.lfFaceName, -1, NULL, 0, NULL, NULL) - 1;
 	bool fontNameNotValid = false;
-	if (!fontName)
+	if (fontNameLen < 0 || !DqnString_Reserve(&fontName, fontNameLen))
 	{
 		OutputDebugString(
-		    "calloc() failed: Not enough memory, FontName will not be "
+		    "DqnString_Reserve() failed: Not enough memory, FontName will not be "
 		    "stored to config file");
 		fontNameNotValid = true;
 	}
-
-	if (!DqnWin32_WCharToUTF8(logFont.lfFaceName, fontName, fontNameMaxLen))
+	else if (!DqnWin32_WCharToUTF8(logFont.lfFaceName, fontName.Str(), fontNameLen + 1))
 	{
 		OutputDebugString(
 		    "DqnWin32_wchar_to_utf8() failed: FontName will not be stored "
 		    "to config file");
 		fontNameNotValid = true;
 	}
+	else
+	{
+		fontName.len = fontNameLen;
+	}
 
 	i32 fontHeight         = (i32)logFont.lfHeight;
 	i32 fontWeight         = (i32)logFont.lfWeight;
@@ -252,6 +250,7 @@ void Config_WriteToDisk(WinjumpState *state)
 			OutputDebugString(
 			    "DqnFile_Open() failed: Platform was unable to create "
 			    "config file on disk");
+			DqnString_Free(&fontName);
 			return;
 		}
 	}
@@ -259,36 +258,31 @@ void Config_WriteToDisk(WinjumpState *state)
 	////////////////////////////////////////////////////////////////////////
 	// Create INI intermedia representation
 	////////////////////////////////////////////////////////////////////////
-	DqnIni *ini = NULL;
-	if (config.size == 0)
-	{
-		// TODO(doyle): We have created an abstraction above the INI layer
-		// which will automatically resolve whether or not the property
-		// exists in the INI file. But if the config size is 0, then we know
-		// that all these properties must be written. So there's a small
-		// overhead in this case where our abstraction will check to see if
-		// the property exists when it's unecessary.
-		ini = DqnIni_Create(NULL);
-	}
-	else
+	// NOTE: The file was just cleared or created so it's always empty, every property is written
+	// into a fresh ini.
+	// TODO(doyle): We have created an abstraction above the INI layer
+	// which will automatically resolve whether or not the property
+	// exists in the INI file. But since the file is empty, we know
+	// that all these properties must be written. So there's a small
+	// overhead where our abstraction will check to see if the property
+	// exists when it's unecessary.
+	DqnIni *ini = DqnIni_Create(NULL);
+	if (!ini)
 	{
-		u8 *data = (u8 *)calloc(1, (size_t)config.size);
-		if (!data)
-		{
-			OutputDebugString(
-			    "calloc() failed: Not enough memory. Exiting without "
-			    "saving configuration file.");
-			return;
-		}
+		OutputDebugString(
+		    "DqnIni_Create() failed: Not enough memory. Exiting without "
+		    "saving configuration file.");
+		DqnFile_Close(&config);
+		DqnString_Free(&fontName);
+		return;
 	}
-	DQN_ASSERT(ini);
 
 	////////////////////////////////////////////////////////////////////////////
 	// Write Font Data
 	////////////////////////////////////////////////////////////////////////////
 	if (!fontNameNotValid)
 	{
-		WriteToIniString(ini, GLOBAL_STRING_INI_FONT_NAME, fontName);
+		WriteToIniString(ini, GLOBAL_STRING_INI_FONT_NAME, fontName.Str());
 	}
 
 	WriteToIniInt(ini, GLOBAL_STRING_INI_FONT_HEIGHT,           fontHeight);
@@ -312,7 +306,16 @@ void Config_WriteToDisk(WinjumpState *state)
 	////////////////////////////////////////////////////////////////////////
 	i32 requiredSize   = DqnIni_Save(ini, NULL, 0);
 	u8 *dataToWriteOut = (u8 *)calloc(1, requiredSize);
-	DqnIni_Save(ini, (char *)dataToWriteOut, requiredSize);
-	DqnFile_Write(&config, dataToWriteOut, requiredSize, 0);
+	if (dataToWriteOut)
+	{
+		DqnIni_Save(ini, (char *)dataToWriteOut, requiredSize);
+		DqnFile_Write(&config, dataToWriteOut, requiredSize, 0);
+		free(dataToWriteOut);
+	}
+
+	// NOTE: The config is flushed periodically, so release everything for the next write
+	DqnIni_Destroy(ini);
+	DqnFile_Close(&config);
+	DqnString_Free(&fontName);
 }
 
@@ -0,0 +1,147 @@
+#include "Profiler.h"
+
+#define DQN_PLATFORM_HEADER
+#include "dqn.h"
+
+#if WINJUMP_PROFILER
+FILE_SCOPE const char *const PROFILER_ZONE_NAMES[] = {
+    "Enumerate",
+    "ResolveProcess",
+    "Filter",
+    "ListSync",
+    "StatusBar",
+    "Speculate",
+    "HotkeyToVisible",
+};
+DQN_COMPILE_ASSERT(DQN_ARRAY_COUNT(PROFILER_ZONE_NAMES) == ProfilerZone_Count);
+
+typedef struct ProfilerEvent
+{
+	f64          startMs;
+	f32          durationMs;
+	ProfilerZone zone;
+} ProfilerEvent;
+
+// NOTE: Process resolution records one event per window, so this holds a few seconds of frames for
+// a typical desktop before wrapping.
+#define PROFILER_RING_SIZE 4096
+FILE_SCOPE struct Profiler
+{
+	ProfilerEvent ring[PROFILER_RING_SIZE];
+	u32           writeIndex;
+	u32           count;
+} globalProfiler;
+
+void Profiler_Record(const ProfilerZone zone, const f64 startMs, const f64 endMs)
+{
+	ProfilerEvent *event = &globalProfiler.ring[globalProfiler.writeIndex];
+	event->startMs       = startMs;
+	event->durationMs    = (f32)(endMs - startMs);
+	event->zone          = zone;
+
+	globalProfiler.writeIndex = (globalProfiler.writeIndex + 1) % PROFILER_RING_SIZE;
+	if (globalProfiler.count < PROFILER_RING_SIZE) globalProfiler.count++;
+}
+
+ProfilerScopedZone::ProfilerScopedZone(const ProfilerZone zone_)
+{
+	this->zone    = zone_;
+	this->startMs = DqnTimer_NowInMs();
+}
+
+ProfilerScopedZone::~ProfilerScopedZone()
+{
+	Profiler_Record(this->zone, this->startMs, DqnTimer_NowInMs());
+}
+
+FILE_SCOPE bool ProfilerInternal_F32IsLessThan(const void *const val1, const void *const val2)
+{
+	bool result = (*(const f32 *)val1) < (*(const f32 *)val2);
+	return result;
+}
+
+void Profiler_GetZoneStats(ProfilerZoneStats *const stats)
+{
+	if (!stats) return;
+
+	LOCAL_PERSIST f32 durations[PROFILER_RING_SIZE];
+	for (i32 zone = 0; zone < ProfilerZone_Count; zone++)
+	{
+		u32 numDurations = 0;
+		for (u32 i = 0; i < globalProfiler.count; i++)
+		{
+			const ProfilerEvent *event = &globalProfiler.ring[i];
+			if (event->zone == zone) durations[numDurations++] = event->durationMs;
+		}
+
+		ProfilerZoneStats *result = &stats[zone];
+		result->numSamples        = numDurations;
+		if (numDurations == 0)
+		{
+			result->p50Ms = 0;
+			result->p99Ms = 0;
+			continue;
+		}
+
+		Dqn_QuickSort(durations, numDurations, ProfilerInternal_F32IsLessThan);
+		result->p50Ms = durations[(u32)((numDurations - 1) * 0.50f)];
+		result->p99Ms = durations[(u32)((numDurations - 1) * 0.99f)];
+	}
+}
+
+i32 Profiler_ZoneStatsToString(const ProfilerZoneStats *const stats, char *const buf,
+                               const i32 bufSize)
+{
+	if (!stats || !buf || bufSize <= 0) return 0;
+
+	i32 len = 0;
+	buf[0]  = 0;
+	for (i32 zone = 0; zone < ProfilerZone_Count && len < bufSize; zone++)
+	{
+		if (stats[zone].numSamples == 0) continue;
+		len += Dqn_snprintf(buf + len, bufSize - len, "%s%s %.2f/%.2f", (len > 0) ? " " : "",
+		                    PROFILER_ZONE_NAMES[zone], stats[zone].p50Ms, stats[zone].p99Ms);
+	}
+
+	return DQN_MIN(len, bufSize - 1);
+}
+
+bool Profiler_WriteChromeTrace(const char *const path)
+{
+	// NOTE: Each event is ~100 characters, so this is generous
+	const size_t MAX_EVENT_LEN = 160;
+	size_t bufSize             = 64 + (globalProfiler.count * MAX_EVENT_LEN);
+	char *buf                  = (char *)DqnMem_Alloc(bufSize);
+	if (!buf) return false;
+
+	// NOTE: Walk the ring from oldest to newest. Trace timestamps are in microseconds.
+	char *bufPtr = buf;
+	bufPtr += Dqn_sprintf(bufPtr, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+	u32 oldestIndex = (globalProfiler.writeIndex + PROFILER_RING_SIZE - globalProfiler.count) % PROFILER_RING_SIZE;
+	for (u32 i = 0; i < globalProfiler.count; i++)
+	{
+		const ProfilerEvent *event = &globalProfiler.ring[(oldestIndex + i) % PROFILER_RING_SIZE];
+		bufPtr += Dqn_sprintf(
+		    bufPtr,
+		    "{\"name\":\"%s\",\"cat\":\"winjump\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}%s\n",
+		    PROFILER_ZONE_NAMES[event->zone], event->startMs * 1000.0, event->durationMs * 1000.0,
+		    (i + 1 < globalProfiler.count) ? "," : "");
+	}
+	bufPtr += Dqn_sprintf(bufPtr, "]}\n");
+	DQN_ASSERT((size_t)(bufPtr - buf) < bufSize);
+
+	bool result  = false;
+	DqnFile file = {};
+	if (DqnFile_Open(path, &file, DqnFilePermissionFlag_Write, DqnFileAction_ClearIfExist) ||
+	    DqnFile_Open(path, &file, DqnFilePermissionFlag_Write, DqnFileAction_CreateIfNotExist))
+	{
+		size_t bytesToWrite = (size_t)(bufPtr - buf);
+		result              = (DqnFile_Write(&file, (u8 *)buf, bytesToWrite, 0) == bytesToWrite);
+		DqnFile_Close(&file);
+	}
+
+	DqnMem_Free(buf);
+	return result;
+}
+#endif // WINJUMP_PROFILER
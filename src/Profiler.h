@@ -0,0 +1,71 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "dqn.h"
+
+// Per-phase frame profiler. Timing zones are recorded into a fixed size ring which can be
+// summarised as p50/p99 per zone or dumped as a Chrome trace-event JSON file for chrome://tracing
+// or Perfetto.
+
+// Set to 0 to compile the profiler out, zones then expand to nothing.
+#ifndef WINJUMP_PROFILER
+	#define WINJUMP_PROFILER 1
+#endif
+
+enum ProfilerZone
+{
+	ProfilerZone_Enumerate,      // EnumWindows() and friendly name resolution
+	ProfilerZone_ResolveProcess, // Reusing or queueing each window's exe lookup, nested in Enumerate
+	ProfilerZone_Filter,
+	ProfilerZone_ListSync,       // Diffing the program array against the list box
+	ProfilerZone_StatusBar,
+	ProfilerZone_Speculate,      // Precomputing results for likely next characters whilst idle
+	ProfilerZone_HotkeyToVisible, // WM_HOTKEY being posted until the restored window has painted
+	ProfilerZone_Count,
+};
+
+typedef struct ProfilerZoneStats
+{
+	f32 p50Ms;
+	f32 p99Ms;
+	u32 numSamples;
+} ProfilerZoneStats;
+
+#if WINJUMP_PROFILER
+// NOTE: Zones must only be recorded from the main thread.
+void Profiler_Record(const ProfilerZone zone, const f64 startMs, const f64 endMs);
+
+struct ProfilerScopedZone
+{
+	ProfilerScopedZone(const ProfilerZone zone_);
+	~ProfilerScopedZone();
+
+private:
+	ProfilerZone zone;
+	f64          startMs;
+};
+
+#define PROFILER_ZONE_NAME_INTERNAL2(line) profilerZone_##line
+#define PROFILER_ZONE_NAME_INTERNAL(line)  PROFILER_ZONE_NAME_INTERNAL2(line)
+#define PROFILER_ZONE(zone) ProfilerScopedZone PROFILER_ZONE_NAME_INTERNAL(__LINE__)(zone)
+
+// stats:  Pass in an array of ProfilerZone_Count elements to fill out from the samples in the ring.
+void Profiler_GetZoneStats(ProfilerZoneStats *const stats);
+
+// Formats "<zone> <p50>/<p99>" for each zone that has samples.
+// return: The length of the string written to buf.
+i32 Profiler_ZoneStatsToString(const ProfilerZoneStats *const stats, char *const buf, const i32 bufSize);
+
+// Write all events in the ring to path in the Chrome trace-event format.
+// return: FALSE if out of memory or the file could not be written.
+bool Profiler_WriteChromeTrace(const char *const path);
+
+#else
+#define PROFILER_ZONE(zone)
+inline void Profiler_Record(const ProfilerZone, const f64, const f64) {}
+inline void Profiler_GetZoneStats(ProfilerZoneStats *const) {}
+inline i32  Profiler_ZoneStatsToString(const ProfilerZoneStats *const, char *const, const i32) { return 0; }
+inline bool Profiler_WriteChromeTrace(const char *const) { return false; }
+#endif // WINJUMP_PROFILER
+
+#endif
@@ -0,0 +1,15 @@
+// The platform independent core without the Win32 front end, for the benchmarks and any other
+// platform dqn.h supports.
+#include "../WinjumpCore.cpp"
+#include "../WinjumpTrace.cpp"
+#include "../WinjumpDaemon.cpp"
+#include "../WinjumpSharedTable.cpp"
+#include "../Profiler.cpp"
+
+#if defined(_WIN32)
+	#define DQN_WIN32_IMPLEMENTATION 1
+#else
+	#define DQN_UNIX_IMPLEMENTATION 1
+#endif
+#define DQN_IMPLEMENTATION 1
+#include "../dqn.h"
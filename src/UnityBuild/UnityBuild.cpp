@@ -1,5 +1,10 @@
 #include "..\Winjump.cpp"
+#include "..\WinjumpCore.cpp"
+#include "..\WinjumpTrace.cpp"
+#include "..\WinjumpDaemon.cpp"
+#include "..\WinjumpSharedTable.cpp"
 #include "..\Config.cpp"
+#include "..\Profiler.cpp"
 
 #define DQN_WIN32_IMPLEMENTATION 1
 #define DQN_IMPLEMENTATION 1
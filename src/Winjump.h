@@ -4,21 +4,10 @@
 #define VC_EXTRALEAN 1
 #define WIN32_LEAN_AND_MEAN 1
 #include <Windows.h>
-#include "dqn.h"
-
-struct Win32Program
-{
-	wchar_t title[256];
-	i32     titleLen;
-
-	wchar_t exe[256];
-	i32     exeLen;
-
-	HWND    window;
-	DWORD   pid;
-
-	i32 lastStableIndex;
-};
+#include "WinjumpCore.h"
+#include "WinjumpTrace.h"
+#include "WinjumpDaemon.h"
+#include "WinjumpSharedTable.h"
 
 enum WinjumpWindows
 {
@@ -50,23 +39,59 @@ struct AppHotkey
 	i32  win32ModifierKey = MOD_ALT; // Alt/Shift/Ctrl key
 };
 
+#define WINJUMP_WM_EXE_RESOLVED (WM_APP + 1) // Posted to the main window when an exe resolve job completes
+
+enum WinjumpLoopMode
+{
+	WinjumpLoopMode_Event, // Block until input, a hotkey, a window change or a scheduled refresh
+	WinjumpLoopMode_Poll,  // Update at a fixed frame rate and sleep the remainder
+};
+
 struct WinjumpState
 {
 	HFONT   font;
 	Win32Window window[WinjumpWindow_Count];
 
-	DqnArray<Win32Program>           programArray;
-	DqnArray<DqnArray<Win32Program>> programArraySnapshotStack;
+	// NOTE: The program table and filtering live in the core, Win32 supplies the windows and
+	// displays the results in the list box.
+	WinjumpCore         core;
+	WinjumpWindowSource windowSource;
+	WinjumpListView     listView;
+
+	// NOTE: Only with -record-trace, the recorder wraps windowSource and is written out on exit
+	WinjumpTraceRecorder traceRecorder;
+	bool                 isRecordingTrace;
+
+	// NOTE: Only with -daemon, the table is republished to the daemon after each update
+	WinjumpDaemon daemon;
+	bool          isDaemonRunning;
+
+	// NOTE: Only with -shared-table, the table is republished to shared memory after each update
+	WinjumpSharedTable sharedTable;
+	bool               isSharingTable;
 
-	bool isFilteringResults;
 	bool configIsStale;
-	i32  searchStringLen;
+
+	// NOTE: Periodic work is driven by the timer wheel so the loop can sleep until the next task
+	DqnTimerWheel     timerWheel;
+	DqnTimerWheelTask enumerateTask;      // Wakes the loop when the next enumeration is due
+	DqnTimerWheelTask memoryPollTask;     // Refreshes the memory usage in the status bar
+	DqnTimerWheelTask profilerStatusTask; // Refreshes the profiler timings in the status bar
+	DqnTimerWheelTask configFlushTask;    // Writes the config to disk a while after it goes stale
+
+	WinjumpLoopMode loopMode;
+	bool            updateRequested; // Set by input/window change events, cleared by the loop on update
 
 	AppHotkey appHotkey = {};
 };
 
 #define WIN32_GUID_HOTKEY_ACTIVATE_APP 10983
 
-u32 Winjump_HotkeyToString(AppHotkey hotkey, char *const buf, u32 bufSize);
+// The hotkey as text, i.e. "Alt-K", it's always short enough to be stored inline in str.
+// return: FALSE if str is NULL.
+bool Winjump_HotkeyToString(AppHotkey hotkey, DqnString *const str);
 bool Winjump_HotkeyIsValid(AppHotkey hotkey);
+
+// Set the window title to the prompt to press the hotkey.
+void Winjump_SetActivateTitle(HWND window, AppHotkey hotkey);
 #endif /* WINJUMP_H */
@@ -0,0 +1,1045 @@
+#include "WinjumpCore.h"
+#include "Profiler.h"
+
+#define DQN_PLATFORM_HEADER
+#include "dqn.h"
+
+FILE_SCOPE void WinjumpCore_SpeculationInvalidate(WinjumpCore *const core);
+
+FILE_SCOPE inline void WStrToLower(wchar_t *const str, const i32 len)
+{
+	for (i32 i = 0; i < len; i++) str[i] = DqnWChar_ToLower(str[i]);
+}
+
+// Append src to out, truncating to what fits.
+// return: The new length of out.
+FILE_SCOPE i32 WinjumpCore_WStrAppend(wchar_t *const out, i32 outLen, const i32 outSize,
+                                      const wchar_t *const src, const i32 srcLen)
+{
+	i32 numToCopy = DQN_MIN(srcLen, outSize - 1 - outLen);
+	if (numToCopy <= 0) return outLen;
+
+	memcpy(out + outLen, src, numToCopy * sizeof(wchar_t));
+	outLen      += numToCopy;
+	out[outLen]  = 0;
+	return outLen;
+}
+
+// Create the friendly name for representation in the list
+// - out: The output buffer
+// - outLen: Length of the output buffer
+// Returns the number of characters stored into the buffer
+FILE_SCOPE i32 WinjumpCore_GetProgramFriendlyName(const WinjumpProgram *program, wchar_t *out,
+                                                  i32 outLen)
+{
+	// Friendly Name Format
+	// <Index>: <Program Title> - <Program Exe>
+
+	// For example
+	// 1: Google Search - firefox.exe
+	// 2: Winjump.cpp + (C:\winjump.cpp) - GVIM64 - firefox.exe
+
+	// NOTE: Index is right aligned to 2 characters like "%2d", formatted by hand since wide
+	// printf differs between MSVC and the C standard.
+	wchar_t indexStr[16];
+	i32 indexLen = 0;
+	u32 index    = (u32)(program->lastStableIndex + 1);
+	do
+	{
+		indexStr[DQN_ARRAY_COUNT(indexStr) - 1 - indexLen++] = L'0' + (wchar_t)(index % 10);
+		index /= 10;
+	} while (index > 0);
+
+	i32 numStored = 0;
+	out[0]        = 0;
+	if (indexLen < 2) numStored = WinjumpCore_WStrAppend(out, numStored, outLen, L" ", 1);
+	numStored = WinjumpCore_WStrAppend(out, numStored, outLen, indexStr + DQN_ARRAY_COUNT(indexStr) - indexLen, indexLen);
+	numStored = WinjumpCore_WStrAppend(out, numStored, outLen, L": ", 2);
+	numStored = WinjumpCore_WStrAppend(out, numStored, outLen, program->title, program->titleLen);
+	numStored = WinjumpCore_WStrAppend(out, numStored, outLen, L" - ", 3);
+	numStored = WinjumpCore_WStrAppend(out, numStored, outLen, program->exe, program->exeLen);
+	return numStored;
+}
+
+i32 WinjumpCore_NumProgramsToDisplay(const WinjumpCore *const core)
+{
+	if (core->isFilteringResults) return core->filterCursor;
+	return (i32)core->programArray.count;
+}
+
+bool WinjumpCore_PushWindow(WinjumpCore *const core, const WinjumpWindowHandle window, const u32 pid,
+                            const wchar_t *const title, const i32 titleLen)
+{
+	DqnArray<WinjumpProgram> *programArray = &core->programArray;
+	WinjumpProgram *program = DqnArray_Push(programArray, WinjumpProgram{});
+	if (!program) return false;
+
+	// NOTE: The exe is resolved afterwards in WinjumpCore_ResolveProgramExes()
+	program->titleLen = DQN_MIN(titleLen, (i32)DQN_ARRAY_COUNT(program->title) - 1);
+	memcpy(program->title, title, program->titleLen * sizeof(wchar_t));
+	program->title[program->titleLen] = 0;
+
+	program->window          = window;
+	program->pid             = pid;
+	program->lastStableIndex = (i32)programArray->count - 1;
+	return true;
+}
+
+FILE_SCOPE bool
+WinjumpCore_ProgramArrayShallowCopyArrayInternal(DqnArray<WinjumpProgram> *src,
+                                                 DqnArray<WinjumpProgram> *dest,
+                                                 const DqnMemAPI memAPI)
+{
+	if (src && dest)
+	{
+		// NOTE: Once we take a snapshot, we stop enumerating windows, so we
+		// only need to allocate exactly array->count (at least 1, searches can match nothing)
+		if (DqnArray_Init(dest, DQN_MAX((size_t)src->count, (size_t)1), memAPI))
+		{
+			if (src->count == 0 || DqnArray_PushN(dest, src->data, src->count)) return true;
+		}
+	}
+
+	return false;
+}
+
+FILE_SCOPE bool
+WinjumpCore_ProgramArrayRestoreSnapshot(WinjumpCore *core, DqnArray<WinjumpProgram> *snapshot)
+{
+	bool result = WinjumpCore_ProgramArrayShallowCopyArrayInternal(snapshot, &core->programArray,
+	                                                               DqnMemAPI_DefaultUseCalloc());
+	return result;
+}
+
+// NOTE: The first snapshot is the full table and is kept as prevProgramArray when the next
+// enumeration drops the snapshots, so only the narrower snapshots after it go in the arena.
+FILE_SCOPE bool
+WinjumpCore_ProgramArrayCreateSnapshot(WinjumpCore *core, DqnArray<WinjumpProgram> *snapshot)
+{
+	DqnMemAPI memAPI = (core->programArraySnapshotStack.count == 0)
+	                       ? DqnMemAPI_DefaultUseCalloc()
+	                       : DqnMemAPI_StackAllocator(&core->snapshotArena);
+	bool result = WinjumpCore_ProgramArrayShallowCopyArrayInternal(&core->programArray, snapshot, memAPI);
+	return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Friendly Name Cache
+////////////////////////////////////////////////////////////////////////////////
+FILE_SCOPE size_t WinjumpCore_MemStackUsedBytes(const DqnMemStack *const stack)
+{
+	size_t result = 0;
+	for (DqnMemStackBlock *block = stack->block; block; block = block->prevBlock)
+		result += block->used;
+	return result;
+}
+
+// Free all blocks except the initial one and mark it empty
+FILE_SCOPE void WinjumpCore_MemStackReset(DqnMemStack *const stack)
+{
+	while (stack->block && stack->block->prevBlock)
+		DqnMemStack_FreeLastBlock(stack);
+	DqnMemStack_ClearCurrBlock(stack, false);
+}
+
+// Returns NULL if out of memory
+FILE_SCOPE wchar_t *WinjumpCore_FriendlyNameCopyToStack(DqnMemStack *const stack,
+                                                        const wchar_t *const src, const i32 len)
+{
+	wchar_t *result = (wchar_t *)DqnMemStack_Push(stack, (len + 1) * sizeof(wchar_t));
+	if (result)
+	{
+		memcpy(result, src, len * sizeof(wchar_t));
+		result[len] = 0;
+	}
+	return result;
+}
+
+// Windows enumerate in a mostly stable order, so check the same slot in the previous enumeration
+// before falling back to looking the window up. The lookup is only built once a window has moved.
+FILE_SCOPE const WinjumpProgram *WinjumpCore_FindPrevProgramByWindow(WinjumpCore *const core,
+                                                                     const WinjumpWindowHandle window,
+                                                                     const i32 hintIndex)
+{
+	const DqnArray<WinjumpProgram> *array = &core->prevProgramArray;
+	if (hintIndex < (i32)array->count && array->data[hintIndex].window == window)
+		return &array->data[hintIndex];
+
+	DqnHashMap<WinjumpWindowHandle, i32> *indexByWindow = &core->prevProgramIndexByWindow;
+	if (!core->prevProgramIndexIsBuilt)
+	{
+		DqnHashMap_Clear(indexByWindow);
+		bool built = DqnHashMap_Reserve(indexByWindow, array->count);
+		for (i32 i = 0; built && i < (i32)array->count; i++)
+		{
+			if (!DqnHashMap_Get(indexByWindow, array->data[i].window))
+				built = (DqnHashMap_Set(indexByWindow, array->data[i].window, i) != NULL);
+		}
+		core->prevProgramIndexIsBuilt = built;
+	}
+
+	if (core->prevProgramIndexIsBuilt)
+	{
+		i32 *index = DqnHashMap_Get(indexByWindow, window);
+		return (index) ? &array->data[*index] : NULL;
+	}
+
+	// NOTE: Out of memory for the lookup, scan instead
+	for (i32 i = 0; i < (i32)array->count; i++)
+	{
+		if (array->data[i].window == window) return &array->data[i];
+	}
+
+	return NULL;
+}
+
+FILE_SCOPE bool WinjumpCore_FriendlyNameIsStale(const WinjumpProgram *const prev,
+                                                const WinjumpProgram *const program)
+{
+	if (!prev->friendlyName)                              return true;
+	if (prev->lastStableIndex != program->lastStableIndex) return true;
+	if (prev->titleLen != program->titleLen)              return true;
+	if (prev->exeLen   != program->exeLen)                return true;
+
+	if (memcmp(prev->title, program->title, program->titleLen * sizeof(wchar_t)) != 0) return true;
+	if (memcmp(prev->exe,   program->exe,   program->exeLen   * sizeof(wchar_t)) != 0) return true;
+
+	return false;
+}
+
+// Assign friendly names to the freshly enumerated programArray, reusing the name from the
+// previous enumeration of the same window when nothing it is derived from has changed.
+// numChanged: Set to the number of programs that are new or had their name rebuilt.
+// return: FALSE if out of memory.
+FILE_SCOPE bool WinjumpCore_UpdateFriendlyNames(WinjumpCore *const core, i32 *const numChanged)
+{
+	DqnArray<WinjumpProgram> *programArray = &core->programArray;
+	DqnMemStack *stack = &core->friendlyNameStack[core->friendlyNameStackIndex];
+
+	// NOTE: Names are built in scratch and copied onto the arena at their final length
+	DqnScratchGuard scratch;
+	wchar_t *friendlyName = (wchar_t *)scratch.Push(WINJUMP_FRIENDLY_NAME_LEN * sizeof(wchar_t));
+	if (!friendlyName) return false;
+
+	*numChanged      = 0;
+	size_t liveBytes = 0;
+	for (i32 i = 0; i < (i32)programArray->count; i++)
+	{
+		WinjumpProgram *program    = &programArray->data[i];
+		const WinjumpProgram *prev = WinjumpCore_FindPrevProgramByWindow(core, program->window, i);
+
+		if (prev && !WinjumpCore_FriendlyNameIsStale(prev, program))
+		{
+			program->friendlyName    = prev->friendlyName;
+			program->friendlyNameLen = prev->friendlyNameLen;
+		}
+		else
+		{
+			i32 len = WinjumpCore_GetProgramFriendlyName(program, friendlyName, WINJUMP_FRIENDLY_NAME_LEN);
+
+			program->friendlyName    = WinjumpCore_FriendlyNameCopyToStack(stack, friendlyName, len);
+			program->friendlyNameLen = len;
+			if (!program->friendlyName) return false;
+			(*numChanged)++;
+		}
+
+		liveBytes += (program->friendlyNameLen + 1) * sizeof(wchar_t);
+	}
+
+	// NOTE: Compact once the arena is mostly garbage from windows that were closed or retitled.
+	// Only safe to do here since snapshots (which share these pointers) are freed before we
+	// enumerate.
+	const size_t COMPACT_MIN_BYTES = DQN_KILOBYTE(16);
+	size_t usedBytes = WinjumpCore_MemStackUsedBytes(stack);
+	if (usedBytes > COMPACT_MIN_BYTES && usedBytes > (liveBytes * 4))
+	{
+		i32 newIndex          = (core->friendlyNameStackIndex + 1) % DQN_ARRAY_COUNT(core->friendlyNameStack);
+		DqnMemStack *newStack = &core->friendlyNameStack[newIndex];
+		DQN_ASSERT(WinjumpCore_MemStackUsedBytes(newStack) == 0);
+
+		for (i32 i = 0; i < (i32)programArray->count; i++)
+		{
+			WinjumpProgram *program = &programArray->data[i];
+			program->friendlyName =
+			    WinjumpCore_FriendlyNameCopyToStack(newStack, program->friendlyName, program->friendlyNameLen);
+			if (!program->friendlyName) return false;
+		}
+
+		WinjumpCore_MemStackReset(stack);
+		core->friendlyNameStackIndex = newIndex;
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Exe Resolution
+////////////////////////////////////////////////////////////////////////////////
+FILE_SCOPE void WinjumpCore_ExeResolveJobCallback(DqnJobQueue *const queue, void *const userData)
+{
+	WinjumpExeResolveJob *job   = (WinjumpExeResolveJob *)userData;
+	WinjumpWindowSource *source = job->source;
+	job->exeLen = source->ResolveExe(source, job->pid, job->exe, DQN_ARRAY_COUNT(job->exe));
+
+	// NOTE: The atomic is a full barrier, the exe is visible before the main thread can claim it
+	DqnAtomic_CompareSwap32(&job->state, WinjumpExeResolveState_Done, WinjumpExeResolveState_Queued);
+	if (source->OnExeResolved) source->OnExeResolved(source);
+}
+
+FILE_SCOPE bool WinjumpCore_ExeResolveIsInFlight(const WinjumpCore *const core, const u32 pid)
+{
+	for (i32 i = 0; i < DQN_ARRAY_COUNT(core->exeResolveJobs); i++)
+	{
+		const WinjumpExeResolveJob *job = &core->exeResolveJobs[i];
+		if (job->state != WinjumpExeResolveState_Free && job->pid == pid) return true;
+	}
+
+	return false;
+}
+
+// return: FALSE if all job slots are in use.
+FILE_SCOPE bool WinjumpCore_ExeResolveSubmit(WinjumpCore *const core, const u32 pid)
+{
+	for (i32 i = 0; i < DQN_ARRAY_COUNT(core->exeResolveJobs); i++)
+	{
+		WinjumpExeResolveJob *job = &core->exeResolveJobs[i];
+		if (job->state != WinjumpExeResolveState_Free) continue;
+
+		job->pid    = pid;
+		job->source = core->windowSource;
+		job->state  = WinjumpExeResolveState_Queued;
+
+		DqnJob queueJob   = {};
+		queueJob.callback = WinjumpCore_ExeResolveJobCallback;
+		queueJob.userData = job;
+		bool result = DqnJobQueue_AddJob(&core->jobQueue, queueJob);
+		DQN_ASSERT(result); // NOTE: The queue has a slot for every job, so it can't be full
+		return result;
+	}
+
+	return false;
+}
+
+// Fill in the exe of each freshly enumerated program. Reuses the exe from the previous enumeration
+// of the same window or another window of the same process, otherwise queues a job to resolve it.
+FILE_SCOPE void WinjumpCore_ResolveProgramExes(WinjumpCore *const core)
+{
+	PROFILER_ZONE(ProfilerZone_ResolveProcess);
+	DqnArray<WinjumpProgram> *programArray = &core->programArray;
+	DqnHashMap_Clear(&core->programIndexByPid);
+	for (i32 i = 0; i < (i32)programArray->count; i++)
+	{
+		WinjumpProgram *program    = &programArray->data[i];
+		const WinjumpProgram *from = WinjumpCore_FindPrevProgramByWindow(core, program->window, i);
+		if (from && (from->pid != program->pid || from->exeIsPending)) from = NULL;
+
+		// NOTE: Otherwise reuse the first window of the same process seen so far. On OOM the process
+		// isn't remembered and its later windows resolve their own exe.
+		i32 *firstOfProcess = DqnHashMap_Get(&core->programIndexByPid, program->pid);
+		if (!from && firstOfProcess) from = &programArray->data[*firstOfProcess];
+		if (!firstOfProcess)         DqnHashMap_Set(&core->programIndexByPid, program->pid, i);
+
+		if (from)
+		{
+			memcpy(program->exe, from->exe, sizeof(program->exe));
+			program->exeLen       = from->exeLen;
+			program->exeIsPending = from->exeIsPending;
+			continue;
+		}
+
+		program->exeIsPending = true;
+		if (WinjumpCore_ExeResolveIsInFlight(core, program->pid)) continue;
+
+		if (!WinjumpCore_ExeResolveSubmit(core, program->pid))
+		{
+			// NOTE: Out of job slots, resolve on this thread
+			WinjumpWindowSource *source = core->windowSource;
+			program->exeLen       = source->ResolveExe(source, program->pid, program->exe, DQN_ARRAY_COUNT(program->exe));
+			program->exeIsPending = false;
+		}
+	}
+}
+
+// numApplied: Incremented for each program the exe was patched into
+FILE_SCOPE bool WinjumpCore_ApplyResolvedExe(WinjumpCore *const core, DqnArray<WinjumpProgram> *const array,
+                                             const WinjumpExeResolveJob *const job, i32 *const numApplied)
+{
+	DqnMemStack *stack = &core->friendlyNameStack[core->friendlyNameStackIndex];
+	DqnScratchGuard scratch;
+	wchar_t *friendlyName = (wchar_t *)scratch.Push(WINJUMP_FRIENDLY_NAME_LEN * sizeof(wchar_t));
+	if (!friendlyName) return false;
+
+	for (i32 i = 0; i < (i32)array->count; i++)
+	{
+		WinjumpProgram *program = &array->data[i];
+		if (!program->exeIsPending || program->pid != job->pid) continue;
+
+		memcpy(program->exe, job->exe, sizeof(program->exe));
+		program->exeLen       = job->exeLen;
+		program->exeIsPending = false;
+
+		i32 len = WinjumpCore_GetProgramFriendlyName(program, friendlyName, WINJUMP_FRIENDLY_NAME_LEN);
+		program->friendlyName    = WinjumpCore_FriendlyNameCopyToStack(stack, friendlyName, len);
+		program->friendlyNameLen = len;
+		if (!program->friendlyName) return false;
+		(*numApplied)++;
+	}
+
+	return true;
+}
+
+// NOTE: The search dropped programs whose exe was pending on their name without it, so filter again
+// from the full table. Narrower snapshots were taken from the same filter and are dropped with it.
+FILE_SCOPE bool WinjumpCore_FilterRestart(WinjumpCore *const core)
+{
+	DqnArray<DqnArray<WinjumpProgram>> *snapshotStack = &core->programArraySnapshotStack;
+	while (snapshotStack->count > 1)
+	{
+		DqnArray_Free(&snapshotStack->data[snapshotStack->count - 1]);
+		DqnArray_Pop(snapshotStack);
+	}
+
+	if (!WinjumpCore_ProgramArrayRestoreSnapshot(core, &snapshotStack->data[0])) return false;
+	core->filterCursor     = 0;
+	core->filterNumChecked = 0;
+	core->filterNumToCheck = (i32)core->programArray.count;
+	return true;
+}
+
+// Merge completed exe resolve jobs into the program array and filtering snapshots, so the results
+// stream into the list as they arrive. If a search is applied and the full table changed, the
+// search is filtered again from the start.
+// return: FALSE if out of memory.
+FILE_SCOPE bool WinjumpCore_MergeResolvedExes(WinjumpCore *const core)
+{
+	DqnArray<DqnArray<WinjumpProgram>> *snapshotStack = &core->programArraySnapshotStack;
+	i32 numApplied = 0;
+	for (i32 i = 0; i < DQN_ARRAY_COUNT(core->exeResolveJobs); i++)
+	{
+		WinjumpExeResolveJob *job = &core->exeResolveJobs[i];
+		if (job->state != WinjumpExeResolveState_Done) continue;
+
+		bool result = WinjumpCore_ApplyResolvedExe(core, &core->programArray, job, &numApplied);
+		for (i32 j = 0; result && j < snapshotStack->count; j++)
+			result = WinjumpCore_ApplyResolvedExe(core, &snapshotStack->data[j], job, &numApplied);
+
+		DqnAtomic_CompareSwap32(&job->state, WinjumpExeResolveState_Free, WinjumpExeResolveState_Done);
+		WinjumpCore_SpeculationInvalidate(core);
+		core->tableGeneration++;
+		if (!result) return false;
+	}
+
+	// NOTE: Every program filtered or dropped is also in the first snapshot, so any change means the
+	// full table changed
+	if (numApplied > 0 && core->searchStringLen > 0 && snapshotStack->count > 0)
+	{
+		if (!WinjumpCore_FilterRestart(core)) return false;
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Enumeration
+////////////////////////////////////////////////////////////////////////////////
+// Re-enumerate the windows into programArray, discarding any filtering snapshots.
+// return: FALSE if out of memory.
+FILE_SCOPE bool WinjumpCore_EnumeratePrograms(WinjumpCore *const core, bool *const windowSetChanged)
+{
+	PROFILER_ZONE(ProfilerZone_Enumerate);
+
+	// NOTE: Keep the last enumeration around so unchanged windows can reuse their friendly name and
+	// exe. If we were filtering, programArray is only the matches so use the first snapshot, which
+	// is the full list from before filtering started.
+	DqnArray<WinjumpProgram> *programArray = &core->programArray;
+	if (core->programArraySnapshotStack.count > 0)
+		DQN_SWAP(DqnArray<WinjumpProgram>, core->programArraySnapshotStack.data[0], core->prevProgramArray);
+	else
+		DQN_SWAP(DqnArray<WinjumpProgram>, core->programArray, core->prevProgramArray);
+	core->prevProgramIndexIsBuilt = false;
+
+	// NOTE: The rest of the snapshots are dropped with the arena
+	if (core->programArraySnapshotStack.count > 0) DqnArray_Free(&core->programArraySnapshotStack.data[0]);
+	DqnArray_Clear(&core->programArraySnapshotStack);
+	WinjumpCore_MemStackReset(&core->snapshotArena);
+
+	DqnArray_Clear(programArray);
+	core->windowSource->Enumerate(core->windowSource, core);
+	WinjumpCore_ResolveProgramExes(core);
+
+	i32 numChanged = 0;
+	if (!WinjumpCore_UpdateFriendlyNames(core, &numChanged)) return false;
+
+	*windowSetChanged = (numChanged > 0 || programArray->count != core->prevProgramArray.count);
+	return true;
+}
+
+f64 WinjumpCore_MsUntilEnumerateDue(const WinjumpCore *const core, const f64 now)
+{
+	const WinjumpEnumerateSchedule *schedule = &core->enumerateSchedule;
+	f64 dueTime = schedule->lastEnumerateTime + schedule->intervalMs;
+	if (schedule->windowsChanged)
+	{
+		// NOTE: Whilst hidden, a burst of window events is batched into one enumeration
+		if (!core->isHidden) return 0;
+		dueTime = schedule->lastEnumerateTime + WINJUMP_ENUMERATE_HIDDEN_BATCH_MS;
+	}
+
+	f64 result = DQN_MAX(dueTime - now, 0);
+	return result;
+}
+
+// Enumerate if due and adjust the interval. A change snaps the interval back to the minimum,
+// otherwise it doubles up to WINJUMP_ENUMERATE_MAX_INTERVAL_MS, or the hidden maximum whilst hidden.
+// force:  Enumerate even if not due, i.e. the list needs rebuilding
+// return: FALSE if out of memory.
+FILE_SCOPE bool WinjumpCore_EnumerateIfDue(WinjumpCore *const core, const bool force)
+{
+	WinjumpEnumerateSchedule *schedule = &core->enumerateSchedule;
+	f64 now = DqnTimer_NowInMs();
+	if (!force && WinjumpCore_MsUntilEnumerateDue(core, now) > 0) return true;
+
+	bool windowSetChanged = false;
+	if (!WinjumpCore_EnumeratePrograms(core, &windowSetChanged)) return false;
+
+	if (windowSetChanged)
+	{
+		schedule->intervalMs = WINJUMP_ENUMERATE_MIN_INTERVAL_MS;
+		core->tableGeneration++;
+	}
+	else
+	{
+		f64 maxIntervalMs = (core->isHidden) ? WINJUMP_ENUMERATE_HIDDEN_MAX_INTERVAL_MS
+		                                     : WINJUMP_ENUMERATE_MAX_INTERVAL_MS;
+		schedule->intervalMs = DQN_MIN(schedule->intervalMs * 2, maxIntervalMs);
+	}
+
+	schedule->lastEnumerateTime = now;
+	schedule->windowsChanged    = false;
+	return true;
+}
+
+void WinjumpCore_EnumerateScheduleReset(WinjumpCore *const core)
+{
+	core->enumerateSchedule.intervalMs = WINJUMP_ENUMERATE_MIN_INTERVAL_MS;
+}
+
+// NOTE: Whilst a search is applied programArray is only its matches, the first snapshot is the full
+// table from before filtering started.
+const DqnArray<WinjumpProgram> *WinjumpCore_GetProgramTable(const WinjumpCore *const core)
+{
+	if (core->programArraySnapshotStack.count > 0) return &core->programArraySnapshotStack.data[0];
+	return &core->programArray;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Filtering
+////////////////////////////////////////////////////////////////////////////////
+#define WINJUMP_FILTER_PROGRAMS_PER_TIME_CHECK 32
+
+i32 WinjumpCore_ParseSearchNumbers(const wchar_t *const newSearchStr, const i32 newSearchLen,
+                                   i32 *const userSpecifiedNumbers, const i32 maxNumbers)
+{
+	i32 userSpecifiedIndex = 0;
+	for (i32 j = 0; j < newSearchLen && newSearchStr[j]; j++)
+	{
+		if (DqnWChar_IsDigit(newSearchStr[j]))
+		{
+			i32 numberFoundInString =
+			    Dqn_WStrToI32(&newSearchStr[j], newSearchLen - j);
+
+			// However many number of digits, increment the search ptr,
+			// because there may be multiple numbers in the search string
+			i32 tmp = userSpecifiedIndex;
+			do
+			{
+				tmp /= 10;
+				j++;
+			} while (tmp > 0);
+
+			// NOTE: Really doubt anyone types more numbers than that, ignore the rest
+			if (userSpecifiedIndex == maxNumbers) break;
+
+			userSpecifiedNumbers[userSpecifiedIndex++] =
+			    numberFoundInString;
+		}
+	}
+
+	return userSpecifiedIndex;
+}
+
+bool WinjumpCore_FriendlyNameMatchesSearch(const wchar_t *const friendlyName, const i32 friendlyNameLen,
+                                           const i32 programIndex, const wchar_t *const searchStr,
+                                           const i32 searchLen, const i32 *const userSpecifiedNumbers,
+                                           const i32 numUserSpecifiedNumbers)
+{
+	for (i32 i = 0; i < numUserSpecifiedNumbers; i++)
+	{
+		// NOTE: Suppose we have indexes, 1 and 14. If 1 is input, we
+		// need both to remain in list entries. We can do this by
+		// eliminating digits from 14 by dividing by 10 until it
+		// matches.
+		i32 specifiedNumber = userSpecifiedNumbers[i];
+		i32 programIndexDigitCheck = programIndex;
+		do
+		{
+			if (specifiedNumber == programIndexDigitCheck) return true;
+			programIndexDigitCheck /= 10;
+		} while (programIndexDigitCheck > 0);
+	}
+
+	bool result = DqnWStr_HasSubstring(friendlyName, friendlyNameLen, searchStr, searchLen);
+	return result;
+}
+
+FILE_SCOPE bool WinjumpCore_ProgramMatchesSearch(const WinjumpProgram *const program,
+                                                 const wchar_t *const searchStr, const i32 searchLen,
+                                                 const i32 *const userSpecifiedNumbers,
+                                                 const i32 numUserSpecifiedNumbers)
+{
+	// NOTE: +1 to lastStableIndex since list displays elements starting
+	// from 1 and lastStableIndex is zero-based
+	bool result = WinjumpCore_FriendlyNameMatchesSearch(program->friendlyName, program->friendlyNameLen,
+	                                                    program->lastStableIndex + 1, searchStr, searchLen,
+	                                                    userSpecifiedNumbers, numUserSpecifiedNumbers);
+	return result;
+}
+
+struct WinjumpFilterState
+{
+	const wchar_t *searchStr;
+	i32            searchLen;
+	const i32     *userSpecifiedNumbers;
+	i32            numUserSpecifiedNumbers;
+	f64            endTime;
+	i32            numChecked;
+	i32            numMatched;
+	bool           isOutOfBudget;
+};
+
+// NOTE: Once the budget runs out every remaining program is kept unchecked, the remove pass still
+// moves them down to meet the matches.
+FILE_SCOPE bool WinjumpCore_FilterShouldRemove(const WinjumpProgram *const program, void *const userData)
+{
+	WinjumpFilterState *state = (WinjumpFilterState *)userData;
+	if (state->isOutOfBudget) return false;
+
+	if (state->numChecked % WINJUMP_FILTER_PROGRAMS_PER_TIME_CHECK == 0 && state->numChecked != 0 &&
+	    DqnTimer_NowInMs() >= state->endTime)
+	{
+		state->isOutOfBudget = true;
+		return false;
+	}
+
+	state->numChecked++;
+	bool result = !WinjumpCore_ProgramMatchesSearch(program, state->searchStr, state->searchLen,
+	                                                state->userSpecifiedNumbers,
+	                                                state->numUserSpecifiedNumbers);
+	if (!result) state->numMatched++;
+	return result;
+}
+
+// Remove programs that don't match the search, starting from core->filterCursor, in one stable
+// pass, so programArray is always [filtered matches][unchecked].
+// return: TRUE if the whole array has been filtered.
+FILE_SCOPE bool WinjumpCore_FilterPrograms(WinjumpCore *const core, const wchar_t *const searchStr,
+                                           const i32 searchLen, const i32 *const userSpecifiedNumbers,
+                                           const i32 numUserSpecifiedNumbers, const f64 budgetInMs)
+{
+	WinjumpFilterState state      = {};
+	state.searchStr               = searchStr;
+	state.searchLen               = searchLen;
+	state.userSpecifiedNumbers    = userSpecifiedNumbers;
+	state.numUserSpecifiedNumbers = numUserSpecifiedNumbers;
+	state.endTime                 = DqnTimer_NowInMs() + budgetInMs;
+
+	DqnArray_RemoveIf(&core->programArray, WinjumpCore_FilterShouldRemove, &state, (u64)core->filterCursor);
+	core->filterCursor     += state.numMatched;
+	core->filterNumChecked += state.numChecked;
+
+	bool result = !state.isOutOfBudget;
+	return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Next Character Speculation
+////////////////////////////////////////////////////////////////////////////////
+// NOTE: Speculation runs once per search string and gives up on any entry that doesn't finish
+// within the budget, so a huge candidate set costs at most this much per keystroke.
+#define WINJUMP_SPECULATION_BUDGET_MS 1.0
+
+FILE_SCOPE void WinjumpCore_SpeculationInvalidate(WinjumpCore *const core)
+{
+	WinjumpSpeculationState *speculation = &core->speculation;
+	for (i32 i = 0; i < speculation->numEntries; i++)
+		DqnArray_Clear(&speculation->entries[i].programArray);
+
+	speculation->numEntries = 0;
+	speculation->isValid    = false;
+}
+
+// Count, for each ASCII character, how many candidates have it directly after a match of the
+// search string. This is the bigram distribution of the search's last character restricted to
+// positions where the whole search matches, i.e. the size of each narrowed result set.
+FILE_SCOPE void WinjumpCore_CountNextChars(const DqnArray<WinjumpProgram> *const programArray,
+                                           const wchar_t *const searchStr, const i32 searchLen,
+                                           u32 *const counts, const i32 numCounts)
+{
+	for (i32 index = 0; index < (i32)programArray->count; index++)
+	{
+		const WinjumpProgram *program = &programArray->data[index];
+		const wchar_t *name           = program->friendlyName;
+
+		// NOTE: Only count a character once per candidate, it only narrows to that candidate once
+		u64 seen[2] = {};
+		DQN_ASSERT(numCounts <= 128);
+		for (i32 i = 0; i + searchLen < program->friendlyNameLen; i++)
+		{
+			i32 matchLen = 0;
+			while (matchLen < searchLen && DqnWChar_ToLower(name[i + matchLen]) == searchStr[matchLen])
+				matchLen++;
+			if (matchLen != searchLen) continue;
+
+			wchar_t nextChar = DqnWChar_ToLower(name[i + searchLen]);
+			if (nextChar >= numCounts || (seen[nextChar / 64] & (1ULL << (nextChar % 64)))) continue;
+
+			seen[nextChar / 64] |= (1ULL << (nextChar % 64));
+			counts[nextChar]++;
+		}
+	}
+}
+
+void WinjumpCore_SpeculateNextChars(WinjumpCore *const core)
+{
+	WinjumpSpeculationState *speculation   = &core->speculation;
+	DqnArray<WinjumpProgram> *programArray = &core->programArray;
+	if (speculation->isValid || !core->isFilteringResults) return;
+	if (core->filterCursor < (i32)programArray->count) return;
+	if (core->searchStringLen + 1 >= DQN_ARRAY_COUNT(core->searchString)) return;
+
+	PROFILER_ZONE(ProfilerZone_Speculate);
+	speculation->isValid    = true;
+	speculation->numEntries = 0;
+
+	u32 counts[128] = {};
+	WinjumpCore_CountNextChars(programArray, core->searchString, core->searchStringLen, counts,
+	                           DQN_ARRAY_COUNT(counts));
+
+	// NOTE: Digits select by list index instead of narrowing by name, so skip them
+	for (wchar_t c = L'0'; c <= L'9'; c++) counts[c] = 0;
+
+	wchar_t nextSearchStr[DQN_ARRAY_COUNT(core->searchString)];
+	i32 nextSearchLen = core->searchStringLen + 1;
+	memcpy(nextSearchStr, core->searchString, core->searchStringLen * sizeof(wchar_t));
+	nextSearchStr[nextSearchLen] = 0;
+
+	i32 userSpecifiedNumbers[8] = {};
+	i32 numUserSpecifiedNumbers = WinjumpCore_ParseSearchNumbers(
+	    core->searchString, core->searchStringLen, userSpecifiedNumbers, DQN_ARRAY_COUNT(userSpecifiedNumbers));
+
+	f64 endTime = DqnTimer_NowInMs() + WINJUMP_SPECULATION_BUDGET_MS;
+	for (i32 entryIndex = 0; entryIndex < WINJUMP_SPECULATION_MAX_CHARS; entryIndex++)
+	{
+		wchar_t bestChar = 0;
+		for (wchar_t c = 1; c < DQN_ARRAY_COUNT(counts); c++)
+		{
+			if (counts[c] > counts[bestChar]) bestChar = c;
+		}
+		if (counts[bestChar] == 0) break;
+		counts[bestChar] = 0;
+
+		WinjumpSpeculation *entry = &speculation->entries[speculation->numEntries];
+		entry->nextChar           = bestChar;
+		nextSearchStr[nextSearchLen - 1] = bestChar;
+
+		DqnArray_Clear(&entry->programArray);
+		bool completed = true;
+		for (i32 index = 0; index < (i32)programArray->count; index++)
+		{
+			const WinjumpProgram *program = &programArray->data[index];
+			if (WinjumpCore_ProgramMatchesSearch(program, nextSearchStr, nextSearchLen,
+			                                     userSpecifiedNumbers, numUserSpecifiedNumbers))
+			{
+				if (!DqnArray_Push(&entry->programArray, *program))
+				{
+					completed = false;
+					break;
+				}
+			}
+		}
+
+		if (!completed) break;
+		speculation->numEntries++;
+		if (DqnTimer_NowInMs() >= endTime) break;
+	}
+}
+
+// If the new search is the old one plus a character we speculated on, swap the precomputed results
+// in. Must be called after the current results have been snapshotted.
+// return: TRUE if the speculated results were used.
+FILE_SCOPE bool WinjumpCore_SpeculationTryUse(WinjumpCore *const core, const wchar_t *const newSearchStr,
+                                              const i32 newSearchLen)
+{
+	WinjumpSpeculationState *speculation = &core->speculation;
+	if (!speculation->isValid) return false;
+	if (newSearchLen != core->searchStringLen + 1) return false;
+	if (memcmp(newSearchStr, core->searchString, core->searchStringLen * sizeof(wchar_t)) != 0)
+		return false;
+
+	wchar_t nextChar = newSearchStr[newSearchLen - 1];
+	for (i32 i = 0; i < speculation->numEntries; i++)
+	{
+		WinjumpSpeculation *entry = &speculation->entries[i];
+		if (entry->nextChar != nextChar) continue;
+
+		DQN_SWAP(DqnArray<WinjumpProgram>, core->programArray, entry->programArray);
+		core->filterCursor = (i32)core->programArray.count;
+		speculation->numHits++;
+		return true;
+	}
+
+	speculation->numMisses++;
+	return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Update
+////////////////////////////////////////////////////////////////////////////////
+bool WinjumpCore_Update(WinjumpCore *const core, const wchar_t *const searchStr, const i32 searchLen,
+                        bool *const filterFinished)
+{
+	*filterFinished = true;
+	if (!WinjumpCore_MergeResolvedExes(core)) return false;
+
+	wchar_t newSearchStr[DQN_ARRAY_COUNT(core->searchString)];
+	i32 newSearchLen = DQN_MIN(searchLen, (i32)DQN_ARRAY_COUNT(newSearchStr) - 1);
+	memcpy(newSearchStr, searchStr, newSearchLen * sizeof(wchar_t));
+	newSearchStr[newSearchLen] = 0;
+
+	///////////////////////////////////////////////////////////////////////////
+	// Enumerate windows or initiate state for filtering
+	///////////////////////////////////////////////////////////////////////////
+	core->isFilteringResults = (newSearchLen > 0);
+
+	// NOTE: If we are filtering, stop clearing out our array and freeze its
+	// state by stopping window enumeration on the array and instead work
+	// with a stack of snapshots of the state
+	if (core->isFilteringResults)
+	{
+		// NOTE: Typing started, make sure the snapshot we filter from isn't up to a backed off
+		// interval old. Enumeration is frozen while filtering, so resume at the fast cadence.
+		if (core->searchStringLen == 0)
+		{
+			f64 staleMs = DqnTimer_NowInMs() - core->enumerateSchedule.lastEnumerateTime;
+			bool force  = (staleMs > WINJUMP_ENUMERATE_MIN_INTERVAL_MS);
+			WinjumpCore_EnumerateScheduleReset(core);
+			if (force && !WinjumpCore_EnumerateIfDue(core, true)) return false;
+		}
+
+		WStrToLower(newSearchStr, newSearchLen);
+		if (core->searchStringLen == newSearchLen)
+		{
+			// NOTE: It's possible to remove more than 1 character from the
+			// search string per frame
+		}
+		else
+		{
+			// NOTE: Whatever array we end up with is a superset of the new results, so filtering it
+			// from the start is correct even if the last search hadn't finished filtering.
+			core->filterCursor = 0;
+
+			bool searchSpaceDecreased = (newSearchLen > core->searchStringLen);
+			// NOTE: Snapshot even when nothing matches, every snapshot is tagged with the search
+			// length it was taken at so widening restores the right one however many characters
+			// were typed or deleted at once.
+			DqnArray<DqnArray<WinjumpProgram>> *snapshotStack = &core->programArraySnapshotStack;
+			if (searchSpaceDecreased)
+			{
+				DqnArray<WinjumpProgram> snapshot = {};
+				if (!WinjumpCore_ProgramArrayCreateSnapshot(core, &snapshot)) return false;
+				if (!DqnArray_Push(snapshotStack, snapshot))
+				{
+					DqnArray_Free(&snapshot);
+					return false;
+				}
+				core->programArraySnapshotSearchLen[snapshotStack->count - 1] = core->searchStringLen;
+
+				WinjumpCore_SpeculationTryUse(core, newSearchStr, newSearchLen);
+			}
+			else
+			{
+				// NOTE: Snapshots of longer searches are narrower than the new results
+				while (snapshotStack->count > 0 &&
+				       core->programArraySnapshotSearchLen[snapshotStack->count - 1] > newSearchLen)
+				{
+					DqnArray_Free(&snapshotStack->data[snapshotStack->count - 1]);
+					DqnArray_Pop(snapshotStack);
+				}
+
+				if (snapshotStack->count > 0)
+				{
+					i32 topIndex = (i32)snapshotStack->count - 1;
+					DqnArray<WinjumpProgram> *snapshot = &snapshotStack->data[topIndex];
+					if (!WinjumpCore_ProgramArrayRestoreSnapshot(core, snapshot)) return false;
+
+					// NOTE: A snapshot of a shorter search stays for when we widen further
+					if (core->programArraySnapshotSearchLen[topIndex] == newSearchLen)
+					{
+						DqnArray_Free(snapshot);
+						DqnArray_Pop(snapshotStack);
+					}
+				}
+			}
+
+			// NOTE: programArray shrinks as it's filtered, so progress is counted against what the
+			// filter starts with. A speculation hit starts with everything already checked.
+			core->filterNumChecked = core->filterCursor;
+			core->filterNumToCheck = (i32)core->programArray.count;
+		}
+	}
+	else
+	{
+		// NOTE: The search was cleared, programArray holds a filtered subset so rebuild it now
+		bool searchCleared = (core->searchStringLen > 0);
+		if (!WinjumpCore_EnumerateIfDue(core, searchCleared)) return false;
+	}
+
+	if (core->searchStringLen != newSearchLen) WinjumpCore_SpeculationInvalidate(core);
+	core->searchStringLen = newSearchLen;
+	if (core->isFilteringResults)
+		memcpy(core->searchString, newSearchStr, (newSearchLen + 1) * sizeof(wchar_t));
+
+	////////////////////////////////////////////////////////////////////////////
+	// Filter program array if user is actively searching
+	////////////////////////////////////////////////////////////////////////////
+	if (core->isFilteringResults)
+	{
+		PROFILER_ZONE(ProfilerZone_Filter);
+
+		// NOTE: Really doubt we neeed any more than that
+		i32 userSpecifiedNumbers[8] = {};
+		i32 userSpecifiedIndex      = WinjumpCore_ParseSearchNumbers(
+		    newSearchStr, newSearchLen, userSpecifiedNumbers, DQN_ARRAY_COUNT(userSpecifiedNumbers));
+
+		*filterFinished = WinjumpCore_FilterPrograms(core, newSearchStr, newSearchLen, userSpecifiedNumbers,
+		                                             userSpecifiedIndex, WINJUMP_FILTER_BUDGET_MS);
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// List Sync
+////////////////////////////////////////////////////////////////////////////////
+// NOTE: FNV-1a, only used to tell whether a displayed row still matches its program
+FILE_SCOPE u64 WinjumpCore_HashWStr(const wchar_t *const str, const i32 len)
+{
+	u64 result = 14695981039346656037ULL;
+	for (i32 i = 0; i < len; i++)
+	{
+		result ^= (u64)str[i];
+		result *= 1099511628211ULL;
+	}
+	return result;
+}
+
+bool WinjumpCore_ListSync(WinjumpCore *const core, WinjumpListView *const view)
+{
+	PROFILER_ZONE(ProfilerZone_ListSync);
+
+	// Check displayed rows against our new enumerated programs list
+	DqnArray<WinjumpListRow> *listRows = &core->listRows;
+	i32 programArraySize               = WinjumpCore_NumProgramsToDisplay(core);
+	for (i32 index = 0; index < programArraySize; index++)
+	{
+		const WinjumpProgram *program = &core->programArray.data[index];
+		WinjumpListRow row = {};
+		row.nameHash       = WinjumpCore_HashWStr(program->friendlyName, program->friendlyNameLen);
+		row.nameLen        = program->friendlyNameLen;
+		row.pid            = program->pid;
+
+		// Fill the remainder of the list
+		if (index >= (i32)listRows->count)
+		{
+			if (!DqnArray_Push(listRows, row)) return false;
+			view->AddRow(view, program);
+			continue;
+		}
+
+		WinjumpListRow *displayed = &listRows->data[index];
+		if (displayed->nameHash != row.nameHash || displayed->nameLen != row.nameLen ||
+		    displayed->pid != row.pid)
+		{
+			*displayed = row;
+			view->SetRow(view, index, program);
+		}
+	}
+
+	// NOTE: Remove dead rows from the back so the indexes of the remaining rows don't shift
+	while ((i32)listRows->count > programArraySize)
+	{
+		DqnArray_Pop(listRows);
+		view->RemoveRow(view, (i32)listRows->count);
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Init
+////////////////////////////////////////////////////////////////////////////////
+bool WinjumpCore_Init(WinjumpCore *const core, WinjumpWindowSource *const windowSource)
+{
+	if (!core || !windowSource) return false;
+	core->windowSource = windowSource;
+
+	if (!DqnArray_Init(&core->programArray, 4))              return false;
+	if (!DqnArray_Init(&core->prevProgramArray, 4))          return false;
+	if (!DqnArray_Init(&core->programArraySnapshotStack, 4)) return false;
+	if (!DqnArray_Init(&core->listRows, 4))                  return false;
+
+	for (i32 i = 0; i < DQN_ARRAY_COUNT(core->speculation.entries); i++)
+	{
+		if (!DqnArray_Init(&core->speculation.entries[i].programArray, 4)) return false;
+	}
+
+	for (i32 i = 0; i < DQN_ARRAY_COUNT(core->friendlyNameStack); i++)
+	{
+		if (!DqnMemStack_Init(&core->friendlyNameStack[i], DQN_KILOBYTE(32), false)) return false;
+	}
+
+	// NOTE: Aligned for the pointers in WinjumpProgram, the stack's default of 4 isn't enough on x64
+	if (!DqnMemStack_Init(&core->snapshotArena, DQN_MEGABYTE(1), false, 16)) return false;
+
+	if (!DqnJobQueue_Init(&core->jobQueue, core->jobList, DQN_ARRAY_COUNT(core->jobList),
+	                      WINJUMP_EXE_RESOLVE_NUM_THREADS))
+	{
+		return false;
+	}
+
+	core->enumerateSchedule.intervalMs     = WINJUMP_ENUMERATE_MIN_INTERVAL_MS;
+	core->enumerateSchedule.windowsChanged = true;
+	return true;
+}
+
+void WinjumpCore_Free(WinjumpCore *const core)
+{
+	// NOTE: Jobs reference the window source and write into exeResolveJobs, let them finish
+	DqnJobQueue_BlockAndCompleteAllJobs(&core->jobQueue);
+
+	for (i32 i = 0; i < core->programArraySnapshotStack.count; i++)
+		DqnArray_Free(&core->programArraySnapshotStack.data[i]);
+	DqnArray_Free(&core->programArraySnapshotStack);
+	DqnArray_Free(&core->programArray);
+	DqnArray_Free(&core->prevProgramArray);
+	DqnHashMap_Free(&core->prevProgramIndexByWindow);
+	DqnHashMap_Free(&core->programIndexByPid);
+	DqnArray_Free(&core->listRows);
+
+	for (i32 i = 0; i < DQN_ARRAY_COUNT(core->speculation.entries); i++)
+		DqnArray_Free(&core->speculation.entries[i].programArray);
+
+	for (i32 i = 0; i < DQN_ARRAY_COUNT(core->friendlyNameStack); i++)
+		DqnMemStack_Free(&core->friendlyNameStack[i]);
+	DqnMemStack_Free(&core->snapshotArena);
+}
@@ -0,0 +1,239 @@
+#ifndef WINJUMP_CORE_H
+#define WINJUMP_CORE_H
+
+#define DQN_PLATFORM_HEADER
+#include "dqn.h"
+
+// Platform independent part of Winjump, the program table, filtering, next character speculation
+// and diffing the results against the displayed list. The platform layer supplies windows through
+// a WinjumpWindowSource and displays the results through a WinjumpListView, so the core can be
+// driven headless by benchmarks on any platform dqn.h supports.
+
+typedef void *WinjumpWindowHandle; // i.e. a HWND on Win32, opaque to the core
+
+struct WinjumpProgram
+{
+	wchar_t title[256];
+	i32     titleLen;
+
+	wchar_t exe[256];
+	i32     exeLen;
+
+	WinjumpWindowHandle window;
+	u32                 pid;
+	bool                exeIsPending; // Exe is still being resolved on a worker thread, exe is empty until then
+
+	i32 lastStableIndex;
+
+	// Formatted "<index>: <title> - <exe>" string displayed in the list. Lives in one of
+	// WinjumpCore's friendlyNameStack arenas and is only reformatted when the title, exe or
+	// lastStableIndex differ from the previous enumeration of the same window.
+	wchar_t *friendlyName;
+	i32      friendlyNameLen;
+};
+
+#define WINJUMP_FRIENDLY_NAME_LEN 512
+
+typedef struct WinjumpCore WinjumpCore;
+typedef struct WinjumpWindowSource WinjumpWindowSource;
+
+// Supplies the switchable top level windows of the platform.
+struct WinjumpWindowSource
+{
+	// Push each window with WinjumpCore_PushWindow(). Called on the main thread.
+	void (*Enumerate)(WinjumpWindowSource *const source, WinjumpCore *const core);
+
+	// Get the file name of the process's exe, i.e. "firefox.exe". Called from worker threads.
+	// return: The length of the name written to exe, 0 if the process could not be queried.
+	i32 (*ResolveExe)(WinjumpWindowSource *const source, const u32 pid, wchar_t *const exe,
+	                  const i32 exeSize);
+
+	// Optional. Called from a worker thread once an exe is resolved so the platform can wake its
+	// loop, the result is merged on the next WinjumpCore_Update().
+	void (*OnExeResolved)(WinjumpWindowSource *const source);
+
+	void *userData;
+};
+
+// Receives the edits that bring the displayed list in line with the results.
+typedef struct WinjumpListView WinjumpListView;
+struct WinjumpListView
+{
+	void (*SetRow)   (WinjumpListView *const view, const i32 index, const WinjumpProgram *const program);
+	void (*AddRow)   (WinjumpListView *const view, const WinjumpProgram *const program);
+	void (*RemoveRow)(WinjumpListView *const view, const i32 index);
+
+	void *userData;
+};
+
+// NOTE: What the list view is displaying. The name is hashed rather than pointed to since the
+// friendly name arenas are recycled underneath the view.
+struct WinjumpListRow
+{
+	u64 nameHash;
+	i32 nameLen;
+	u32 pid;
+};
+
+// Resolving a window's exe opens its process, which is the slow part of enumeration (and can stall
+// on a suspended or hung process), so it's done on the job queue. Windows show up in the list
+// straight away and their exe is filled in as each job completes.
+#define WINJUMP_EXE_RESOLVE_MAX_JOBS    64
+#define WINJUMP_EXE_RESOLVE_NUM_THREADS 2
+
+enum WinjumpExeResolveState
+{
+	WinjumpExeResolveState_Free,
+	WinjumpExeResolveState_Queued, // Owned by the job queue
+	WinjumpExeResolveState_Done,   // Owned by the main thread, waiting to be merged into the program arrays
+};
+
+struct WinjumpExeResolveJob
+{
+	i32 volatile         state;
+	u32                  pid;
+	WinjumpWindowSource *source;
+
+	wchar_t exe[256];
+	i32     exeLen;
+};
+
+// Whilst idle, the narrowed results for the most likely next characters of the search are computed
+// ahead of time so a matching keystroke can swap them in without filtering.
+#define WINJUMP_SPECULATION_MAX_CHARS 3
+struct WinjumpSpeculation
+{
+	wchar_t                  nextChar;
+	DqnArray<WinjumpProgram> programArray; // programArray filtered by the search string plus nextChar
+};
+
+struct WinjumpSpeculationState
+{
+	WinjumpSpeculation entries[WINJUMP_SPECULATION_MAX_CHARS];
+	i32                numEntries;
+	bool               isValid; // Entries were computed from the current search and programArray
+
+	u32 numHits;   // Keystrokes that appended a character we had precomputed
+	u32 numMisses; // Keystrokes that appended a character whilst speculation was valid, but not one we precomputed
+};
+
+// NOTE: Enumeration backs off exponentially while the window set is stable and snaps back to the
+// minimum interval as soon as an enumeration observes a change.
+#define WINJUMP_ENUMERATE_MIN_INTERVAL_MS 250.0
+#define WINJUMP_ENUMERATE_MAX_INTERVAL_MS 4000.0
+
+// NOTE: Whilst hidden the table is still kept current so the hotkey only has to paint, but at a
+// cheaper cadence. Window events are batched for HIDDEN_BATCH_MS and the back off goes further.
+#define WINJUMP_ENUMERATE_HIDDEN_BATCH_MS        1000.0
+#define WINJUMP_ENUMERATE_HIDDEN_MAX_INTERVAL_MS 10000.0
+
+struct WinjumpEnumerateSchedule
+{
+	f64  intervalMs;        // Time to wait after the last enumeration before the next one is due
+	f64  lastEnumerateTime;
+	bool windowsChanged;    // Set by window change events, forces the next update to enumerate
+};
+
+// NOTE: Filtering stops after this long and continues on the next update, so a large candidate set
+// never holds up the input box.
+#define WINJUMP_FILTER_BUDGET_MS 2.0
+
+struct WinjumpCore
+{
+	DqnArray<WinjumpProgram>           programArray;
+	DqnArray<WinjumpProgram>           prevProgramArray; // Last enumeration, used to reuse friendly names
+	DqnArray<DqnArray<WinjumpProgram>> programArraySnapshotStack;
+	i32 programArraySnapshotSearchLen[256]; // Search length each snapshot was taken at, strictly increasing
+	DqnMemStack snapshotArena; // Snapshots after the first, dropped together when the next enumeration resets it
+
+	// NOTE: New friendly names are pushed onto the active arena. Once the garbage in it outweighs
+	// the names still referenced, live names are copied to the other arena and the old one reset.
+	DqnMemStack friendlyNameStack[2];
+	i32         friendlyNameStackIndex;
+
+	// NOTE: Lookups for matching freshly enumerated windows against the last enumeration. The
+	// window lookup is built on demand, most windows keep their index between enumerations.
+	DqnHashMap<WinjumpWindowHandle, i32> prevProgramIndexByWindow;
+	bool                                 prevProgramIndexIsBuilt;
+	DqnHashMap<u32, i32>                 programIndexByPid; // First window of each process, whilst resolving exes
+
+	bool    isFilteringResults;
+	i32     filterCursor;     // Entries of programArray before this have been matched against the search
+	i32     filterNumChecked; // Programs checked since the search last changed, for reporting progress
+	i32     filterNumToCheck; // Programs there were to check when the search last changed
+	i32     searchStringLen;
+	wchar_t searchString[256]; // Lowercased, only kept up to date whilst filtering
+
+	WinjumpEnumerateSchedule enumerateSchedule;
+	bool                     isHidden; // Nobody is looking, enumeration runs at the hidden cadence
+
+	WinjumpWindowSource *windowSource;
+	DqnJobQueue          jobQueue;
+	DqnJob               jobList[WINJUMP_EXE_RESOLVE_MAX_JOBS + 1]; // +1, a full ring keeps a slot empty
+	WinjumpExeResolveJob exeResolveJobs[WINJUMP_EXE_RESOLVE_MAX_JOBS];
+
+	WinjumpSpeculationState speculation;
+	DqnArray<WinjumpListRow> listRows;
+
+	u32 tableGeneration; // Bumped whenever the full program table changes, i.e. to know when to republish it
+};
+
+// core:         Pass a pointer to a zero cleared WinjumpCore.
+// windowSource: Must outlive the core.
+// return:       FALSE if out of memory or the exe resolve threads could not be created.
+bool WinjumpCore_Init(WinjumpCore *const core, WinjumpWindowSource *const windowSource);
+
+// Free the program arrays and friendly names. The exe resolve threads are left running, so only use
+// this when the process is about to exit or in a benchmark.
+void WinjumpCore_Free(WinjumpCore *const core);
+
+// Called by WinjumpWindowSource.Enumerate for each window, the exe is resolved afterwards.
+// return: FALSE if out of memory.
+bool WinjumpCore_PushWindow(WinjumpCore *const core, const WinjumpWindowHandle window, const u32 pid,
+                            const wchar_t *const title, const i32 titleLen);
+
+// Apply the search, enumerating if due and filtering for up to WINJUMP_FILTER_BUDGET_MS.
+// searchStr:      Does not need to be null terminated, it's copied and lowercased.
+// filterFinished: Set to FALSE if filtering ran out of budget, update again to continue.
+// return:         FALSE if out of memory.
+bool WinjumpCore_Update(WinjumpCore *const core, const wchar_t *const searchStr, const i32 searchLen,
+                        bool *const filterFinished);
+
+// Send the edits to view that make it display the current results.
+// return: FALSE if out of memory.
+bool WinjumpCore_ListSync(WinjumpCore *const core, WinjumpListView *const view);
+
+// NOTE: Whilst a filter is in progress only the entries checked so far are shown, the list fills in
+// as the rest are checked.
+i32 WinjumpCore_NumProgramsToDisplay(const WinjumpCore *const core);
+
+// Use idle time to filter the current results by the search string plus each of the most likely
+// next characters. Does nothing if the current results are already speculated on or still being
+// filtered.
+void WinjumpCore_SpeculateNextChars(WinjumpCore *const core);
+
+// NOTE: Call when something suggests the window set is about to change or will be looked at soon,
+// such as a window event or the user starting to type.
+void WinjumpCore_EnumerateScheduleReset(WinjumpCore *const core);
+
+// return: Milliseconds until WinjumpCore_Update() would enumerate, 0 if it's due now. Enumeration
+//         is frozen whilst filtering, the caller shouldn't wait on it then.
+f64 WinjumpCore_MsUntilEnumerateDue(const WinjumpCore *const core, const f64 now);
+
+// return: Every program from the last enumeration, regardless of the search being filtered on.
+const DqnArray<WinjumpProgram> *WinjumpCore_GetProgramTable(const WinjumpCore *const core);
+
+// Parse the numbers typed into a search, programs whose list index matches one are always kept.
+// return: The number of numbers written to userSpecifiedNumbers.
+i32 WinjumpCore_ParseSearchNumbers(const wchar_t *const searchStr, const i32 searchLen,
+                                   i32 *const userSpecifiedNumbers, const i32 maxNumbers);
+
+// The same test filtering applies to the list, for matching a program's friendly name outside the core.
+// index:     The program's 1 based list index, i.e. lastStableIndex + 1
+// searchStr: Lowercased
+bool WinjumpCore_FriendlyNameMatchesSearch(const wchar_t *const friendlyName, const i32 friendlyNameLen,
+                                           const i32 index, const wchar_t *const searchStr,
+                                           const i32 searchLen, const i32 *const userSpecifiedNumbers,
+                                           const i32 numUserSpecifiedNumbers);
+
+#endif /* WINJUMP_CORE_H */
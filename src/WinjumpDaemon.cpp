@@ -0,0 +1,745 @@
+#include "WinjumpDaemon.h"
+
+#define DQN_PLATFORM_HEADER
+#include "dqn.h"
+
+#if defined(DQN_IS_WIN32)
+	#include <sddl.h> // For win32 ConvertStringSecurityDescriptorToSecurityDescriptorA()
+#else
+	#include <errno.h>
+	#include <pthread.h>
+	#include <stdlib.h>
+	#include <sys/socket.h>
+	#include <sys/stat.h>
+	#include <sys/un.h>
+	#include <unistd.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Platform
+////////////////////////////////////////////////////////////////////////////////
+#if defined(DQN_IS_WIN32)
+	#define WINJUMP_DAEMON_INVALID_PIPE INVALID_HANDLE_VALUE
+	#define WINJUMP_DAEMON_THREAD(name) DWORD WINAPI name(void *const userData)
+	#define WINJUMP_DAEMON_THREAD_EXIT  return 0
+#else
+	#define WINJUMP_DAEMON_INVALID_PIPE -1
+	#define WINJUMP_DAEMON_THREAD(name) void *name(void *const userData)
+	#define WINJUMP_DAEMON_THREAD_EXIT  return NULL
+
+	// NOTE: Writing to a client that hung up raises SIGPIPE and kills the process without this
+	#if defined(MSG_NOSIGNAL)
+		#define WINJUMP_DAEMON_SEND_FLAGS MSG_NOSIGNAL
+	#else
+		#define WINJUMP_DAEMON_SEND_FLAGS 0
+	#endif
+#endif
+
+typedef WINJUMP_DAEMON_THREAD(WinjumpDaemonThreadProc);
+
+// return: FALSE if the thread could not be created.
+FILE_SCOPE bool WinjumpDaemon_ThreadCreate(WinjumpDaemonThreadProc *const proc, void *const userData)
+{
+#if defined(DQN_IS_WIN32)
+	HANDLE thread = CreateThread(NULL, 0, proc, userData, 0, NULL);
+	if (!thread) return false;
+	CloseHandle(thread);
+	return true;
+#else
+	pthread_t thread = {};
+	if (pthread_create(&thread, NULL, proc, userData) != 0) return false;
+	pthread_detach(thread);
+	return true;
+#endif
+}
+
+FILE_SCOPE void WinjumpDaemon_SleepMs(const u32 ms)
+{
+#if defined(DQN_IS_WIN32)
+	Sleep(ms);
+#else
+	usleep(ms * 1000);
+#endif
+}
+
+// return: FALSE if the other end closed before size bytes were read.
+FILE_SCOPE bool WinjumpDaemon_PipeRead(const WinjumpDaemonPipe pipe, void *const dest, const size_t size)
+{
+	u8 *bytes      = (u8 *)dest;
+	size_t numRead = 0;
+	while (numRead < size)
+	{
+#if defined(DQN_IS_WIN32)
+		DWORD bytesRead = 0;
+		if (!ReadFile(pipe, bytes + numRead, (DWORD)(size - numRead), &bytesRead, NULL)) return false;
+		if (bytesRead == 0) return false;
+#else
+		ssize_t bytesRead = recv(pipe, bytes + numRead, size - numRead, 0);
+		if (bytesRead < 0 && errno == EINTR) continue;
+		if (bytesRead <= 0) return false;
+#endif
+		numRead += (size_t)bytesRead;
+	}
+
+	return true;
+}
+
+// return: FALSE if the other end closed before size bytes were written.
+FILE_SCOPE bool WinjumpDaemon_PipeWrite(const WinjumpDaemonPipe pipe, const void *const src, const size_t size)
+{
+	const u8 *bytes   = (const u8 *)src;
+	size_t numWritten = 0;
+	while (numWritten < size)
+	{
+#if defined(DQN_IS_WIN32)
+		DWORD bytesWritten = 0;
+		if (!WriteFile(pipe, bytes + numWritten, (DWORD)(size - numWritten), &bytesWritten, NULL)) return false;
+#else
+		ssize_t bytesWritten = send(pipe, bytes + numWritten, size - numWritten, WINJUMP_DAEMON_SEND_FLAGS);
+		if (bytesWritten < 0 && errno == EINTR) continue;
+		if (bytesWritten <= 0) return false;
+#endif
+		numWritten += (size_t)bytesWritten;
+	}
+
+	return true;
+}
+
+FILE_SCOPE void WinjumpDaemon_PipeClose(const WinjumpDaemonPipe pipe)
+{
+#if defined(DQN_IS_WIN32)
+	CloseHandle(pipe);
+#else
+	close(pipe);
+#endif
+}
+
+// Make a connection thread blocked reading from pipe return, without closing it under the thread.
+FILE_SCOPE void WinjumpDaemon_PipeHangUp(const WinjumpDaemonPipe pipe)
+{
+#if defined(DQN_IS_WIN32)
+	CancelIoEx(pipe, NULL);
+	DisconnectNamedPipe(pipe);
+#else
+	shutdown(pipe, SHUT_RDWR);
+#endif
+}
+
+#if !defined(DQN_IS_WIN32)
+// return: TRUE if there's a socket at address that nobody is listening on, i.e. it was left behind
+//         by a daemon that didn't exit cleanly.
+FILE_SCOPE bool WinjumpDaemon_SocketIsStale(const sockaddr_un *const address)
+{
+	struct stat info = {};
+	if (lstat(address->sun_path, &info) != 0 || !S_ISSOCK(info.st_mode)) return false;
+
+	int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (probe == -1) return false;
+
+	// NOTE: A live daemon accepts the probe and simply sees it hang up
+	bool result = (connect(probe, (const sockaddr *)address, sizeof(*address)) != 0 && errno == ECONNREFUSED);
+	close(probe);
+	return result;
+}
+#endif
+
+#if defined(DQN_IS_WIN32)
+// NOTE: A pipe created with the default security lets everyone, even anonymous logons, read it.
+// Window titles are private so the pipe only grants access to the user the daemon runs as.
+// return: FALSE if the user's SID could not be queried or the security descriptor not built.
+FILE_SCOPE bool WinjumpDaemon_SecurityInit(WinjumpDaemon *const daemon)
+{
+	HANDLE token = NULL;
+	if (!OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY, &token)) return false;
+
+	// NOTE: TOKEN_USER is followed by the SID it points to, which is at most SECURITY_MAX_SID_SIZE
+	union
+	{
+		TOKEN_USER user;
+		u8         bytes[sizeof(TOKEN_USER) + SECURITY_MAX_SID_SIZE];
+	} tokenUser;
+
+	DWORD tokenUserSize = 0;
+	BOOL queried = GetTokenInformation(token, TokenUser, &tokenUser, sizeof(tokenUser), &tokenUserSize);
+	CloseHandle(token);
+	if (!queried) return false;
+
+	char *sid = NULL;
+	if (!ConvertSidToStringSidA(tokenUser.user.User.Sid, &sid)) return false;
+
+	// NOTE: D:P is a protected DACL so nothing is inherited, with one ACE of generic all for the user
+	char sddl[256];
+	i32 len = snprintf(sddl, sizeof(sddl), "D:P(A;;GA;;;%s)", sid);
+	LocalFree(sid);
+	if (len <= 0 || len >= (i32)sizeof(sddl)) return false;
+
+	if (!ConvertStringSecurityDescriptorToSecurityDescriptorA(sddl, SDDL_REVISION_1,
+	                                                          &daemon->securityDescriptor, NULL))
+	{
+		return false;
+	}
+
+	daemon->securityAttribs                      = {};
+	daemon->securityAttribs.nLength              = sizeof(daemon->securityAttribs);
+	daemon->securityAttribs.lpSecurityDescriptor = daemon->securityDescriptor;
+	daemon->securityAttribs.bInheritHandle       = FALSE;
+	return true;
+}
+
+FILE_SCOPE void WinjumpDaemon_SecurityFree(WinjumpDaemon *const daemon)
+{
+	if (daemon->securityDescriptor) LocalFree(daemon->securityDescriptor);
+	daemon->securityDescriptor = NULL;
+}
+#endif
+
+// Create the pipe the next client connects to. On Unix this is the listening socket, on Win32 each
+// client connects to its own instance of the pipe so a new instance is created per connection.
+// return: FALSE if the socket or pipe could not be created, i.e. another daemon owns the address.
+FILE_SCOPE bool WinjumpDaemon_PipeListen(WinjumpDaemon *const daemon, const bool firstInstance)
+{
+#if defined(DQN_IS_WIN32)
+	DWORD openMode = PIPE_ACCESS_DUPLEX | ((firstInstance) ? FILE_FLAG_FIRST_PIPE_INSTANCE : 0);
+	DWORD pipeMode = PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS;
+	daemon->listenPipe = CreateNamedPipeA(daemon->address, openMode, pipeMode, PIPE_UNLIMITED_INSTANCES,
+	                                      WINJUMP_DAEMON_CHUNK_SIZE, WINJUMP_DAEMON_CHUNK_SIZE, 0,
+	                                      &daemon->securityAttribs);
+	return (daemon->listenPipe != WINJUMP_DAEMON_INVALID_PIPE);
+#else
+	sockaddr_un address = {};
+	address.sun_family  = AF_UNIX;
+	strcpy(address.sun_path, daemon->address);
+
+	daemon->listenPipe = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (daemon->listenPipe == WINJUMP_DAEMON_INVALID_PIPE) return false;
+
+	// NOTE: A socket left behind by a daemon that didn't exit cleanly would fail the bind. A live
+	// daemon's socket is left alone and the bind fails, so we never steal its address.
+	if (WinjumpDaemon_SocketIsStale(&address)) unlink(daemon->address);
+
+	bool bound = (bind(daemon->listenPipe, (sockaddr *)&address, sizeof(address)) == 0);
+
+	// NOTE: Window titles are private, only the user may connect
+	struct stat info = {};
+	if (!bound || chmod(daemon->address, S_IRUSR | S_IWUSR) != 0 || stat(daemon->address, &info) != 0 ||
+	    listen(daemon->listenPipe, SOMAXCONN) != 0)
+	{
+		close(daemon->listenPipe);
+		if (bound) unlink(daemon->address);
+		daemon->listenPipe = WINJUMP_DAEMON_INVALID_PIPE;
+		return false;
+	}
+
+	daemon->socketDevice = (u64)info.st_dev;
+	daemon->socketInode  = (u64)info.st_ino;
+	return true;
+#endif
+}
+
+// Block until a client connects.
+// return: The client's pipe, WINJUMP_DAEMON_INVALID_PIPE if the daemon can't accept any more.
+FILE_SCOPE WinjumpDaemonPipe WinjumpDaemon_PipeAccept(WinjumpDaemon *const daemon)
+{
+#if defined(DQN_IS_WIN32)
+	WinjumpDaemonPipe result = daemon->listenPipe;
+	while (!ConnectNamedPipe(result, NULL) && GetLastError() != ERROR_PIPE_CONNECTED)
+	{
+		// NOTE: The client hung up between connecting and us accepting, reuse the instance
+		if (GetLastError() != ERROR_NO_DATA) return WINJUMP_DAEMON_INVALID_PIPE;
+		DisconnectNamedPipe(result);
+	}
+
+	if (!WinjumpDaemon_PipeListen(daemon, false))
+	{
+		CloseHandle(result);
+		return WINJUMP_DAEMON_INVALID_PIPE;
+	}
+
+	return result;
+#else
+	for (;;)
+	{
+		WinjumpDaemonPipe result = accept(daemon->listenPipe, NULL, NULL);
+		if (result == WINJUMP_DAEMON_INVALID_PIPE && (errno == EINTR || errno == ECONNABORTED)) continue;
+		return result;
+	}
+#endif
+}
+
+FILE_SCOPE WinjumpDaemonPipe WinjumpDaemon_PipeConnect(const char *const address)
+{
+#if defined(DQN_IS_WIN32)
+	// NOTE: Every instance is busy until the accept thread creates the next one, so wait a little
+	for (i32 attempt = 0; attempt < 4; attempt++)
+	{
+		HANDLE result = CreateFileA(address, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL);
+		if (result != INVALID_HANDLE_VALUE) return result;
+		if (GetLastError() != ERROR_PIPE_BUSY) break;
+		WaitNamedPipeA(address, 250);
+	}
+
+	return WINJUMP_DAEMON_INVALID_PIPE;
+#else
+	sockaddr_un socketAddress = {};
+	socketAddress.sun_family  = AF_UNIX;
+	if (DqnStr_Len(address) >= (i32)sizeof(socketAddress.sun_path)) return WINJUMP_DAEMON_INVALID_PIPE;
+	strcpy(socketAddress.sun_path, address);
+
+	WinjumpDaemonPipe result = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (result == WINJUMP_DAEMON_INVALID_PIPE) return result;
+	if (connect(result, (sockaddr *)&socketAddress, sizeof(socketAddress)) != 0)
+	{
+		close(result);
+		return WINJUMP_DAEMON_INVALID_PIPE;
+	}
+
+	return result;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Snapshots
+////////////////////////////////////////////////////////////////////////////////
+// return: The current snapshot with a reference taken, NULL if nothing's been published yet.
+FILE_SCOPE WinjumpDaemonSnapshot *WinjumpDaemon_SnapshotAcquire(WinjumpDaemon *const daemon)
+{
+	DqnLock_Acquire(&daemon->lock);
+	WinjumpDaemonSnapshot *result = daemon->snapshot;
+	if (result) DqnAtomic_Add32(&result->refCount, 1);
+	DqnLock_Release(&daemon->lock);
+	return result;
+}
+
+// NOTE: Only drops the reference, WinjumpDaemon_Publish() frees it once unreferenced
+FILE_SCOPE void WinjumpDaemon_SnapshotRelease(WinjumpDaemonSnapshot *const snapshot)
+{
+	DqnAtomic_Add32(&snapshot->refCount, -1);
+}
+
+FILE_SCOPE void WinjumpDaemon_FreeRetiredSnapshots(WinjumpDaemon *const daemon)
+{
+	for (i32 i = (i32)daemon->retiredSnapshots.count - 1; i >= 0; i--)
+	{
+		WinjumpDaemonSnapshot *snapshot = daemon->retiredSnapshots.data[i];
+		if (DqnAtomic_CompareSwap32(&snapshot->refCount, 0, 0) != 0) continue;
+
+		DqnMem_Free(snapshot);
+		DqnArray_Remove(&daemon->retiredSnapshots, (u64)i);
+	}
+}
+
+bool WinjumpDaemon_Publish(WinjumpDaemon *const daemon, const WinjumpCore *const core)
+{
+	WinjumpDaemonSnapshot *prevSnapshot = daemon->snapshot;
+	if (prevSnapshot && prevSnapshot->generation == core->tableGeneration) return true;
+	WinjumpDaemon_FreeRetiredSnapshots(daemon);
+
+	// NOTE: One allocation holds the snapshot, its entries and then its names
+	const DqnArray<WinjumpProgram> *table = WinjumpCore_GetProgramTable(core);
+	size_t numNameChars = 0;
+	for (i32 i = 0; i < (i32)table->count; i++)
+		numNameChars += table->data[i].friendlyNameLen;
+
+	size_t size = sizeof(WinjumpDaemonSnapshot) + (sizeof(WinjumpDaemonEntry) * table->count) +
+	              (sizeof(wchar_t) * numNameChars);
+	u8 *memory = (u8 *)DqnMem_Alloc(size);
+	if (!memory) return false;
+
+	// NOTE: Reserve the retired slot up front so publishing can't fail after the swap
+	if (prevSnapshot && !DqnArray_Push(&daemon->retiredSnapshots, prevSnapshot))
+	{
+		DqnMem_Free(memory);
+		return false;
+	}
+
+	WinjumpDaemonSnapshot *snapshot = (WinjumpDaemonSnapshot *)memory;
+	snapshot->refCount              = 1; // The daemon's, until the next publish
+	snapshot->generation            = core->tableGeneration;
+	snapshot->numEntries            = (i32)table->count;
+	snapshot->entries               = (WinjumpDaemonEntry *)(memory + sizeof(WinjumpDaemonSnapshot));
+	snapshot->names                 = (wchar_t *)(snapshot->entries + snapshot->numEntries);
+
+	i32 nameOffset = 0;
+	for (i32 i = 0; i < snapshot->numEntries; i++)
+	{
+		const WinjumpProgram *program = &table->data[i];
+		WinjumpDaemonEntry *entry     = &snapshot->entries[i];
+		entry->window                 = (u64)(size_t)program->window;
+		entry->pid                    = program->pid;
+		entry->index                  = program->lastStableIndex + 1;
+		entry->nameOffset             = nameOffset;
+		entry->nameLen                = program->friendlyNameLen;
+
+		memcpy(snapshot->names + nameOffset, program->friendlyName, sizeof(wchar_t) * program->friendlyNameLen);
+		nameOffset += program->friendlyNameLen;
+	}
+
+	DqnLock_Acquire(&daemon->lock);
+	daemon->snapshot = snapshot;
+	DqnLock_Release(&daemon->lock);
+
+	if (prevSnapshot) WinjumpDaemon_SnapshotRelease(prevSnapshot);
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Serving
+////////////////////////////////////////////////////////////////////////////////
+struct WinjumpDaemonResponse
+{
+	WinjumpDaemonPipe pipe;
+	u32               size;                                        // Bytes of matches buffered in chunk
+	u8                chunk[sizeof(u32) + WINJUMP_DAEMON_CHUNK_SIZE]; // Leading u32 is the chunk size
+};
+
+// return: FALSE if the client hung up.
+FILE_SCOPE bool WinjumpDaemon_ResponseFlush(WinjumpDaemonResponse *const response)
+{
+	if (response->size == 0) return true;
+
+	memcpy(response->chunk, &response->size, sizeof(response->size));
+	bool result    = WinjumpDaemon_PipeWrite(response->pipe, response->chunk, sizeof(u32) + response->size);
+	response->size = 0;
+	return result;
+}
+
+FILE_SCOPE inline void WinjumpDaemon_ResponseWrite(WinjumpDaemonResponse *const response,
+                                                   const void *const data, const size_t size)
+{
+	memcpy(response->chunk + sizeof(u32) + response->size, data, size);
+	response->size += (u32)size;
+}
+
+// NOTE: wchar_t is UTF-16 on Win32 and UTF-32 elsewhere, characters outside the BMP are truncated
+// off Win32.
+// return: FALSE if the client hung up.
+FILE_SCOPE bool WinjumpDaemon_ResponseWriteMatch(WinjumpDaemonResponse *const response,
+                                                 const WinjumpDaemonEntry *const entry,
+                                                 const wchar_t *const name)
+{
+	u16 nameLen       = (u16)DQN_MIN(entry->nameLen, WINJUMP_FRIENDLY_NAME_LEN);
+	size_t recordSize = sizeof(entry->window) + sizeof(entry->pid) + sizeof(nameLen) + (sizeof(u16) * nameLen);
+	if (response->size + recordSize > WINJUMP_DAEMON_CHUNK_SIZE)
+	{
+		if (!WinjumpDaemon_ResponseFlush(response)) return false;
+	}
+
+	WinjumpDaemon_ResponseWrite(response, &entry->window, sizeof(entry->window));
+	WinjumpDaemon_ResponseWrite(response, &entry->pid, sizeof(entry->pid));
+	WinjumpDaemon_ResponseWrite(response, &nameLen, sizeof(nameLen));
+	for (i32 i = 0; i < nameLen; i++)
+	{
+		u16 codeUnit = (u16)name[i];
+		WinjumpDaemon_ResponseWrite(response, &codeUnit, sizeof(codeUnit));
+	}
+
+	return true;
+}
+
+// Match the query against the current snapshot, streaming the matches back as each chunk fills.
+// query:  Lowercased
+// return: FALSE if the client hung up.
+FILE_SCOPE bool WinjumpDaemon_Serve(WinjumpDaemon *const daemon, WinjumpDaemonResponse *const response,
+                                    const wchar_t *const query, const i32 queryLen)
+{
+	i32 userSpecifiedNumbers[8] = {};
+	i32 numUserSpecifiedNumbers = WinjumpCore_ParseSearchNumbers(query, queryLen, userSpecifiedNumbers,
+	                                                             DQN_ARRAY_COUNT(userSpecifiedNumbers));
+
+	bool result                     = true;
+	u32 numMatches                  = 0;
+	WinjumpDaemonSnapshot *snapshot = WinjumpDaemon_SnapshotAcquire(daemon);
+	for (i32 i = 0; snapshot && result && i < snapshot->numEntries; i++)
+	{
+		// NOTE: An empty search shows everything, like the list
+		const WinjumpDaemonEntry *entry = &snapshot->entries[i];
+		const wchar_t *name             = snapshot->names + entry->nameOffset;
+		if (queryLen > 0 &&
+		    !WinjumpCore_FriendlyNameMatchesSearch(name, entry->nameLen, entry->index, query, queryLen,
+		                                           userSpecifiedNumbers, numUserSpecifiedNumbers))
+		{
+			continue;
+		}
+
+		result = WinjumpDaemon_ResponseWriteMatch(response, entry, name);
+		numMatches++;
+	}
+	if (snapshot) WinjumpDaemon_SnapshotRelease(snapshot);
+
+	u32 end[2] = {0, numMatches}; // Empty chunk then the number of matches
+	result     = result && WinjumpDaemon_ResponseFlush(response);
+	result     = result && WinjumpDaemon_PipeWrite(response->pipe, end, sizeof(end));
+	DqnAtomic_Add32(&daemon->numQueries, 1);
+	return result;
+}
+
+FILE_SCOPE WINJUMP_DAEMON_THREAD(WinjumpDaemon_ConnectionThread)
+{
+	WinjumpDaemonConnection *connection = (WinjumpDaemonConnection *)userData;
+	WinjumpDaemon *daemon               = connection->daemon;
+
+	WinjumpDaemonResponse response = {};
+	response.pipe                  = connection->pipe;
+	for (;;)
+	{
+		u32 queryLen = 0;
+		u16 codeUnits[WINJUMP_DAEMON_MAX_QUERY_LEN];
+		if (!WinjumpDaemon_PipeRead(connection->pipe, &queryLen, sizeof(queryLen))) break;
+		if (queryLen > WINJUMP_DAEMON_MAX_QUERY_LEN) break;
+		if (!WinjumpDaemon_PipeRead(connection->pipe, codeUnits, sizeof(u16) * queryLen)) break;
+
+		wchar_t query[WINJUMP_DAEMON_MAX_QUERY_LEN];
+		for (u32 i = 0; i < queryLen; i++)
+			query[i] = DqnWChar_ToLower((wchar_t)codeUnits[i]);
+
+		if (!WinjumpDaemon_Serve(daemon, &response, query, (i32)queryLen)) break;
+	}
+
+	// NOTE: Under the lock so WinjumpDaemon_Stop() never hangs up a pipe that's been closed
+	DqnLock_Acquire(&daemon->lock);
+	WinjumpDaemon_PipeClose(connection->pipe);
+	DqnAtomic_CompareSwap32(&connection->inUse, 0, 1);
+	DqnLock_Release(&daemon->lock);
+	WINJUMP_DAEMON_THREAD_EXIT;
+}
+
+FILE_SCOPE WINJUMP_DAEMON_THREAD(WinjumpDaemon_AcceptThread)
+{
+	WinjumpDaemon *daemon = (WinjumpDaemon *)userData;
+	for (;;)
+	{
+		WinjumpDaemonPipe pipe = WinjumpDaemon_PipeAccept(daemon);
+		if (pipe == WINJUMP_DAEMON_INVALID_PIPE) break;
+		if (!daemon->isRunning)
+		{
+			WinjumpDaemon_PipeClose(pipe);
+			break;
+		}
+
+		WinjumpDaemonConnection *connection = NULL;
+		for (i32 i = 0; !connection && i < DQN_ARRAY_COUNT(daemon->connections); i++)
+		{
+			if (DqnAtomic_CompareSwap32(&daemon->connections[i].inUse, 1, 0) == 0)
+				connection = &daemon->connections[i];
+		}
+
+		if (!connection)
+		{
+			WinjumpDaemon_PipeClose(pipe);
+			continue;
+		}
+
+		connection->daemon = daemon;
+		connection->pipe   = pipe;
+		if (!WinjumpDaemon_ThreadCreate(WinjumpDaemon_ConnectionThread, connection))
+		{
+			WinjumpDaemon_PipeClose(pipe);
+			DqnAtomic_CompareSwap32(&connection->inUse, 0, 1);
+		}
+	}
+
+	DqnAtomic_CompareSwap32(&daemon->acceptThreadIsRunning, 0, 1);
+	WINJUMP_DAEMON_THREAD_EXIT;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Daemon
+////////////////////////////////////////////////////////////////////////////////
+bool WinjumpDaemon_GetDefaultAddress(char *const out, const i32 outSize)
+{
+	if (!out || outSize <= 0) return false;
+
+#if defined(DQN_IS_WIN32)
+	i32 len = snprintf(out, outSize, "%s", WINJUMP_DAEMON_ADDRESS);
+#else
+	// NOTE: $XDG_RUNTIME_DIR is already private to the user. Otherwise make our own directory, but
+	// don't trust one that already exists unless it's ours and nobody else can enter it.
+	const char *dir = getenv("XDG_RUNTIME_DIR");
+	char tmpDir[64];
+	if (!dir || dir[0] == 0)
+	{
+		snprintf(tmpDir, sizeof(tmpDir), "/tmp/winjump-%u", (u32)getuid());
+		if (mkdir(tmpDir, S_IRWXU) != 0 && errno != EEXIST) return false;
+
+		struct stat info = {};
+		if (lstat(tmpDir, &info) != 0 || !S_ISDIR(info.st_mode) || info.st_uid != getuid() ||
+		    (info.st_mode & (S_IRWXG | S_IRWXO)) != 0)
+		{
+			return false;
+		}
+
+		dir = tmpDir;
+	}
+
+	i32 len = snprintf(out, outSize, "%s/%s", dir, WINJUMP_DAEMON_SOCKET_NAME);
+#endif
+
+	bool result = (len > 0 && len < outSize);
+	return result;
+}
+
+bool WinjumpDaemon_Start(WinjumpDaemon *const daemon, const char *const address)
+{
+	if (!daemon || !address) return false;
+	if (DqnStr_Len(address) >= (i32)sizeof(daemon->address)) return false;
+	strcpy(daemon->address, address);
+
+	if (!DqnLock_Init(&daemon->lock)) return false;
+	if (!DqnArray_Init(&daemon->retiredSnapshots, 4)) return false;
+
+#if defined(DQN_IS_WIN32)
+	if (!WinjumpDaemon_SecurityInit(daemon)) return false;
+#endif
+
+	if (!WinjumpDaemon_PipeListen(daemon, true))
+	{
+#if defined(DQN_IS_WIN32)
+		WinjumpDaemon_SecurityFree(daemon);
+#endif
+		return false;
+	}
+
+	daemon->isRunning             = true;
+	daemon->acceptThreadIsRunning = 1;
+	if (!WinjumpDaemon_ThreadCreate(WinjumpDaemon_AcceptThread, daemon))
+	{
+		WinjumpDaemon_PipeClose(daemon->listenPipe);
+#if defined(DQN_IS_WIN32)
+		WinjumpDaemon_SecurityFree(daemon);
+#endif
+		daemon->isRunning             = false;
+		daemon->acceptThreadIsRunning = 0;
+		return false;
+	}
+
+	return true;
+}
+
+void WinjumpDaemon_Stop(WinjumpDaemon *const daemon)
+{
+	if (!daemon->isRunning) return;
+	daemon->isRunning = false;
+
+	// NOTE: The accept thread is blocked waiting for a client, be that client so it sees we're stopping
+	while (DqnAtomic_CompareSwap32(&daemon->acceptThreadIsRunning, 0, 0) != 0)
+	{
+		WinjumpDaemonPipe pipe = WinjumpDaemon_PipeConnect(daemon->address);
+		if (pipe != WINJUMP_DAEMON_INVALID_PIPE) WinjumpDaemon_PipeClose(pipe);
+		WinjumpDaemon_SleepMs(1);
+	}
+
+	WinjumpDaemon_PipeClose(daemon->listenPipe);
+#if defined(DQN_IS_WIN32)
+	// NOTE: The accept thread has exited, so no more pipe instances are created with it
+	WinjumpDaemon_SecurityFree(daemon);
+#else
+	struct stat info = {};
+	if (lstat(daemon->address, &info) == 0 && (u64)info.st_dev == daemon->socketDevice &&
+	    (u64)info.st_ino == daemon->socketInode)
+	{
+		unlink(daemon->address);
+	}
+#endif
+
+	// NOTE: No more connections can start, hang up on the open ones and wait for their threads
+	for (;;)
+	{
+		bool connectionsOpen = false;
+		DqnLock_Acquire(&daemon->lock);
+		for (i32 i = 0; i < DQN_ARRAY_COUNT(daemon->connections); i++)
+		{
+			WinjumpDaemonConnection *connection = &daemon->connections[i];
+			if (DqnAtomic_CompareSwap32(&connection->inUse, 0, 0) == 0) continue;
+
+			WinjumpDaemon_PipeHangUp(connection->pipe);
+			connectionsOpen = true;
+		}
+		DqnLock_Release(&daemon->lock);
+
+		if (!connectionsOpen) break;
+		WinjumpDaemon_SleepMs(1);
+	}
+
+	// NOTE: Every connection has exited, so nothing references the snapshots anymore
+	if (daemon->snapshot) DqnMem_Free(daemon->snapshot);
+	daemon->snapshot = NULL;
+	for (i32 i = 0; i < (i32)daemon->retiredSnapshots.count; i++)
+		DqnMem_Free(daemon->retiredSnapshots.data[i]);
+	DqnArray_Free(&daemon->retiredSnapshots);
+	DqnLock_Delete(&daemon->lock);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Client
+////////////////////////////////////////////////////////////////////////////////
+bool WinjumpDaemonClient_Connect(WinjumpDaemonClient *const client, const char *const address)
+{
+	client->pipe = WinjumpDaemon_PipeConnect(address);
+	return (client->pipe != WINJUMP_DAEMON_INVALID_PIPE);
+}
+
+void WinjumpDaemonClient_Disconnect(WinjumpDaemonClient *const client)
+{
+	if (client->pipe == WINJUMP_DAEMON_INVALID_PIPE) return;
+	WinjumpDaemon_PipeClose(client->pipe);
+	client->pipe = WINJUMP_DAEMON_INVALID_PIPE;
+}
+
+i32 WinjumpDaemonClient_Query(WinjumpDaemonClient *const client, const wchar_t *const query,
+                              const i32 queryLen,
+                              void (*OnMatch)(const WinjumpDaemonMatch *const match, void *const userData),
+                              void *const userData)
+{
+	// NOTE: The request goes in one write, so the daemon never waits on half of it
+	u8 request[sizeof(u32) + (sizeof(u16) * WINJUMP_DAEMON_MAX_QUERY_LEN)];
+	u32 numCodeUnits = (u32)DQN_MIN(DQN_MAX(queryLen, 0), WINJUMP_DAEMON_MAX_QUERY_LEN);
+	memcpy(request, &numCodeUnits, sizeof(numCodeUnits));
+	for (u32 i = 0; i < numCodeUnits; i++)
+	{
+		u16 codeUnit = (u16)query[i];
+		memcpy(request + sizeof(u32) + (sizeof(u16) * i), &codeUnit, sizeof(codeUnit));
+	}
+
+	if (!WinjumpDaemon_PipeWrite(client->pipe, request, sizeof(u32) + (sizeof(u16) * numCodeUnits)))
+		return -1;
+
+	for (;;)
+	{
+		u32 chunkSize = 0;
+		if (!WinjumpDaemon_PipeRead(client->pipe, &chunkSize, sizeof(chunkSize))) return -1;
+		if (chunkSize == 0) break;
+		if (chunkSize > sizeof(client->chunk)) return -1;
+		if (!WinjumpDaemon_PipeRead(client->pipe, client->chunk, chunkSize)) return -1;
+
+		for (u32 offset = 0; offset < chunkSize;)
+		{
+			WinjumpDaemonMatch match = {};
+			u16 nameLen              = 0;
+			size_t headerSize        = sizeof(match.window) + sizeof(match.pid) + sizeof(nameLen);
+			if (offset + headerSize > chunkSize) return -1;
+
+			memcpy(&match.window, client->chunk + offset, sizeof(match.window)); offset += sizeof(match.window);
+			memcpy(&match.pid,    client->chunk + offset, sizeof(match.pid));    offset += sizeof(match.pid);
+			memcpy(&nameLen,      client->chunk + offset, sizeof(nameLen));      offset += sizeof(nameLen);
+			if (nameLen > WINJUMP_FRIENDLY_NAME_LEN || offset + (sizeof(u16) * nameLen) > chunkSize) return -1;
+
+			for (i32 i = 0; i < nameLen; i++)
+			{
+				u16 codeUnit = 0;
+				memcpy(&codeUnit, client->chunk + offset, sizeof(codeUnit));
+				offset += sizeof(codeUnit);
+				match.name[i] = (wchar_t)codeUnit;
+			}
+
+			match.nameLen = nameLen;
+			if (OnMatch) OnMatch(&match, userData);
+		}
+	}
+
+	u32 numMatches = 0;
+	if (!WinjumpDaemon_PipeRead(client->pipe, &numMatches, sizeof(numMatches))) return -1;
+	return (i32)numMatches;
+}
@@ -0,0 +1,139 @@
+#ifndef WINJUMP_DAEMON_H
+#define WINJUMP_DAEMON_H
+
+#include "WinjumpCore.h"
+
+// Serves searches of the program table to other processes over a local Unix domain socket, or a
+// named pipe on Win32, so launchers and scripts can query what Winjump already keeps warm instead
+// of enumerating windows themselves. The owner of the core publishes an immutable snapshot of the
+// table whenever it changes and every connection matches against the latest one on its own thread,
+// so any number of clients can query concurrently without touching the core.
+
+// Protocol, little endian, strings are UTF-16 code units without a terminator. A connection sends
+// any number of requests, one at a time, each answered before the next is read.
+// Request:  u32 queryLen, u16 query[queryLen], queryLen <= WINJUMP_DAEMON_MAX_QUERY_LEN or the
+//           connection is closed
+// Response: Chunks of matches streamed as they're found, u32 chunkSize then chunkSize bytes of
+//           matches. A chunk of size 0 ends the response and is followed by u32 numMatches.
+// Match:    u64 window, u32 pid, u16 nameLen, u16 name[nameLen], the friendly name as displayed
+//           in the list, i.e. "3: Inbox - outlook.exe"
+// The search is matched the same as the search box, so the results are what the list would show.
+#if defined(DQN_IS_WIN32)
+	#define WINJUMP_DAEMON_ADDRESS "\\\\.\\pipe\\winjump"
+	typedef HANDLE WinjumpDaemonPipe;
+#else
+	// NOTE: The socket lives in a directory only the user can enter, see WinjumpDaemon_GetDefaultAddress()
+	#define WINJUMP_DAEMON_SOCKET_NAME "winjump.sock"
+	typedef int WinjumpDaemonPipe;
+#endif
+
+#define WINJUMP_DAEMON_MAX_QUERY_LEN   255
+#define WINJUMP_DAEMON_MAX_CONNECTIONS 64   // Connections past this are closed straight away
+#define WINJUMP_DAEMON_CHUNK_SIZE      4096 // Matches are sent once this much is buffered
+
+// NOTE: Immutable once published. The daemon holds a reference to the current snapshot and each
+// connection holds one for the query it's serving, retired snapshots are freed by the next
+// WinjumpDaemon_Publish() once their count drops to 0 so only the publishing thread allocates.
+struct WinjumpDaemonEntry
+{
+	u64 window;
+	u32 pid;
+	i32 index;      // 1 based list index, matched against numbers in the search
+	i32 nameOffset; // Into WinjumpDaemonSnapshot.names
+	i32 nameLen;
+};
+
+struct WinjumpDaemonSnapshot
+{
+	i32 volatile        refCount;
+	u32                 generation; // WinjumpCore.tableGeneration the snapshot was taken at
+	i32                 numEntries;
+	WinjumpDaemonEntry *entries;
+	wchar_t            *names;      // Friendly names of the entries back to back
+};
+
+struct WinjumpDaemonConnection
+{
+	struct WinjumpDaemon *daemon;
+	WinjumpDaemonPipe     pipe;
+	i32 volatile          inUse; // Set by the accept thread, cleared by the connection's thread on exit
+};
+
+struct WinjumpDaemon
+{
+	char                    address[108]; // Fits sockaddr_un.sun_path
+	WinjumpDaemonPipe       listenPipe;
+#if defined(DQN_IS_WIN32)
+	SECURITY_ATTRIBUTES     securityAttribs; // Every pipe instance is created with, only grants the user access
+	PSECURITY_DESCRIPTOR    securityDescriptor;
+#else
+	u64                     socketDevice; // Identify the socket file we bound, so we only ever unlink our own
+	u64                     socketInode;
+#endif
+	bool volatile           isRunning;
+	i32 volatile            acceptThreadIsRunning;
+	WinjumpDaemonConnection connections[WINJUMP_DAEMON_MAX_CONNECTIONS];
+
+	DqnLock                           lock;     // Guards swapping snapshot and taking a reference to it
+	WinjumpDaemonSnapshot            *snapshot; // The latest published table, NULL before the first publish
+	DqnArray<WinjumpDaemonSnapshot *> retiredSnapshots;
+
+	i32 volatile numQueries; // Served since the daemon started
+};
+
+// Get the address the daemon listens on by default for the current user. On Win32 this is
+// WINJUMP_DAEMON_ADDRESS. On Unix it's WINJUMP_DAEMON_SOCKET_NAME in $XDG_RUNTIME_DIR, or in
+// /tmp/winjump-<uid> which is created with 0700 permissions if $XDG_RUNTIME_DIR isn't set.
+// return: FALSE if out is too small, or the directory could not be created or isn't private to
+//         the user.
+bool WinjumpDaemon_GetDefaultAddress(char *const out, const i32 outSize);
+
+// Create the socket or pipe at address and start accepting connections on a background thread.
+// Queries are answered with an empty result until the first WinjumpDaemon_Publish(). On Unix a
+// socket left at address by a daemon that's gone is replaced. The socket or pipe is only accessible
+// by the user.
+// daemon:  Pass a pointer to a zero cleared WinjumpDaemon.
+// address: A socket path on Unix, a pipe name on Win32, i.e. from WinjumpDaemon_GetDefaultAddress().
+// return:  FALSE if out of memory, another daemon is listening at address or the socket, pipe or
+//          thread could not be created.
+bool WinjumpDaemon_Start(WinjumpDaemon *const daemon, const char *const address);
+
+// Close every connection, wait for their threads to exit and free the snapshots. On Unix the
+// socket file is removed unless it has since been replaced by another daemon's.
+void WinjumpDaemon_Stop(WinjumpDaemon *const daemon);
+
+// Take a snapshot of the core's program table for connections to query, does nothing if the table
+// hasn't changed since the last publish. Call from the thread that owns the core after updating it.
+// return: FALSE if out of memory, the previous snapshot stays published.
+bool WinjumpDaemon_Publish(WinjumpDaemon *const daemon, const WinjumpCore *const core);
+
+////////////////////////////////////////////////////////////////////////////////
+// Client
+////////////////////////////////////////////////////////////////////////////////
+struct WinjumpDaemonMatch
+{
+	u64     window;
+	u32     pid;
+	wchar_t name[WINJUMP_FRIENDLY_NAME_LEN];
+	i32     nameLen;
+};
+
+struct WinjumpDaemonClient
+{
+	WinjumpDaemonPipe pipe;
+	u8                chunk[WINJUMP_DAEMON_CHUNK_SIZE];
+};
+
+// return: FALSE if there is no daemon listening at address.
+bool WinjumpDaemonClient_Connect(WinjumpDaemonClient *const client, const char *const address);
+void WinjumpDaemonClient_Disconnect(WinjumpDaemonClient *const client);
+
+// Search the daemon's program table, OnMatch is called for each match as its chunk arrives.
+// OnMatch: Optional
+// return:  The number of matches, -1 if the connection failed.
+i32 WinjumpDaemonClient_Query(WinjumpDaemonClient *const client, const wchar_t *const query,
+                              const i32 queryLen,
+                              void (*OnMatch)(const WinjumpDaemonMatch *const match, void *const userData),
+                              void *const userData);
+
+#endif /* WINJUMP_DAEMON_H */
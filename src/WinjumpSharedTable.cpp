@@ -0,0 +1,340 @@
+#include "WinjumpSharedTable.h"
+
+#define DQN_PLATFORM_HEADER
+#include "dqn.h"
+
+#if !defined(DQN_IS_WIN32)
+	#include <errno.h>
+	#include <fcntl.h>
+	#include <signal.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#include <string.h>
+
+FILE_SCOPE const char WINJUMP_SHARED_TABLE_MAGIC[4] = {'W', 'J', 'S', 'T'};
+
+// NOTE: Orders the sequence against the table on both sides, x86 only needs this to stop the
+// compiler reordering but it's a full fence everywhere to keep it simple.
+FILE_SCOPE inline void WinjumpSharedTable_Barrier()
+{
+#if defined(DQN_IS_WIN32)
+	MemoryBarrier();
+#else
+	__sync_synchronize();
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Writing
+////////////////////////////////////////////////////////////////////////////////
+#if defined(DQN_IS_WIN32)
+// NOTE: A writer that's still being created hasn't set its pid yet and is treated as gone, the
+// window for that is between its CreateFileMappingA() and writing the header.
+// return: TRUE if the writer in the header of an existing region is still running.
+FILE_SCOPE bool WinjumpSharedTable_WriterIsAlive(const WinjumpSharedTableHeader *const header)
+{
+	if (header->writerPid == 0) return false;
+
+	// NOTE: Access denied means it's running as another user, which is still a live writer
+	HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, header->writerPid);
+	if (!process) return (GetLastError() == ERROR_ACCESS_DENIED);
+
+	DWORD exitCode = 0;
+	bool result    = (GetExitCodeProcess(process, &exitCode) && exitCode == STILL_ACTIVE);
+	CloseHandle(process);
+	return result;
+}
+#else
+// NOTE: A writer that's still being created hasn't set its pid yet and is treated as gone, the
+// window for that is the few syscalls between its shm_open() and writing the header.
+// return: TRUE if the region at name exists and the writer in its header is still running.
+FILE_SCOPE bool WinjumpSharedTable_WriterIsAlive(const char *const name)
+{
+	int fd = shm_open(name, O_RDONLY, 0);
+	if (fd == -1) return false;
+
+	bool result      = false;
+	struct stat info = {};
+	if (fstat(fd, &info) == 0 && info.st_size >= (off_t)sizeof(WinjumpSharedTableHeader))
+	{
+		void *region = mmap(NULL, sizeof(WinjumpSharedTableHeader), PROT_READ, MAP_SHARED, fd, 0);
+		if (region != MAP_FAILED)
+		{
+			// NOTE: EPERM means it's running as another user, which is still a live writer
+			pid_t pid = (pid_t)((WinjumpSharedTableHeader *)region)->writerPid;
+			result    = (pid > 0 && (kill(pid, 0) == 0 || errno == EPERM));
+			munmap(region, sizeof(WinjumpSharedTableHeader));
+		}
+	}
+
+	close(fd);
+	return result;
+}
+#endif
+
+bool WinjumpSharedTable_Create(WinjumpSharedTable *const table, const char *const name)
+{
+	if (!table || !name || DqnStr_Len(name) >= (i32)sizeof(table->name)) return false;
+	strcpy(table->name, name);
+
+#if defined(DQN_IS_WIN32)
+	table->mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0,
+	                                    (DWORD)WINJUMP_SHARED_TABLE_SIZE, name);
+	if (!table->mapping) return false;
+	bool alreadyExists = (GetLastError() == ERROR_ALREADY_EXISTS);
+
+	table->region = (u8 *)MapViewOfFile(table->mapping, FILE_MAP_ALL_ACCESS, 0, 0, WINJUMP_SHARED_TABLE_SIZE);
+	if (!table->region)
+	{
+		CloseHandle(table->mapping);
+		table->mapping = NULL;
+		return false;
+	}
+
+	// NOTE: The mapping lives on whilst any reader has it open, even after its writer is gone. A
+	// live writer's region is left alone, two writers would break each other's sequence.
+	if (alreadyExists)
+	{
+		WinjumpSharedTableHeader *header = (WinjumpSharedTableHeader *)table->region;
+		if (WinjumpSharedTable_WriterIsAlive(header))
+		{
+			UnmapViewOfFile(table->region);
+			CloseHandle(table->mapping);
+			table->region  = NULL;
+			table->mapping = NULL;
+			return false;
+		}
+
+		// NOTE: Readers may be mid read of the old table, empty it like a publish would so their
+		// reads retry. The sequence is rounded up to even in case the writer died mid publish.
+		u32 sequence     = (header->sequence + 1) & ~1u;
+		header->sequence = sequence + 1;
+		WinjumpSharedTable_Barrier();
+		header->generation = sequence / 2 + 1;
+		header->numEntries = 0;
+		header->textLen    = 0;
+		header->numDropped = 0;
+		WinjumpSharedTable_Barrier();
+		header->sequence = sequence + 2;
+	}
+#else
+	// NOTE: A region left behind by a run that didn't exit cleanly is replaced, not reused. A live
+	// writer's region is left alone, two writers would break each other's sequence.
+	int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fd == -1 && errno == EEXIST && !WinjumpSharedTable_WriterIsAlive(name))
+	{
+		shm_unlink(name);
+		fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+	}
+	if (fd == -1) return false;
+
+	void *region = MAP_FAILED;
+	if (ftruncate(fd, WINJUMP_SHARED_TABLE_SIZE) == 0)
+		region = mmap(NULL, WINJUMP_SHARED_TABLE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (region == MAP_FAILED)
+	{
+		shm_unlink(name);
+		return false;
+	}
+	table->region = (u8 *)region;
+#endif
+
+	// NOTE: The region is zeroed when created or emptied when taken over, so it reads as an empty
+	// table until the first publish
+	WinjumpSharedTableHeader *header = (WinjumpSharedTableHeader *)table->region;
+	header->version                  = WINJUMP_SHARED_TABLE_VERSION;
+	header->regionSize               = (u32)WINJUMP_SHARED_TABLE_SIZE;
+	header->entriesOffset            = sizeof(WinjumpSharedTableHeader);
+	header->textOffset               = sizeof(WinjumpSharedTableHeader);
+#if defined(DQN_IS_WIN32)
+	header->writerPid                = (u32)GetCurrentProcessId();
+#else
+	header->writerPid                = (u32)getpid();
+#endif
+	WinjumpSharedTable_Barrier();
+	memcpy(header->magic, WINJUMP_SHARED_TABLE_MAGIC, sizeof(header->magic));
+	return true;
+}
+
+void WinjumpSharedTable_Destroy(WinjumpSharedTable *const table)
+{
+	if (!table->region) return;
+
+#if defined(DQN_IS_WIN32)
+	UnmapViewOfFile(table->region);
+	CloseHandle(table->mapping);
+#else
+	munmap(table->region, WINJUMP_SHARED_TABLE_SIZE);
+	shm_unlink(table->name);
+#endif
+	table->region = NULL;
+}
+
+void WinjumpSharedTable_Publish(WinjumpSharedTable *const table, const WinjumpCore *const core)
+{
+	if (table->hasPublished && table->publishedGeneration == core->tableGeneration) return;
+
+	// NOTE: Fit as many windows as the region holds, the entries come first so the text starts
+	// after however many make it
+	const DqnArray<WinjumpProgram> *programTable = WinjumpCore_GetProgramTable(core);
+	size_t availableBytes = WINJUMP_SHARED_TABLE_SIZE - sizeof(WinjumpSharedTableHeader);
+	size_t usedBytes      = 0;
+	u32 numEntries        = 0;
+	for (; numEntries < (u32)programTable->count; numEntries++)
+	{
+		const WinjumpProgram *program = &programTable->data[numEntries];
+		size_t entryBytes = sizeof(WinjumpSharedTableEntry) + (sizeof(u16) * (program->titleLen + program->exeLen));
+		if (usedBytes + entryBytes > availableBytes) break;
+		usedBytes += entryBytes;
+	}
+
+	WinjumpSharedTableHeader *header = (WinjumpSharedTableHeader *)table->region;
+	WinjumpSharedTableEntry *entries = (WinjumpSharedTableEntry *)(table->region + header->entriesOffset);
+	u32 textOffset                   = header->entriesOffset + (numEntries * (u32)sizeof(WinjumpSharedTableEntry));
+	u16 *text                        = (u16 *)(table->region + textOffset);
+
+	u32 sequence     = header->sequence;
+	header->sequence = sequence + 1;
+	WinjumpSharedTable_Barrier();
+
+	// NOTE: wchar_t is UTF-16 on Win32 and UTF-32 elsewhere, characters outside the BMP are truncated
+	// off Win32.
+	u32 textLen = 0;
+	for (u32 i = 0; i < numEntries; i++)
+	{
+		const WinjumpProgram *program  = &programTable->data[i];
+		WinjumpSharedTableEntry *entry = &entries[i];
+		entry->window                  = (u64)(size_t)program->window;
+		entry->pid                     = program->pid;
+		entry->index                   = (u32)(program->lastStableIndex + 1);
+		entry->titleOffset             = textLen;
+		entry->titleLen                = (u16)program->titleLen;
+		entry->exeLen                  = (u16)program->exeLen;
+
+		for (i32 j = 0; j < program->titleLen; j++) text[textLen++] = (u16)program->title[j];
+		for (i32 j = 0; j < program->exeLen; j++)   text[textLen++] = (u16)program->exe[j];
+	}
+
+	header->generation = sequence / 2 + 1;
+	header->numEntries = numEntries;
+	header->textOffset = textOffset;
+	header->textLen    = textLen;
+	header->numDropped = (u32)programTable->count - numEntries;
+
+	WinjumpSharedTable_Barrier();
+	header->sequence = sequence + 2;
+
+	table->publishedGeneration = core->tableGeneration;
+	table->hasPublished        = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reading
+////////////////////////////////////////////////////////////////////////////////
+bool WinjumpSharedTableReader_Open(WinjumpSharedTableReader *const reader, const char *const name)
+{
+	*reader = {};
+
+#if defined(DQN_IS_WIN32)
+	reader->mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name);
+	if (!reader->mapping) return false;
+
+	// NOTE: Size 0 maps the whole region, whatever size the writer made it
+	reader->region = (const u8 *)MapViewOfFile(reader->mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!reader->region)
+	{
+		CloseHandle(reader->mapping);
+		return false;
+	}
+
+	MEMORY_BASIC_INFORMATION info = {};
+	VirtualQuery(reader->region, &info, sizeof(info));
+	reader->mappedSize = info.RegionSize;
+#else
+	int fd = shm_open(name, O_RDONLY, 0);
+	if (fd == -1) return false;
+
+	struct stat fileStat = {};
+	void *region         = MAP_FAILED;
+	if (fstat(fd, &fileStat) == 0 && fileStat.st_size >= (off_t)sizeof(WinjumpSharedTableHeader))
+		region = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (region == MAP_FAILED) return false;
+	reader->region     = (const u8 *)region;
+	reader->mappedSize = (size_t)fileStat.st_size;
+#endif
+
+	// NOTE: Trust the mapping's size over the header's, the header can only make it smaller
+	const WinjumpSharedTableHeader *header = (const WinjumpSharedTableHeader *)reader->region;
+	reader->regionSize                     = (u32)DQN_MIN(reader->mappedSize, (size_t)header->regionSize);
+	if (memcmp(header->magic, WINJUMP_SHARED_TABLE_MAGIC, sizeof(header->magic)) != 0 ||
+	    header->version != WINJUMP_SHARED_TABLE_VERSION || reader->regionSize < sizeof(WinjumpSharedTableHeader))
+	{
+		WinjumpSharedTableReader_Close(reader);
+		return false;
+	}
+
+	return true;
+}
+
+void WinjumpSharedTableReader_Close(WinjumpSharedTableReader *const reader)
+{
+	if (!reader->region) return;
+
+#if defined(DQN_IS_WIN32)
+	UnmapViewOfFile(reader->region);
+	CloseHandle(reader->mapping);
+#else
+	munmap((void *)reader->region, reader->mappedSize);
+#endif
+	*reader = {};
+}
+
+u32 WinjumpSharedTableReader_BeginRead(const WinjumpSharedTableReader *const reader)
+{
+	const WinjumpSharedTableHeader *header = (const WinjumpSharedTableHeader *)reader->region;
+	u32 result = header->sequence;
+	WinjumpSharedTable_Barrier();
+	return result;
+}
+
+bool WinjumpSharedTableReader_EndRead(const WinjumpSharedTableReader *const reader, const u32 sequence)
+{
+	WinjumpSharedTable_Barrier();
+	const WinjumpSharedTableHeader *header = (const WinjumpSharedTableHeader *)reader->region;
+	bool result = ((sequence & 1) == 0 && header->sequence == sequence);
+	return result;
+}
+
+const WinjumpSharedTableHeader *WinjumpSharedTableReader_GetHeader(const WinjumpSharedTableReader *const reader)
+{
+	return (const WinjumpSharedTableHeader *)reader->region;
+}
+
+const WinjumpSharedTableEntry *WinjumpSharedTableReader_GetEntries(const WinjumpSharedTableReader *const reader,
+                                                                   i32 *const numEntries)
+{
+	const WinjumpSharedTableHeader *header = (const WinjumpSharedTableHeader *)reader->region;
+	u32 entriesOffset                      = DQN_MIN(header->entriesOffset, reader->regionSize);
+	u32 maxEntries                         = (reader->regionSize - entriesOffset) / (u32)sizeof(WinjumpSharedTableEntry);
+
+	*numEntries = (i32)DQN_MIN(header->numEntries, maxEntries);
+	return (const WinjumpSharedTableEntry *)(reader->region + entriesOffset);
+}
+
+const u16 *WinjumpSharedTableReader_GetText(const WinjumpSharedTableReader *const reader,
+                                            const WinjumpSharedTableEntry *const entry)
+{
+	const WinjumpSharedTableHeader *header = (const WinjumpSharedTableHeader *)reader->region;
+	u64 endOffset = (u64)header->textOffset + (sizeof(u16) * ((u64)entry->titleOffset + entry->titleLen + entry->exeLen));
+	if (endOffset > reader->regionSize) return NULL;
+
+	const u16 *result = (const u16 *)(reader->region + header->textOffset) + entry->titleOffset;
+	return result;
+}
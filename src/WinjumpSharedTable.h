@@ -0,0 +1,150 @@
+#ifndef WINJUMP_SHARED_TABLE_H
+#define WINJUMP_SHARED_TABLE_H
+
+#include "WinjumpCore.h"
+
+// Publishes the program table into a named shared memory region so other local processes, i.e.
+// status bars and scripts, can read it in place without copying it or making a syscall per read.
+// There is one writer, the owner of the core, and any number of readers. The writer never waits on
+// readers: it bumps a sequence counter to odd, rewrites the table and bumps it back to even. A
+// reader notes the sequence, reads what it needs and checks the sequence is unchanged, retrying if
+// a publish overlapped it (a seqlock).
+
+// Region layout, version 1. Little endian, offsets are in bytes from the start of the region unless
+// noted and text is UTF-16 code units without a terminator. The first 12 bytes of the header never
+// change once created, everything after the sequence may be mid rewrite whilst the sequence is odd.
+// Offset Size Header
+//  0      4   char magic[4] "WJST"
+//  4      4   u32  version, WINJUMP_SHARED_TABLE_VERSION
+//  8      4   u32  regionSize, bytes in the region including the header
+// 12      4   u32  sequence, odd whilst a publish is in progress
+// 16      4   u32  generation, changes each publish
+// 20      4   u32  numEntries
+// 24      4   u32  entriesOffset, numEntries WinjumpSharedTableEntry follow here
+// 28      4   u32  textOffset
+// 32      4   u32  textLen, in code units
+// 36      4   u32  numDropped, windows left out because the region is full
+// 40      4   u32  writerPid, the process publishing the table
+// 44     20   Reserved, 0
+//
+// Offset Size Entry, 24 bytes each
+//  0      8   u64  window, i.e. the HWND on Win32
+//  8      4   u32  pid
+// 12      4   u32  index, 1 based list index as displayed in Winjump
+// 16      4   u32  titleOffset, in code units from textOffset, the exe follows the title
+// 20      2   u16  titleLen
+// 22      2   u16  exeLen, 0 whilst the exe is still being resolved
+#define WINJUMP_SHARED_TABLE_VERSION 1
+#define WINJUMP_SHARED_TABLE_SIZE    DQN_MEGABYTE(4) // Fits ~20,000 windows with 64 character titles
+
+#if defined(DQN_IS_WIN32)
+	#define WINJUMP_SHARED_TABLE_NAME "Local\\WinjumpTable"
+#else
+	#define WINJUMP_SHARED_TABLE_NAME "/winjump_table"
+#endif
+
+struct WinjumpSharedTableHeader
+{
+	char         magic[4];
+	u32          version;
+	u32          regionSize;
+	u32 volatile sequence;
+	u32          generation;
+	u32          numEntries;
+	u32          entriesOffset;
+	u32          textOffset;
+	u32          textLen;
+	u32          numDropped;
+	u32          writerPid;
+	u8           reserved[20];
+};
+
+struct WinjumpSharedTableEntry
+{
+	u64 window;
+	u32 pid;
+	u32 index;
+	u32 titleOffset;
+	u16 titleLen;
+	u16 exeLen;
+};
+
+DQN_COMPILE_ASSERT(sizeof(WinjumpSharedTableHeader) == 64);
+DQN_COMPILE_ASSERT(sizeof(WinjumpSharedTableEntry) == 24);
+
+////////////////////////////////////////////////////////////////////////////////
+// Writing
+////////////////////////////////////////////////////////////////////////////////
+struct WinjumpSharedTable
+{
+	u8  *region;
+	char name[64];
+	u32  publishedGeneration; // WinjumpCore.tableGeneration of the last publish
+	bool hasPublished;
+#if defined(DQN_IS_WIN32)
+	HANDLE mapping;
+#endif
+};
+
+// Create the region, it's empty until the first publish. There can only be one writer per region,
+// so an existing region is only replaced if the writerPid in its header is no longer running, i.e.
+// it was left behind by a run that didn't exit cleanly. On Win32 the region lives on whilst readers
+// have it open, so it's taken over in place and emptied.
+// table:  Pass a pointer to a zero cleared WinjumpSharedTable.
+// name:   A shm_open() name on Unix, a file mapping name on Win32, i.e. WINJUMP_SHARED_TABLE_NAME.
+// return: FALSE if another process is already publishing at name, or the region could not be
+//         created or mapped.
+bool WinjumpSharedTable_Create(WinjumpSharedTable *const table, const char *const name);
+
+// Unmap and remove the region, readers that still have it mapped keep their view.
+void WinjumpSharedTable_Destroy(WinjumpSharedTable *const table);
+
+// Rewrite the region with the core's program table, does nothing if the table hasn't changed since
+// the last publish. Windows that don't fit in the region are left out and counted in numDropped.
+void WinjumpSharedTable_Publish(WinjumpSharedTable *const table, const WinjumpCore *const core);
+
+////////////////////////////////////////////////////////////////////////////////
+// Reading
+////////////////////////////////////////////////////////////////////////////////
+// NOTE: Read the table between BeginRead() and EndRead(), anything read is only valid if EndRead()
+// returns TRUE. The accessors clamp to the region so a read torn by a publish can't go out of it.
+//
+// for (;;)
+// {
+//     u32 sequence = WinjumpSharedTableReader_BeginRead(&reader);
+//     ... read entries and text ...
+//     if (WinjumpSharedTableReader_EndRead(&reader, sequence)) break;
+// }
+struct WinjumpSharedTableReader
+{
+	const u8 *region;
+	size_t    mappedSize;
+	u32       regionSize; // Bytes of the region the accessors may read
+#if defined(DQN_IS_WIN32)
+	HANDLE mapping;
+#endif
+};
+
+// return: FALSE if no table is published at name or it's a different version.
+bool WinjumpSharedTableReader_Open(WinjumpSharedTableReader *const reader, const char *const name);
+void WinjumpSharedTableReader_Close(WinjumpSharedTableReader *const reader);
+
+// NOTE: Never waits, if a publish is in progress the read is simply reported as torn by EndRead().
+// return: The sequence to pass to WinjumpSharedTableReader_EndRead().
+u32 WinjumpSharedTableReader_BeginRead(const WinjumpSharedTableReader *const reader);
+
+// return: TRUE if no publish overlapped the read since BeginRead() returned sequence.
+bool WinjumpSharedTableReader_EndRead(const WinjumpSharedTableReader *const reader, const u32 sequence);
+
+const WinjumpSharedTableHeader *WinjumpSharedTableReader_GetHeader(const WinjumpSharedTableReader *const reader);
+
+// return: The entries and their number, clamped to the region.
+const WinjumpSharedTableEntry *WinjumpSharedTableReader_GetEntries(const WinjumpSharedTableReader *const reader,
+                                                                   i32 *const numEntries);
+
+// return: The entry's title with its exe straight after, NULL if the entry is torn and points
+//         outside the region.
+const u16 *WinjumpSharedTableReader_GetText(const WinjumpSharedTableReader *const reader,
+                                            const WinjumpSharedTableEntry *const entry);
+
+#endif /* WINJUMP_SHARED_TABLE_H */
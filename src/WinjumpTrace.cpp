@@ -0,0 +1,303 @@
+#include "WinjumpTrace.h"
+
+#define DQN_PLATFORM_HEADER
+#include "dqn.h"
+
+FILE_SCOPE const char WINJUMP_TRACE_MAGIC[4] = {'W', 'J', 'T', 'R'};
+
+// NOTE: FNV-1a, only used to tell whether the table or query changed since the last record
+FILE_SCOPE u64 WinjumpTrace_Hash(u64 hash, const void *const data, const size_t size)
+{
+	const u8 *bytes = (const u8 *)data;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= (u64)bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+#define WINJUMP_TRACE_HASH_SEED 14695981039346656037ULL
+
+////////////////////////////////////////////////////////////////////////////////
+// Recording
+////////////////////////////////////////////////////////////////////////////////
+// NOTE: On OOM the recorder stops and WinjumpTraceRecorder_Write() reports the failure.
+FILE_SCOPE void WinjumpTraceRecorder_WriteBytes(WinjumpTraceRecorder *const recorder,
+                                                const void *const data, const size_t size)
+{
+	if (recorder->outOfMemory || size == 0) return;
+	if (!DqnArray_PushN(&recorder->buffer, (const u8 *)data, (u64)size)) recorder->outOfMemory = true;
+}
+
+FILE_SCOPE void WinjumpTraceRecorder_WriteU8 (WinjumpTraceRecorder *const recorder, const u8 val)  { WinjumpTraceRecorder_WriteBytes(recorder, &val, sizeof(val)); }
+FILE_SCOPE void WinjumpTraceRecorder_WriteU16(WinjumpTraceRecorder *const recorder, const u16 val) { WinjumpTraceRecorder_WriteBytes(recorder, &val, sizeof(val)); }
+FILE_SCOPE void WinjumpTraceRecorder_WriteU32(WinjumpTraceRecorder *const recorder, const u32 val) { WinjumpTraceRecorder_WriteBytes(recorder, &val, sizeof(val)); }
+FILE_SCOPE void WinjumpTraceRecorder_WriteU64(WinjumpTraceRecorder *const recorder, const u64 val) { WinjumpTraceRecorder_WriteBytes(recorder, &val, sizeof(val)); }
+FILE_SCOPE void WinjumpTraceRecorder_WriteF64(WinjumpTraceRecorder *const recorder, const f64 val) { WinjumpTraceRecorder_WriteBytes(recorder, &val, sizeof(val)); }
+
+// NOTE: wchar_t is UTF-16 on Win32 and UTF-32 elsewhere, characters outside the BMP are truncated
+// off Win32.
+FILE_SCOPE void WinjumpTraceRecorder_WriteWStr(WinjumpTraceRecorder *const recorder,
+                                               const wchar_t *const str, const i32 len)
+{
+	i32 numToWrite = DQN_MIN(len, 255);
+	WinjumpTraceRecorder_WriteU16(recorder, (u16)numToWrite);
+	for (i32 i = 0; i < numToWrite; i++)
+		WinjumpTraceRecorder_WriteU16(recorder, (u16)str[i]);
+}
+
+FILE_SCOPE void WinjumpTraceRecorder_BeginRecord(WinjumpTraceRecorder *const recorder,
+                                                 const WinjumpTraceRecord type)
+{
+	WinjumpTraceRecorder_WriteU8(recorder, (u8)type);
+	WinjumpTraceRecorder_WriteF64(recorder, DqnTimer_NowInMs() - recorder->startMs);
+}
+
+FILE_SCOPE void WinjumpTraceRecorder_SourceEnumerate(WinjumpWindowSource *const source, WinjumpCore *const core)
+{
+	WinjumpTraceRecorder *recorder = (WinjumpTraceRecorder *)source->userData;
+	recorder->innerSource->Enumerate(recorder->innerSource, core);
+
+	// NOTE: programArray is cleared before enumerating, so it's exactly what was just pushed
+	const DqnArray<WinjumpProgram> *programArray = &core->programArray;
+	u64 hash = WinjumpTrace_Hash(WINJUMP_TRACE_HASH_SEED, &programArray->count, sizeof(programArray->count));
+	for (i32 i = 0; i < (i32)programArray->count; i++)
+	{
+		const WinjumpProgram *program = &programArray->data[i];
+		hash = WinjumpTrace_Hash(hash, &program->window, sizeof(program->window));
+		hash = WinjumpTrace_Hash(hash, &program->pid, sizeof(program->pid));
+		hash = WinjumpTrace_Hash(hash, program->title, program->titleLen * sizeof(wchar_t));
+	}
+
+	if (hash == recorder->lastSnapshotHash) return;
+	recorder->lastSnapshotHash = hash;
+
+	DqnLock_Acquire(&recorder->lock);
+	WinjumpTraceRecorder_BeginRecord(recorder, WinjumpTraceRecord_Snapshot);
+	WinjumpTraceRecorder_WriteU32(recorder, (u32)programArray->count);
+	for (i32 i = 0; i < (i32)programArray->count; i++)
+	{
+		const WinjumpProgram *program = &programArray->data[i];
+		WinjumpTraceRecorder_WriteU64(recorder, (u64)(size_t)program->window);
+		WinjumpTraceRecorder_WriteU32(recorder, program->pid);
+		WinjumpTraceRecorder_WriteWStr(recorder, program->title, program->titleLen);
+	}
+	DqnLock_Release(&recorder->lock);
+}
+
+FILE_SCOPE i32 WinjumpTraceRecorder_SourceResolveExe(WinjumpWindowSource *const source, const u32 pid,
+                                                     wchar_t *const exe, const i32 exeSize)
+{
+	WinjumpTraceRecorder *recorder = (WinjumpTraceRecorder *)source->userData;
+	i32 result = recorder->innerSource->ResolveExe(recorder->innerSource, pid, exe, exeSize);
+
+	DqnLock_Acquire(&recorder->lock);
+	WinjumpTraceRecorder_BeginRecord(recorder, WinjumpTraceRecord_Exe);
+	WinjumpTraceRecorder_WriteU32(recorder, pid);
+	WinjumpTraceRecorder_WriteWStr(recorder, exe, result);
+	DqnLock_Release(&recorder->lock);
+	return result;
+}
+
+FILE_SCOPE void WinjumpTraceRecorder_SourceOnExeResolved(WinjumpWindowSource *const source)
+{
+	WinjumpTraceRecorder *recorder = (WinjumpTraceRecorder *)source->userData;
+	WinjumpWindowSource *inner     = recorder->innerSource;
+	if (inner->OnExeResolved) inner->OnExeResolved(inner);
+}
+
+bool WinjumpTraceRecorder_Init(WinjumpTraceRecorder *const recorder, WinjumpWindowSource *const innerSource)
+{
+	if (!recorder || !innerSource) return false;
+
+	*recorder                      = {};
+	recorder->innerSource          = innerSource;
+	recorder->source.Enumerate     = WinjumpTraceRecorder_SourceEnumerate;
+	recorder->source.ResolveExe    = WinjumpTraceRecorder_SourceResolveExe;
+	recorder->source.OnExeResolved = WinjumpTraceRecorder_SourceOnExeResolved;
+	recorder->source.userData      = recorder;
+	recorder->startMs              = DqnTimer_NowInMs();
+
+	if (!DqnLock_Init(&recorder->lock)) return false;
+	if (!DqnArray_Init(&recorder->buffer, DQN_KILOBYTE(64))) return false;
+
+	WinjumpTraceRecorder_WriteBytes(recorder, WINJUMP_TRACE_MAGIC, sizeof(WINJUMP_TRACE_MAGIC));
+	WinjumpTraceRecorder_WriteU32(recorder, WINJUMP_TRACE_VERSION);
+	return !recorder->outOfMemory;
+}
+
+void WinjumpTraceRecorder_Free(WinjumpTraceRecorder *const recorder)
+{
+	DqnArray_Free(&recorder->buffer);
+	DqnLock_Delete(&recorder->lock);
+}
+
+void WinjumpTraceRecorder_RecordQuery(WinjumpTraceRecorder *const recorder, const wchar_t *const query,
+                                      const i32 queryLen)
+{
+	u64 hash = WinjumpTrace_Hash(WINJUMP_TRACE_HASH_SEED, query, queryLen * sizeof(wchar_t));
+	if (hash == recorder->lastQueryHash && queryLen == recorder->lastQueryLen) return;
+	recorder->lastQueryHash = hash;
+	recorder->lastQueryLen  = queryLen;
+
+	DqnLock_Acquire(&recorder->lock);
+	WinjumpTraceRecorder_BeginRecord(recorder, WinjumpTraceRecord_Query);
+	WinjumpTraceRecorder_WriteWStr(recorder, query, queryLen);
+	DqnLock_Release(&recorder->lock);
+}
+
+bool WinjumpTraceRecorder_Write(WinjumpTraceRecorder *const recorder, const char *const path)
+{
+	DqnLock_Acquire(&recorder->lock);
+	bool result = false;
+	if (!recorder->outOfMemory)
+	{
+		DqnFile file = {};
+		if (DqnFile_Open(path, &file, DqnFilePermissionFlag_Write, DqnFileAction_ClearIfExist) ||
+		    DqnFile_Open(path, &file, DqnFilePermissionFlag_Write, DqnFileAction_CreateIfNotExist))
+		{
+			size_t bytesToWrite = (size_t)recorder->buffer.count;
+			result = (DqnFile_Write(&file, recorder->buffer.data, bytesToWrite, 0) == bytesToWrite);
+			DqnFile_Close(&file);
+		}
+	}
+	DqnLock_Release(&recorder->lock);
+
+	return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reading
+////////////////////////////////////////////////////////////////////////////////
+typedef struct WinjumpTraceReader
+{
+	const u8 *data;
+	size_t    size;
+	size_t    offset;
+	bool      isValid; // Cleared once a read goes past the end of the data
+} WinjumpTraceReader;
+
+FILE_SCOPE void WinjumpTraceReader_ReadBytes(WinjumpTraceReader *const reader, void *const dest, const size_t size)
+{
+	if (!reader->isValid || reader->offset + size > reader->size)
+	{
+		reader->isValid = false;
+		memset(dest, 0, size);
+		return;
+	}
+
+	memcpy(dest, reader->data + reader->offset, size);
+	reader->offset += size;
+}
+
+FILE_SCOPE u8  WinjumpTraceReader_ReadU8 (WinjumpTraceReader *const reader) { u8  result; WinjumpTraceReader_ReadBytes(reader, &result, sizeof(result)); return result; }
+FILE_SCOPE u16 WinjumpTraceReader_ReadU16(WinjumpTraceReader *const reader) { u16 result; WinjumpTraceReader_ReadBytes(reader, &result, sizeof(result)); return result; }
+FILE_SCOPE u32 WinjumpTraceReader_ReadU32(WinjumpTraceReader *const reader) { u32 result; WinjumpTraceReader_ReadBytes(reader, &result, sizeof(result)); return result; }
+FILE_SCOPE u64 WinjumpTraceReader_ReadU64(WinjumpTraceReader *const reader) { u64 result; WinjumpTraceReader_ReadBytes(reader, &result, sizeof(result)); return result; }
+FILE_SCOPE f64 WinjumpTraceReader_ReadF64(WinjumpTraceReader *const reader) { f64 result; WinjumpTraceReader_ReadBytes(reader, &result, sizeof(result)); return result; }
+
+// return: The length of the string written to str, which is null terminated.
+FILE_SCOPE i32 WinjumpTraceReader_ReadWStr(WinjumpTraceReader *const reader, wchar_t *const str, const i32 strSize)
+{
+	i32 len    = (i32)WinjumpTraceReader_ReadU16(reader);
+	i32 result = 0;
+	for (i32 i = 0; i < len; i++)
+	{
+		wchar_t c = (wchar_t)WinjumpTraceReader_ReadU16(reader);
+		if (result < strSize - 1) str[result++] = c;
+	}
+
+	str[result] = 0;
+	return result;
+}
+
+bool WinjumpTrace_Read(WinjumpTrace *const trace, const char *const path)
+{
+	if (!trace) return false;
+
+	size_t size = 0;
+	if (!DqnFile_GetFileSize(path, &size) || size < sizeof(WINJUMP_TRACE_MAGIC) + sizeof(u32))
+		return false;
+
+	u8 *data = (u8 *)DqnMem_Alloc(size);
+	if (!data) return false;
+
+	size_t bytesRead = 0;
+	bool result      = DqnFile_ReadEntireFile(path, data, size, &bytesRead) && bytesRead == size;
+	result           = result && DqnArray_Init(&trace->events, 64);
+	result           = result && DqnArray_Init(&trace->windows, 256);
+
+	WinjumpTraceReader reader = {};
+	reader.data               = data;
+	reader.size               = size;
+	reader.isValid            = result;
+
+	char magic[sizeof(WINJUMP_TRACE_MAGIC)];
+	WinjumpTraceReader_ReadBytes(&reader, magic, sizeof(magic));
+	u32 version = WinjumpTraceReader_ReadU32(&reader);
+	if (memcmp(magic, WINJUMP_TRACE_MAGIC, sizeof(magic)) != 0 || version != WINJUMP_TRACE_VERSION)
+		reader.isValid = false;
+
+	while (reader.isValid && reader.offset < reader.size)
+	{
+		WinjumpTraceEvent event = {};
+		u8 type                 = WinjumpTraceReader_ReadU8(&reader);
+		event.type              = (WinjumpTraceRecord)type;
+		event.timeMs            = WinjumpTraceReader_ReadF64(&reader);
+
+		switch (type)
+		{
+			case WinjumpTraceRecord_Snapshot:
+			{
+				u32 numWindows    = WinjumpTraceReader_ReadU32(&reader);
+				event.firstWindow = (i32)trace->windows.count;
+				for (u32 i = 0; reader.isValid && i < numWindows; i++)
+				{
+					WinjumpTraceWindow window = {};
+					window.window   = WinjumpTraceReader_ReadU64(&reader);
+					window.pid      = WinjumpTraceReader_ReadU32(&reader);
+					window.titleLen = WinjumpTraceReader_ReadWStr(&reader, window.title, DQN_ARRAY_COUNT(window.title));
+					if (!DqnArray_Push(&trace->windows, window)) reader.isValid = false;
+				}
+				event.numWindows = (i32)trace->windows.count - event.firstWindow;
+			}
+			break;
+
+			case WinjumpTraceRecord_Exe:
+			{
+				event.pid     = WinjumpTraceReader_ReadU32(&reader);
+				event.textLen = WinjumpTraceReader_ReadWStr(&reader, event.text, DQN_ARRAY_COUNT(event.text));
+			}
+			break;
+
+			case WinjumpTraceRecord_Query:
+			{
+				event.textLen = WinjumpTraceReader_ReadWStr(&reader, event.text, DQN_ARRAY_COUNT(event.text));
+			}
+			break;
+
+			default:
+			{
+				reader.isValid = false;
+			}
+			break;
+		}
+
+		if (reader.isValid && !DqnArray_Push(&trace->events, event)) reader.isValid = false;
+	}
+
+	DqnMem_Free(data);
+	if (!reader.isValid)
+	{
+		WinjumpTrace_Free(trace);
+		return false;
+	}
+
+	return true;
+}
+
+void WinjumpTrace_Free(WinjumpTrace *const trace)
+{
+	DqnArray_Free(&trace->events);
+	DqnArray_Free(&trace->windows);
+}
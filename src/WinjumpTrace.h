@@ -0,0 +1,95 @@
+#ifndef WINJUMP_TRACE_H
+#define WINJUMP_TRACE_H
+
+#include "WinjumpCore.h"
+
+// Recording of a Winjump session for replaying against the core. A trace is the window table
+// whenever an enumeration sees it change, each exe as it's resolved and each edit of the search
+// box, all timestamped from the start of the recording.
+
+// File format, little endian, strings are UTF-16 code units without a terminator.
+// Header:   char magic[4] "WJTR", u32 version
+// Record:   u8 WinjumpTraceRecord, f64 timeMs, then by type
+// Snapshot: u32 numWindows, then per window u64 window, u32 pid, u16 titleLen, u16 title[titleLen]
+// Exe:      u32 pid, u16 exeLen, u16 exe[exeLen]
+// Query:    u16 len, u16 query[len]
+#define WINJUMP_TRACE_VERSION 1
+
+enum WinjumpTraceRecord
+{
+	WinjumpTraceRecord_Snapshot,
+	WinjumpTraceRecord_Exe,
+	WinjumpTraceRecord_Query,
+	WinjumpTraceRecord_Count,
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Recording
+////////////////////////////////////////////////////////////////////////////////
+// Wraps the platform's window source, recording each enumeration and resolved exe as they pass
+// through to the core.
+struct WinjumpTraceRecorder
+{
+	WinjumpWindowSource  source;      // Give this to WinjumpCore_Init() in place of innerSource
+	WinjumpWindowSource *innerSource;
+
+	DqnLock      lock; // Exes are recorded from the exe resolve threads
+	DqnArray<u8> buffer;
+	bool         outOfMemory;
+	f64          startMs;
+
+	u64 lastSnapshotHash; // Enumerations that don't change the table aren't recorded
+	u64 lastQueryHash;
+	i32 lastQueryLen;
+};
+
+// innerSource: Must outlive the recorder.
+// return:      FALSE if out of memory or the lock could not be created.
+bool WinjumpTraceRecorder_Init(WinjumpTraceRecorder *const recorder, WinjumpWindowSource *const innerSource);
+void WinjumpTraceRecorder_Free(WinjumpTraceRecorder *const recorder);
+
+// Record the contents of the search box, does nothing if it hasn't changed since the last call.
+void WinjumpTraceRecorder_RecordQuery(WinjumpTraceRecorder *const recorder, const wchar_t *const query,
+                                      const i32 queryLen);
+
+// return: FALSE if recording ran out of memory or the file could not be written.
+bool WinjumpTraceRecorder_Write(WinjumpTraceRecorder *const recorder, const char *const path);
+
+////////////////////////////////////////////////////////////////////////////////
+// Reading
+////////////////////////////////////////////////////////////////////////////////
+struct WinjumpTraceWindow
+{
+	u64     window;
+	u32     pid;
+	wchar_t title[256];
+	i32     titleLen;
+};
+
+struct WinjumpTraceEvent
+{
+	WinjumpTraceRecord type;
+	f64                timeMs;
+
+	// Snapshot, the range of WinjumpTrace.windows that make up the table
+	i32 firstWindow;
+	i32 numWindows;
+
+	// Exe, the pid and exe name. Query, the search box contents in text.
+	u32     pid;
+	wchar_t text[256];
+	i32     textLen;
+};
+
+struct WinjumpTrace
+{
+	DqnArray<WinjumpTraceEvent>  events;
+	DqnArray<WinjumpTraceWindow> windows;
+};
+
+// trace:  Pass a pointer to a zero cleared WinjumpTrace, free with WinjumpTrace_Free().
+// return: FALSE if the file could not be read, is not a trace or out of memory.
+bool WinjumpTrace_Read(WinjumpTrace *const trace, const char *const path);
+void WinjumpTrace_Free(WinjumpTrace *const trace);
+
+#endif /* WINJUMP_TRACE_H */
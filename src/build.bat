@@ -42,7 +42,7 @@ REM Include directories
 set includeFlags=
 
 REM Link libraries
-set linkLibraries=user32.lib gdi32.lib shlwapi.lib Comctl32.lib Comdlg32.lib
+set linkLibraries=user32.lib gdi32.lib shlwapi.lib Comctl32.lib Comdlg32.lib advapi32.lib
 
 REM incremental:no, turn incremental builds off
 REM opt:ref,        try to remove functions from libs that are not referenced at all
@@ -34,7 +34,10 @@
 // #DqnMem       Memory Allocation
 // #DqnMemStack  Memory Allocator, Push, Pop Style
 // #DqnMemAPI    Custom memory API for Dqn Data Structures
+// #DqnMemPool   Fixed Size Block Pool Allocator
+// #DqnScratch   Thread Local Scratch Arenas
 // #DqnArray     CPP Dynamic Array with Templates
+// #DqnHashMap   CPP Open Addressing Hash Map with Templates
 // #DqnMath      Simple Math Helpers (Lerp etc.)
 // #DqnV2        2D  Math Vectors
 // #DqnV3        3D  Math Vectors
@@ -45,7 +48,9 @@
 // #DqnStr       Str   Operations (Str_Len(), Str_Copy() etc)
 // #DqnWChar     WChar Operations (IsDigit(), IsAlpha() etc)
 // #DqnWStr      WStr  Operations (WStr_Len() etc)
+// #DqnString   CPP Owned String with Length and Small String Storage
 // #DqnRnd       Random Number Generator (ints and floats)
+// #DqnTimerWheel Hierarchical Timer Wheel (Scheduled Callbacks)
 // #Dqn_*        Utility code, (qsort, quick file reading)
 
 // #XPlatform (Win32 & Unix)
@@ -53,7 +58,10 @@
 // #DqnDir       Directory Querying
 // #DqnTimer     High Resolution Timer
 // #DqnLock      Mutex Synchronisation
+// #DqnMemPoolThreadCache Per Thread Cache over a Shared DqnMemPool
+// #DqnMemStackConcurrent Lock Free Push Only Stack Shared Between Threads
 // #DqnJobQueue  Multithreaded Job Queue
+// #DqnJobGraph  Job Dependency Graph on the Job Queue
 // #DqnAtomic    Interlocks/Atomic Operations
 // #DqnPlatform  Common Platform API helpers
 
@@ -69,7 +77,6 @@
 // - DqnMemStack
 //   - Allow 0 size memblock stack initialisation/block-less stack for situations where you don't
 //     care about specifying a size upfront
-//   - Default block size for when new blocks are required
 //
 // - Win32
 //   - Get rid of reliance on MAX_PATH
@@ -205,6 +212,17 @@ DQN_FILE_SCOPE void  DqnMem_Clear  (void *const memory, const u8 clearValue, con
 DQN_FILE_SCOPE void *DqnMem_Realloc(void *memory, const size_t newSize);
 DQN_FILE_SCOPE void  DqnMem_Free   (void *memory);
 
+// NOTE: Running totals of calls into the functions above, for measuring allocations in benchmarks.
+// Not atomic, counts are only exact whilst a single thread is allocating.
+typedef struct DqnMemStats
+{
+	u64 numAllocs;   // Alloc and Calloc
+	u64 numReallocs;
+	u64 numFrees;
+} DqnMemStats;
+
+DQN_FILE_SCOPE DqnMemStats DqnMem_GetStats();
+
 ////////////////////////////////////////////////////////////////////////////////
 // #DqnMemStack Public API - Memory Allocator, Push, Pop Style
 ////////////////////////////////////////////////////////////////////////////////
@@ -225,6 +243,9 @@ DQN_FILE_SCOPE void  DqnMem_Free   (void *memory);
 //    - InitWithFixedSize() allows you to to disable dynamic allocations and
 //      sub-allocate from the initial MemStack allocation size only.
 
+//    - InitWithVirtualMem() reserves a large range of address space and only
+//      backs it with memory as it's used, so allocations never move.
+
 // 2. Use DqnMemStack_Push(..) to allocate memory for use.
 //    - "Freeing" memory is dealt by creating temporary MemStacks or using the
 //      BeginTempRegion and EndTempRegion functions. Specifically freeing
@@ -236,6 +257,33 @@ enum DqnMemStackFlag
 
 	// NOTE(doyle): Required to indicate we CAN'T free this memory when free is called.
 	DqnMemStackFlag_IsFixedMemoryFromUser = (1 << 1),
+
+	// The single block is reserved address space, committed as the stack is pushed onto
+	DqnMemStackFlag_IsVirtualMemory       = (1 << 2),
+};
+
+// NOTE: A new block is this many times the size of the current one, up to the max block size, so a
+// stack that keeps outgrowing its blocks needs few of them. Requests larger than the max get a
+// block of their own size. Define before including to change it for every stack, or set
+// DqnMemStack.blockGrowthFactor/maxBlockSize to change it for one stack.
+#ifndef DQN_MEM_STACK_BLOCK_GROWTH_FACTOR
+	#define DQN_MEM_STACK_BLOCK_GROWTH_FACTOR 2.0f
+#endif
+
+#ifndef DQN_MEM_STACK_MAX_BLOCK_SIZE
+	#define DQN_MEM_STACK_MAX_BLOCK_SIZE DQN_MEGABYTE(64)
+#endif
+
+// Virtual memory stacks commit pages in multiples of this, must be a power of 2
+#ifndef DQN_MEM_STACK_COMMIT_SIZE
+	#define DQN_MEM_STACK_COMMIT_SIZE DQN_KILOBYTE(64)
+#endif
+#define DQN_MEM_STACK_HUGE_PAGE_SIZE DQN_MEGABYTE(2)
+
+enum DqnMemStackVirtualFlag
+{
+	// Back the range with huge pages where the OS allows it, see DqnMemStack_InitWithVirtualMem()
+	DqnMemStackVirtualFlag_HugePages = (1 << 0),
 };
 
 typedef struct DqnMemStack
@@ -250,19 +298,24 @@ typedef struct DqnMemStack
 	// Allocations are address aligned to this value. Not to be modified as popping allocations uses this to realign size
 	u32 byteAlign;
 
+	f32    blockGrowthFactor; // 0 uses DQN_MEM_STACK_BLOCK_GROWTH_FACTOR, 1 sizes new blocks like the current one
+	size_t maxBlockSize;      // 0 uses DQN_MEM_STACK_MAX_BLOCK_SIZE
+
 #if defined(DQN_CPP_MODE)
 	// Initialisation API
 	bool  InitWithFixedMem (u8 *const mem,     const size_t memSize, const u32 byteAlignment = 4);
 	bool  InitWithFixedSize(const size_t size, const bool zeroClear, const u32 byteAlignment = 4);
 	bool  Init             (const size_t size, const bool zeroClear, const u32 byteAlignment = 4);
+	bool  InitWithVirtualMem(const size_t reserveSize, const u32 virtualFlags = 0, const u32 byteAlignment = 4);
 
 	// Memory API
-	void *Push(size_t size);
-	void  Pop (void *const ptr, size_t size);
+	void *Push(size_t size, const u32 alignment = 0);
+	void  Pop (void *const ptr, size_t size, const u32 alignment = 0);
 	void  Free();
 	bool  FreeMemBlock  (DqnMemStackBlock *memBlock);
 	bool  FreeLastBlock ();
 	void  ClearCurrBlock(const bool zeroClear);
+	bool  DecommitUnused(const size_t keepSize = 0);
 
 	// Temporary Regions API
 	struct DqnMemStackTempRegion TempRegionBegin();
@@ -300,16 +353,34 @@ DQN_FILE_SCOPE bool DqnMemStack_InitWithFixedSize(DqnMemStack *const stack, size
 // DqnMem_Calloc().
 DQN_FILE_SCOPE bool DqnMemStack_Init(DqnMemStack *const stack, size_t size, const bool zeroClear, const u32 byteAlign = 4);
 
+// Reserves reserveSize bytes of address space in a single block and commits pages as the stack is
+// pushed onto, so nothing is ever relocated and the last allocation can always grow in place, i.e.
+// arrays using DqnMemAPI_StackAllocator(). Requires DQN_WIN32_IMPLEMENTATION or
+// DQN_UNIX_IMPLEMENTATION. Memory is zero when first committed, like DqnMem_Calloc().
+// reserveSize:  The most the stack can ever hold. Reserving costs address space only, so be generous.
+//               Rounded up to DQN_MEM_STACK_COMMIT_SIZE, or the huge page size.
+// virtualFlags: Bits from enum DqnMemStackVirtualFlag. With huge pages Unix madvise()'s the range
+//               for transparent huge pages and commits 2MB at a time. Win32 commits the whole range
+//               up front with MEM_LARGE_PAGES, which needs the lock pages privilege. Falls back to
+//               regular pages silently if not available.
+// return:       FALSE if args are invalid, there's no platform implementation or the address space
+//               could not be reserved.
+DQN_FILE_SCOPE bool DqnMemStack_InitWithVirtualMem(DqnMemStack *const stack, const size_t reserveSize, const u32 virtualFlags = 0, const u32 byteAlign = 4);
+
 ////////////////////////////////////////////////////////////////////////////////
 //  DqnMemStack Memory Operations
 ////////////////////////////////////////////////////////////////////////////////
 // Allocate memory from the MemStack.
-// size:   "size" gets aligned to the byte alignment of the stack. 
+// size:      "size" gets aligned to the byte alignment of the stack.
+// alignment: Align this allocation's address to more than the stack's byteAlign, i.e. 64 for SIMD
+//            buffers. Must be a power of 2, 0 uses the stack's byteAlign. The padding before such an
+//            allocation is recorded in front of it so popping it gives the padding back too.
 // return: NULL if out of space OR stack is using fixed memory/size OR stack full and platform malloc fails.
-DQN_FILE_SCOPE void *DqnMemStack_Push(DqnMemStack *const stack, size_t size);
+DQN_FILE_SCOPE void *DqnMemStack_Push(DqnMemStack *const stack, size_t size, const u32 alignment = 0);
 
 // Frees the given ptr. It MUST be the last allocated item in the stack, fails otherwise.
-DQN_FILE_SCOPE bool  DqnMemStack_Pop(DqnMemStack *const stack, void *ptr, size_t size);
+// alignment: The alignment it was pushed with, so the padding in front of it is popped as well.
+DQN_FILE_SCOPE bool  DqnMemStack_Pop(DqnMemStack *const stack, void *ptr, size_t size, const u32 alignment = 0);
 
 // Frees all blocks belonging to this stack.
 DQN_FILE_SCOPE void  DqnMemStack_Free(DqnMemStack *const stack);
@@ -325,6 +396,12 @@ DQN_FILE_SCOPE bool  DqnMemStack_FreeLastBlock(DqnMemStack *const stack);
 // Reset the current memory block usage to 0.
 DQN_FILE_SCOPE void  DqnMemStack_ClearCurrBlock(DqnMemStack *const stack, const bool zeroClear);
 
+// Return the committed pages past what's in use to the OS, they read as zero if committed again.
+// Clearing a virtual memory stack keeps its pages, call this after to shrink it back down.
+// keepSize: Bytes past the used amount to leave committed, so the next pushes don't fault straight back in.
+// return:   FALSE if the stack isn't backed by virtual memory.
+DQN_FILE_SCOPE bool  DqnMemStack_DecommitUnused(DqnMemStack *const stack, const size_t keepSize = 0);
+
 ////////////////////////////////////////////////////////////////////////////////
 //  DqnMemStack Temporary Regions
 ////////////////////////////////////////////////////////////////////////////////
@@ -377,6 +454,11 @@ typedef struct DqnMemStackBlock
 	size_t  size;
 	size_t  used;
 
+	// Bytes of memory backed by pages, only less than size for virtual memory blocks which commit
+	// commitSize bytes at a time. commitSize is 0 if the block was committed in full up front.
+	size_t  committed;
+	size_t  commitSize;
+
 	// The allocator uses a linked list approach for additional blocks beyond capacity
 	DqnMemStackBlock *prevBlock;
 } DqnMemStackBlock;
@@ -459,12 +541,200 @@ typedef struct DqnMemAPI
 } DqnMemAPI;
 
 DQN_FILE_SCOPE DqnMemAPI DqnMemAPI_DefaultUseCalloc();
+
+// Allocate from a DqnMemStack, zero cleared like DqnMemAPI_DefaultUseCalloc(). Freeing or
+// reallocing the stack's last allocation is done in place, so containers used in LIFO order give
+// their memory back. Other frees are ignored and the memory is reclaimed when the stack is cleared,
+// i.e. containers in an arena are dropped together by resetting it instead of freeing each one.
+// stack:  Must outlive the data structures using the API. Its byteAlign must suit their types.
+DQN_FILE_SCOPE DqnMemAPI DqnMemAPI_StackAllocator(DqnMemStack *const stack);
+
+// NOTE: Used by the DqnArray templates, so they're defined here for translation units that only
+// include the header.
+FILE_SCOPE inline DqnMemAPICallbackInfo
+DqnMemAPIInternal_CallbackInfoAskRealloc(const DqnMemAPI memAPI,
+                                         void *const oldMemPtr,
+                                         const size_t oldSize,
+                                         const size_t newSize)
+{
+	DqnMemAPICallbackInfo info = {0};
+	info.type           = DqnMemAPICallbackType_Realloc;
+	info.userContext    = memAPI.userContext;
+	info.newRequestSize = newSize;
+	info.oldMemPtr      = oldMemPtr;
+	info.oldSize        = oldSize;
+	return info;
+}
+
+FILE_SCOPE inline DqnMemAPICallbackInfo
+DqnMemAPIInternal_CallbackInfoAskAlloc(const DqnMemAPI memAPI,
+                                       const size_t size)
+{
+	DqnMemAPICallbackInfo info = {0};
+	info.type        = DqnMemAPICallbackType_Alloc;
+	info.userContext = memAPI.userContext;
+	info.requestSize = size;
+	return info;
+}
+
+FILE_SCOPE inline DqnMemAPICallbackInfo DqnMemAPIInternal_CallbackInfoAskFree(
+    const DqnMemAPI memAPI, void *const ptrToFree, const size_t sizeToFree)
+{
+	DqnMemAPICallbackInfo info = {0};
+	info.type        = DqnMemAPICallbackType_Free;
+	info.userContext = memAPI.userContext;
+	info.ptrToFree   = ptrToFree;
+	info.sizeToFree  = sizeToFree;
+	return info;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// #DqnMemPool Public API - Fixed Size Block Pool Allocator
+////////////////////////////////////////////////////////////////////////////////
+// Hands out items of one fixed size in O(1), suballocated from slabs of itemsPerSlab items that
+// come from the memAPI. Freed items go onto an intrusive free list and are handed out again before
+// the newest slab is bumped any further, so objects that constantly churn (list nodes, records)
+// don't go back to the heap each time. Slabs are only returned when the pool is cleared or freed.
+
+// Not thread safe, threads can share a pool through DqnMemPoolThreadCache in the XPlatform layer.
+typedef struct DqnMemPoolSlab
+{
+	struct DqnMemPoolSlab *prevSlab;
+	u8                    *items;
+	u32                    used; // Items bumped out of the slab so far
+} DqnMemPoolSlab;
+
+typedef struct DqnMemPool
+{
+	DqnMemAPI       memAPI;    // Slabs are allocated from here
+	DqnMemPoolSlab *slab;      // The newest slab, the only one still being bumped
+	void           *freeList;  // Freed items, each holds a pointer to the next
+
+	size_t itemSize;           // Requested size rounded up to fit a free list pointer and to byteAlign
+	u32    itemsPerSlab;
+	u32    byteAlign;
+
+	u32 numSlabs;
+	u64 numItemsInUse;
+
+#if defined(DQN_CPP_MODE)
+	bool  Init    (const size_t itemSize, const u32 itemsPerSlab, const DqnMemAPI memAPI_ = DqnMemAPI_DefaultUseCalloc(), const u32 byteAlignment = 16);
+	void *Alloc   (const bool zeroClear = true);
+	void  FreeItem(void *const item);
+	void  Clear   ();
+	void  Free    ();
+#endif
+} DqnMemPool;
+
+// pool:         Pass in a pointer to a zero cleared DqnMemPool struct.
+// itemSize:     Bytes per item, rounded up to at least a pointer and to byteAlign.
+// itemsPerSlab: Items allocated from the memAPI at a time.
+// byteAlign:    Alignment of every item, must be a power of 2.
+// return:       FALSE if args are invalid. No memory is allocated until the first alloc.
+DQN_FILE_SCOPE bool  DqnMemPool_Init    (DqnMemPool *const pool, const size_t itemSize, const u32 itemsPerSlab, const DqnMemAPI memAPI = DqnMemAPI_DefaultUseCalloc(), const u32 byteAlign = 16);
+
+// return: NULL if a new slab was needed and the memAPI is out of memory.
+DQN_FILE_SCOPE void *DqnMemPool_Alloc   (DqnMemPool *const pool, const bool zeroClear = true);
+
+// item: Must have come from this pool. NULL is ignored.
+DQN_FILE_SCOPE void  DqnMemPool_FreeItem(DqnMemPool *const pool, void *const item);
+
+// Give every item back to the pool at once, keeping the newest slab to allocate from.
+DQN_FILE_SCOPE void  DqnMemPool_Clear   (DqnMemPool *const pool);
+
+// Return every slab to the memAPI, any items still held are invalid.
+DQN_FILE_SCOPE void  DqnMemPool_Free    (DqnMemPool *const pool);
+
+// Allocate from a DqnMemPool, zero cleared like DqnMemAPI_DefaultUseCalloc(). Requests larger than
+// the pool's itemSize fail and reallocs that still fit are done in place, i.e. for data structures
+// that allocate nodes of one size.
+// pool: Must outlive the data structures using the API.
+DQN_FILE_SCOPE DqnMemAPI DqnMemAPI_PoolAllocator(DqnMemPool *const pool);
+
+////////////////////////////////////////////////////////////////////////////////
+// #DqnScratch Public API - Thread Local Scratch Arenas
+////////////////////////////////////////////////////////////////////////////////
+// Every thread has DQN_SCRATCH_NUM_ARENAS stacks for temporary memory that doesn't outlive the
+// function using it, so callers don't need to own and pass a stack around for it. Take memory
+// inside a temp region, i.e. with DqnScratchGuard, and it's given back when the region ends.
+// Arenas are created on first use. With a platform implementation they reserve
+// DQN_SCRATCH_RESERVE_SIZE of virtual memory, so they never chain blocks, otherwise they're
+// expandable stacks of DQN_SCRATCH_BLOCK_SIZE.
+
+// Nesting: A function that allocates its result on a stack it was given, and also wants scratch,
+// must pass that stack as the conflict. If the given stack is itself a scratch arena, the function
+// then gets the other one, otherwise ending its region would free the result it's building.
+
+// wchar_t *BuildName(DqnMemStack *const resultStack)
+// {
+//     DqnScratchGuard scratch(resultStack);
+//     wchar_t *tmp = (wchar_t *)scratch.Push(1024 * sizeof(wchar_t));
+//     ... build into tmp then copy the result onto resultStack ...
+// }
+#define DQN_SCRATCH_NUM_ARENAS 2
+
+#ifndef DQN_SCRATCH_RESERVE_SIZE
+	#define DQN_SCRATCH_RESERVE_SIZE DQN_MEGABYTE(64)
+#endif
+
+#ifndef DQN_SCRATCH_BLOCK_SIZE
+	#define DQN_SCRATCH_BLOCK_SIZE DQN_KILOBYTE(64)
+#endif
+
+#if defined(_MSC_VER)
+	#define DQN_THREAD_LOCAL __declspec(thread)
+#else
+	#define DQN_THREAD_LOCAL __thread
+#endif
+
+// conflict: A stack the caller is allocating a result on, the arena returned is never it. Can be NULL.
+// return:   NULL if the arena could not be created.
+DQN_FILE_SCOPE DqnMemStack *DqnScratch_Get(const DqnMemStack *const conflict = NULL);
+
+// Get a scratch arena and begin a temp region on it, end it with DqnMemStackTempRegion_End().
+// region: Pass in a pointer to a zero cleared DqnMemStackTempRegion struct.
+// return: NULL if the arena could not be created, in which case there's no region to end.
+DQN_FILE_SCOPE DqnMemStack *DqnScratch_Begin(DqnMemStackTempRegion *const region, const DqnMemStack *const conflict = NULL);
+
+// Free the calling thread's arenas, i.e. before a thread that used them exits. No regions may be open.
+DQN_FILE_SCOPE void DqnScratch_FreeThreadArenas();
+
+#ifdef DQN_CPP_MODE
+// Begins a temp region on a scratch arena on construction and ends it on destruction.
+struct DqnScratchGuard
+{
+	DqnMemStack *arena; // NULL if the arena could not be created
+
+	 DqnScratchGuard(const DqnMemStack *const conflict = NULL);
+	~DqnScratchGuard();
+
+	// return: NULL if out of memory.
+	void *Push(const size_t size);
+
+private:
+	DqnMemStackTempRegion region;
+};
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 // #DqnArray Public API - CPP Dynamic Array with Templates
 ////////////////////////////////////////////////////////////////////////////////
 // Cplusplus mode only since it uses templates
 
 #ifdef DQN_CPP_MODE
+#include <new>         // Placement new
+#include <type_traits> // std::is_trivially_copyable
+#include <utility>     // std::move
+
+// NOTE: Capacity is multiplied by this each time an array grows. Define it before including to
+// change it for every array, or set DqnArray.growthFactor to change it for one array.
+#ifndef DQN_ARRAY_GROWTH_FACTOR
+	#define DQN_ARRAY_GROWTH_FACTOR 2.0f
+#endif
+
+// NOTE: Trivially copyable types are relocated with the memAPI's realloc, anything else is move
+// constructed into a new allocation and destructed in the old one so it's never memcpy'd. Elements
+// are constructed on push and destructed on pop, remove, clear and free.
 template <typename T>
 struct DqnArray
 {
@@ -475,22 +745,117 @@ struct DqnArray
 	u64 count;
 	u64 capacity;
 	T   *data;
+	f32 growthFactor; // 0 uses DQN_ARRAY_GROWTH_FACTOR
 
 	// API
 	void  Init        (const size_t capacity, DqnMemAPI memAPI = DqnMemAPI_DefaultUseCalloc());
 	bool  Free        ();
 	bool  Grow        ();
+	bool  Reserve     (const u64 newCapacity);
+	bool  Resize      (const u64 newCount);
 	T    *Push        (const T item);
+	T    *PushN       (const T *const items, const u64 num);
+	T    *InsertN     (const u64 index, const T *const items, const u64 num);
 	void  Pop         ();
 	T    *Get         (u64 index);
 	bool  Clear       ();
 	bool  Remove      (u64 index);
 	bool  RemoveStable(u64 index);
+	bool  EraseRange  (const u64 index, const u64 num);
+	u64   RemoveIf    (bool (*ShouldRemove)(const T *const item, void *const userData), void *const userData,
+	                   const u64 startIndex = 0);
 };
 
 FILE_SCOPE const char *const DQN_MEM_API_CALLBACK_RESULT_TYPE_INCORRECT =
     "DqnMemAPICallbackResult type is incorrect";
 
+template <typename T>
+void DqnArrayInternal_Destruct(T *const items, const u64 num, std::true_type /*isTriviallyDestructible*/)
+{
+}
+
+template <typename T>
+void DqnArrayInternal_Destruct(T *const items, const u64 num, std::false_type /*isTriviallyDestructible*/)
+{
+	for (u64 i = 0; i < num; i++)
+		items[i].~T();
+}
+
+template <typename T>
+void DqnArrayInternal_Destruct(T *const items, const u64 num)
+{
+	DqnArrayInternal_Destruct(items, num, std::is_trivially_destructible<T>());
+}
+
+template <typename T>
+bool DqnArrayInternal_Relocate(DqnArray<T> *const array, const u64 newCapacity,
+                               std::false_type /*isTriviallyCopyable*/)
+{
+	size_t newSize = (size_t)newCapacity * sizeof(T);
+
+	DqnMemAPICallbackResult memResult = {0};
+	DqnMemAPICallbackInfo info = DqnMemAPIInternal_CallbackInfoAskAlloc(array->memAPI, newSize);
+	array->memAPI.callback(info, &memResult);
+	if (!DQN_ASSERT_MSG(memResult.type == DqnMemAPICallbackType_Alloc, DQN_MEM_API_CALLBACK_RESULT_TYPE_INCORRECT))
+	{
+		return false;
+	}
+
+	T *newData = (T *)memResult.newMemPtr;
+	if (!newData) return false;
+
+	if (array->data)
+	{
+		for (u64 i = 0; i < array->count; i++)
+			new (&newData[i]) T(std::move(array->data[i]));
+		DqnArrayInternal_Destruct(array->data, array->count);
+
+		size_t oldSize = (size_t)array->capacity * sizeof(T);
+		info           = DqnMemAPIInternal_CallbackInfoAskFree(array->memAPI, array->data, oldSize);
+		array->memAPI.callback(info, NULL);
+	}
+
+	array->data     = newData;
+	array->capacity = newCapacity;
+	return true;
+}
+
+template <typename T>
+bool DqnArrayInternal_Relocate(DqnArray<T> *const array, const u64 newCapacity,
+                               std::true_type /*isTriviallyCopyable*/)
+{
+	// NOTE: Nothing to realloc, the first allocation is the same for every type
+	if (!array->data) return DqnArrayInternal_Relocate(array, newCapacity, std::false_type());
+
+	size_t oldSize = (size_t)array->capacity * sizeof(T);
+	size_t newSize = (size_t)newCapacity * sizeof(T);
+
+	DqnMemAPICallbackResult memResult = {0};
+	DqnMemAPICallbackInfo info = DqnMemAPIInternal_CallbackInfoAskRealloc(
+	    array->memAPI, array->data, oldSize, newSize);
+
+	array->memAPI.callback(info, &memResult);
+	if (!DQN_ASSERT_MSG(memResult.type == DqnMemAPICallbackType_Realloc,
+	                    DQN_MEM_API_CALLBACK_RESULT_TYPE_INCORRECT))
+	{
+		return false;
+	}
+
+	if (!memResult.newMemPtr) return false;
+
+	array->data     = (T *)memResult.newMemPtr;
+	array->capacity = newCapacity;
+	return true;
+}
+
+// NOTE: A zero cleared array is allocated with the default memAPI the first time it needs memory.
+template <typename T>
+bool DqnArrayInternal_Relocate(DqnArray<T> *const array, const u64 newCapacity)
+{
+	if (!array->memAPI.callback) array->memAPI = DqnMemAPI_DefaultUseCalloc();
+	return DqnArrayInternal_Relocate(array, newCapacity, std::is_trivially_copyable<T>());
+}
+
 template <typename T>
 bool DqnArray_Init(DqnArray<T> *const array, const size_t capacity,
                    const DqnMemAPI memAPI = DqnMemAPI_DefaultUseCalloc())
@@ -524,6 +889,8 @@ bool DqnArray_Free(DqnArray<T> *const array)
 {
 	if (array && array->data)
 	{
+		DqnArrayInternal_Destruct(array->data, array->count);
+
 		// TODO(doyle): Right now we assume free always works, and it probably should?
 		size_t sizeToFree = (size_t)array->capacity * sizeof(T);
 		DqnMemAPICallbackInfo info = DqnMemAPIInternal_CallbackInfoAskFree(
@@ -539,39 +906,64 @@ bool DqnArray_Free(DqnArray<T> *const array)
 	return false;
 }
 
+// NOTE: Grows by the growth factor like a push would, or straight to minCapacity if that's larger,
+// so pushing N items at once relocates at most once.
+template <typename T>
+bool DqnArrayInternal_GrowToFit(DqnArray<T> *const array, const u64 minCapacity)
+{
+	if (minCapacity <= array->capacity) return true;
+
+	f32 growthFactor = (array->growthFactor > 0) ? array->growthFactor : DQN_ARRAY_GROWTH_FACTOR;
+	u64 newCapacity  = (u64)(array->capacity * growthFactor);
+	newCapacity      = DQN_MAX(newCapacity, minCapacity);
+
+	bool result = DqnArrayInternal_Relocate(array, newCapacity);
+	return result;
+}
+
+// Grow the capacity by the array's growth factor, or by 1 if that rounds to the same capacity.
+// return: FALSE if out of memory, the array is unchanged.
 template <typename T>
 bool DqnArray_Grow(DqnArray<T> *const array)
 {
-	if (!array || !array->data) return false;
+	if (!array) return false;
 
-	const f32 GROWTH_FACTOR = 1.2f;
-	size_t newCapacity      = (size_t)(array->capacity * GROWTH_FACTOR);
-	if (newCapacity == array->capacity) newCapacity++;
+	bool result = DqnArrayInternal_GrowToFit(array, array->capacity + 1);
+	return result;
+}
 
-	size_t oldSize = (size_t)array->capacity * sizeof(T);
-	size_t newSize = (size_t)newCapacity * sizeof(T);
+// Ensure the array can hold newCapacity elements without growing, it never shrinks.
+// return: FALSE if out of memory, the array is unchanged.
+template <typename T>
+bool DqnArray_Reserve(DqnArray<T> *const array, const u64 newCapacity)
+{
+	if (!array) return false;
+	if (newCapacity <= array->capacity) return true;
 
-	DqnMemAPICallbackResult memResult = {0};
-	DqnMemAPICallbackInfo info = DqnMemAPIInternal_CallbackInfoAskRealloc(
-	    array->memAPI, array->data, oldSize, newSize);
+	bool result = DqnArrayInternal_Relocate(array, newCapacity);
+	return result;
+}
 
-	array->memAPI.callback(info, &memResult);
-	if (!DQN_ASSERT_MSG(memResult.type == DqnMemAPICallbackType_Realloc,
-	                    DQN_MEM_API_CALLBACK_RESULT_TYPE_INCORRECT))
-	{
-		return false;
-	}
+// Set the number of elements, new elements are value initialised (zeroed for plain structs) and
+// elements past newCount are destructed. Reserves exactly newCount if it needs to grow.
+// return: FALSE if out of memory, the array is unchanged.
+template <typename T>
+bool DqnArray_Resize(DqnArray<T> *const array, const u64 newCount)
+{
+	if (!DqnArray_Reserve(array, newCount)) return false;
 
-	if (memResult.newMemPtr)
+	if (newCount > array->count)
 	{
-		array->data     = (T *)memResult.newMemPtr;
-		array->capacity = newCapacity;
-		return true;
+		for (u64 i = array->count; i < newCount; i++)
+			new (&array->data[i]) T();
 	}
 	else
 	{
-		return false;
+		DqnArrayInternal_Destruct(array->data + newCount, array->count - newCount);
 	}
+
+	array->count = newCount;
+	return true;
 }
 
 template <typename T>
@@ -585,9 +977,75 @@ T *DqnArray_Push(DqnArray<T> *const array, const T item)
 	}
 
 	DQN_ASSERT(array->count < array->capacity);
-	array->data[array->count++] = item;
+	T *result = new (&array->data[array->count++]) T(item);
+
+	return result;
+}
+
+template <typename T>
+void DqnArrayInternal_ShiftUp(DqnArray<T> *const array, const u64 index, const u64 num,
+                              std::true_type /*isTriviallyCopyable*/)
+{
+	memmove(&array->data[index + num], &array->data[index], (size_t)((array->count - index) * sizeof(T)));
+}
+
+// NOTE: Slots past count are uninitialised so they're move constructed, the rest are move assigned
+template <typename T>
+void DqnArrayInternal_ShiftUp(DqnArray<T> *const array, const u64 index, const u64 num,
+                              std::false_type /*isTriviallyCopyable*/)
+{
+	for (u64 dest = array->count + num; dest-- > index + num;)
+	{
+		if (dest >= array->count) new (&array->data[dest]) T(std::move(array->data[dest - num]));
+		else                      array->data[dest] = std::move(array->data[dest - num]);
+	}
+}
+
+template <typename T>
+void DqnArrayInternal_CopyIn(DqnArray<T> *const array, const u64 index, const T *const items, const u64 num,
+                             std::true_type /*isTriviallyCopyable*/)
+{
+	memcpy(&array->data[index], items, (size_t)(num * sizeof(T)));
+}
+
+// NOTE: Called after ShiftUp but before count is updated, slots past count are still uninitialised
+template <typename T>
+void DqnArrayInternal_CopyIn(DqnArray<T> *const array, const u64 index, const T *const items, const u64 num,
+                             std::false_type /*isTriviallyCopyable*/)
+{
+	for (u64 i = 0; i < num; i++)
+	{
+		u64 dest = index + i;
+		if (dest >= array->count) new (&array->data[dest]) T(items[i]);
+		else                      array->data[dest] = items[i];
+	}
+}
+
+// Copy num items into the array before index, moving the elements from index onwards up. index may
+// be count to append. Grows at most once, so items must not point into the array.
+// return: A pointer to the first item inserted, NULL if out of memory, index is out of bounds or
+//         num is 0.
+template <typename T>
+T *DqnArray_InsertN(DqnArray<T> *const array, const u64 index, const T *const items, const u64 num)
+{
+	if (!array || !items || num == 0) return NULL;
+	if (index > array->count) return NULL;
+	if (!DqnArrayInternal_GrowToFit(array, array->count + num)) return NULL;
 
-	return &array->data[array->count-1];
+	DqnArrayInternal_ShiftUp(array, index, num, std::is_trivially_copyable<T>());
+	DqnArrayInternal_CopyIn(array, index, items, num, std::is_trivially_copyable<T>());
+
+	array->count += num;
+	return &array->data[index];
+}
+
+// Copy num items onto the end of the array, growing at most once.
+// return: A pointer to the first item pushed, NULL if out of memory or num is 0.
+template <typename T>
+T *DqnArray_PushN(DqnArray<T> *const array, const T *const items, const u64 num)
+{
+	T *result = DqnArray_InsertN(array, (array) ? array->count : 0, items, num);
+	return result;
 }
 
 template <typename T>
@@ -596,6 +1054,7 @@ void DqnArray_Pop(DqnArray<T> *array)
 	if (!array) return;
 	if (array->count == 0) return;
 	array->count--;
+	DqnArrayInternal_Destruct(array->data + array->count, 1);
 
 	return;
 }
@@ -613,6 +1072,7 @@ bool DqnArray_Clear(DqnArray<T> *const array)
 {
 	if (array)
 	{
+		DqnArrayInternal_Destruct(array->data, array->count);
 		array->count = 0;
 		return true;
 	}
@@ -631,51 +1091,445 @@ bool DqnArray_Remove(DqnArray<T> *const array, const u64 index)
 	if (firstElementAndOnlyElement || isLastElement)
 	{
 		array->count--;
+		DqnArrayInternal_Destruct(array->data + array->count, 1);
 		return true;
 	}
 
-	array->data[index] = array->data[array->count - 1];
+	array->data[index] = std::move(array->data[array->count - 1]);
 	array->count--;
+	DqnArrayInternal_Destruct(array->data + array->count, 1);
 	return true;
 }
 
 template <typename T>
-bool DqnArray_RemoveStable(DqnArray<T> *const array, const u64 index)
+void DqnArrayInternal_ShiftDown(T *const dest, T *const src, const u64 num,
+                                std::true_type /*isTriviallyCopyable*/)
 {
-	if (!array) return false;
-	if (index >= array->count) return false;
+	memmove(dest, src, (size_t)(num * sizeof(T)));
+}
 
-	bool firstElementAndOnlyElement = (index == 0 && array->count == 1);
-	bool isLastElement              = (index == (array->count - 1));
-	if (firstElementAndOnlyElement || isLastElement)
-	{
-		array->count--;
-		return true;
-	}
+template <typename T>
+void DqnArrayInternal_ShiftDown(T *const dest, T *const src, const u64 num,
+                                std::false_type /*isTriviallyCopyable*/)
+{
+	for (u64 i = 0; i < num; i++)
+		dest[i] = std::move(src[i]);
+}
 
-	size_t itemToRemoveByteOffset         = (size_t)(index * sizeof(T));
-	size_t oneAfterItemToRemoveByteOffset = (size_t)((index + 1) * sizeof(T));
-	size_t lastItemByteOffset = (size_t)(array->count * sizeof(T));
-	size_t numBytesToMove = lastItemByteOffset - oneAfterItemToRemoveByteOffset;
+// Remove num elements starting at index, keeping the order of the rest.
+// return: FALSE if the range is out of bounds.
+template <typename T>
+bool DqnArray_EraseRange(DqnArray<T> *const array, const u64 index, const u64 num)
+{
+	if (!array) return false;
+	if (index > array->count || num > array->count - index) return false;
 
-	u8 *bytePtr = (u8 *)array->data;
-	u8 *dest    = &bytePtr[itemToRemoveByteOffset];
-	u8 *src     = &bytePtr[oneAfterItemToRemoveByteOffset];
-	memmove(dest, src, numBytesToMove);
+	u64 numToMove = array->count - (index + num);
+	DqnArrayInternal_ShiftDown(&array->data[index], &array->data[index + num], numToMove,
+	                           std::is_trivially_copyable<T>());
 
-	array->count--;
+	array->count -= num;
+	DqnArrayInternal_Destruct(array->data + array->count, num);
 	return true;
 }
 
-template <typename T> void DqnArray<T>::Init (const size_t capacity, DqnMemAPI memAPI) { DqnArray_Init(this, capacity, memAPI); }
-template <typename T> bool DqnArray<T>::Free ()                                        { return DqnArray_Free(this); }
-template <typename T> bool DqnArray<T>::Grow ()                                        { return DqnArray_Grow(this);}
-template <typename T> T*   DqnArray<T>::Push (const T item)                            { return DqnArray_Push(this, item); }
-template <typename T> void DqnArray<T>::Pop  ()                                        { DqnArray_Pop(this); }
-template <typename T> T*   DqnArray<T>::Get  (const u64 index)                         { return DqnArray_Get(this, index); }
-template <typename T> bool DqnArray<T>::Clear()                                        { return DqnArray_Clear (this); }
-template <typename T> bool DqnArray<T>::Remove      (const u64 index)                  { return DqnArray_Remove(this, index); }
-template <typename T> bool DqnArray<T>::RemoveStable(const u64 index)                  { return DqnArray_RemoveStable(this, index); }
+template <typename T>
+bool DqnArray_RemoveStable(DqnArray<T> *const array, const u64 index)
+{
+	bool result = DqnArray_EraseRange(array, index, 1);
+	return result;
+}
+
+// Remove every element from startIndex onwards that ShouldRemove returns TRUE for in a single pass,
+// keeping the order of the rest. ShouldRemove is called once per element in order.
+// return: The number of elements removed.
+template <typename T>
+u64 DqnArray_RemoveIf(DqnArray<T> *const array,
+                      bool (*ShouldRemove)(const T *const item, void *const userData),
+                      void *const userData, const u64 startIndex = 0)
+{
+	if (!array || !ShouldRemove) return 0;
+
+	u64 writeIndex = startIndex;
+	for (u64 readIndex = startIndex; readIndex < array->count; readIndex++)
+	{
+		if (ShouldRemove(&array->data[readIndex], userData)) continue;
+		if (writeIndex != readIndex) array->data[writeIndex] = std::move(array->data[readIndex]);
+		writeIndex++;
+	}
+
+	u64 result = (array->count > writeIndex) ? array->count - writeIndex : 0;
+	DqnArrayInternal_Destruct(array->data + writeIndex, result);
+	array->count -= result;
+	return result;
+}
+
+template <typename T> void DqnArray<T>::Init   (const size_t capacity, DqnMemAPI memAPI) { DqnArray_Init(this, capacity, memAPI); }
+template <typename T> bool DqnArray<T>::Free   ()                                        { return DqnArray_Free(this); }
+template <typename T> bool DqnArray<T>::Grow   ()                                        { return DqnArray_Grow(this);}
+template <typename T> bool DqnArray<T>::Reserve(const u64 newCapacity)                   { return DqnArray_Reserve(this, newCapacity); }
+template <typename T> bool DqnArray<T>::Resize (const u64 newCount)                      { return DqnArray_Resize(this, newCount); }
+template <typename T> T*   DqnArray<T>::Push   (const T item)                            { return DqnArray_Push(this, item); }
+template <typename T> T*   DqnArray<T>::PushN  (const T *const items, const u64 num)     { return DqnArray_PushN(this, items, num); }
+template <typename T> T*   DqnArray<T>::InsertN(const u64 index, const T *const items, const u64 num) { return DqnArray_InsertN(this, index, items, num); }
+template <typename T> void DqnArray<T>::Pop    ()                                        { DqnArray_Pop(this); }
+template <typename T> T*   DqnArray<T>::Get    (const u64 index)                         { return DqnArray_Get(this, index); }
+template <typename T> bool DqnArray<T>::Clear  ()                                        { return DqnArray_Clear (this); }
+template <typename T> bool DqnArray<T>::Remove      (const u64 index)                    { return DqnArray_Remove(this, index); }
+template <typename T> bool DqnArray<T>::RemoveStable(const u64 index)                    { return DqnArray_RemoveStable(this, index); }
+template <typename T> bool DqnArray<T>::EraseRange  (const u64 index, const u64 num)     { return DqnArray_EraseRange(this, index, num); }
+template <typename T> u64  DqnArray<T>::RemoveIf    (bool (*ShouldRemove)(const T *const item, void *const userData),
+                                                     void *const userData, const u64 startIndex)
+{
+	return DqnArray_RemoveIf(this, ShouldRemove, userData, startIndex);
+}
+#endif // DQN_CPP_MODE
+
+////////////////////////////////////////////////////////////////////////////////
+// #DqnHashMap Public API - CPP Open Addressing Hash Map with Templates
+////////////////////////////////////////////////////////////////////////////////
+// Linear probing with a control byte per slot, like SwissTable. A full slot's control byte holds 7
+// bits of its key's hash so a probe compares 16 slots at once with SSE2 (or a scalar loop without
+// it) and only touches the keys whose bits match. Removal shifts the rest of the probe run back
+// instead of leaving tombstones, so lookups never slow down as keys come and go.
+// Keys are hashed by their bytes and compared with ==, so K must be free of padding, i.e. integers,
+// pointers and handles. K and V must be trivially copyable, they're memcpy'd when the map grows.
+#ifdef DQN_CPP_MODE
+#if !defined(DQN_HASH_MAP_NO_SIMD) && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define DQN_HASH_MAP_SSE2 1
+	#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+	#include <intrin.h> // _BitScanForward
+#endif
+
+#define DQN_HASH_MAP_GROUP_SIZE 16
+#define DQN_HASH_MAP_MIN_CAPACITY DQN_HASH_MAP_GROUP_SIZE
+#define DQN_HASH_MAP_CTRL_EMPTY 0x80
+
+template <typename K, typename V>
+struct DqnHashMapEntry
+{
+	K key;
+	V value;
+};
+
+template <typename K, typename V>
+struct DqnHashMap
+{
+	DqnMemAPI memAPI;
+
+	// NOTE: One allocation, capacity entries followed by capacity + DQN_HASH_MAP_GROUP_SIZE - 1
+	// control bytes. The control bytes of the first slots are cloned after the last slot so a group
+	// can always be loaded from any slot without wrapping.
+	DqnHashMapEntry<K, V> *entries;
+	u8                    *ctrl;
+	u64                    count;
+	u64                    capacity; // Power of 2, 0 until the first Set() or Reserve()
+
+	// API
+	bool  Init   (const u64 capacity, DqnMemAPI memAPI = DqnMemAPI_DefaultUseCalloc());
+	void  Free   ();
+	bool  Reserve(const u64 num);
+	V    *Get    (const K key);
+	V    *Set    (const K key, const V value);
+	bool  Remove (const K key);
+	void  Clear  ();
+};
+
+// NOTE: splitmix64's finaliser, keys that are small integers or aligned pointers vary in their low
+// bits which we need spread over the whole hash
+FILE_SCOPE inline u64 DqnHashMapInternal_Mix(u64 hash)
+{
+	hash ^= hash >> 30; hash *= 0xbf58476d1ce4e5b9ULL;
+	hash ^= hash >> 27; hash *= 0x94d049bb133111ebULL;
+	hash ^= hash >> 31;
+	return hash;
+}
+
+template <typename K>
+u64 DqnHashMapInternal_Hash(const K &key)
+{
+	u64 result = 14695981039346656037ULL;
+	if (sizeof(K) <= sizeof(u64))
+	{
+		u64 bytes = 0;
+		memcpy(&bytes, &key, sizeof(K));
+		result ^= bytes;
+	}
+	else
+	{
+		// NOTE: FNV-1a over anything bigger
+		const u8 *bytes = (const u8 *)&key;
+		for (size_t i = 0; i < sizeof(K); i++)
+		{
+			result ^= bytes[i];
+			result *= 1099511628211ULL;
+		}
+	}
+
+	result = DqnHashMapInternal_Mix(result);
+	return result;
+}
+
+// NOTE: The low bits of the hash pick the home slot, the top 7 bits are stored in the control byte
+FILE_SCOPE inline u8 DqnHashMapInternal_Tag(const u64 hash) { return (u8)(hash >> 57); }
+
+FILE_SCOPE inline u32 DqnHashMapInternal_LowestBit(const u32 mask)
+{
+#if defined(_MSC_VER)
+	unsigned long result;
+	_BitScanForward(&result, mask);
+	return (u32)result;
+#else
+	return (u32)__builtin_ctz(mask);
+#endif
+}
+
+// return: A bit per control byte in the group starting at ctrl, set where it equals tag.
+FILE_SCOPE inline u32 DqnHashMapInternal_GroupMatch(const u8 *const ctrl, const u8 tag)
+{
+#if defined(DQN_HASH_MAP_SSE2)
+	__m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+	u32 result    = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)tag)));
+#else
+	u32 result = 0;
+	for (u32 i = 0; i < DQN_HASH_MAP_GROUP_SIZE; i++)
+		result |= (u32)(ctrl[i] == tag) << i;
+#endif
+	return result;
+}
+
+template <typename K, typename V>
+void DqnHashMapInternal_SetCtrl(DqnHashMap<K, V> *const map, const u64 slot, const u8 ctrl)
+{
+	map->ctrl[slot] = ctrl;
+	if (slot < DQN_HASH_MAP_GROUP_SIZE - 1) map->ctrl[map->capacity + slot] = ctrl;
+}
+
+// Find the slot of key, or the empty slot it would be inserted at.
+// return: TRUE if the key was found.
+template <typename K, typename V>
+bool DqnHashMapInternal_Find(const DqnHashMap<K, V> *const map, const K &key, const u64 hash, u64 *const slot)
+{
+	const u64 mask = map->capacity - 1;
+	const u8 tag   = DqnHashMapInternal_Tag(hash);
+	for (u64 groupSlot = hash & mask;; groupSlot = (groupSlot + DQN_HASH_MAP_GROUP_SIZE) & mask)
+	{
+		const u8 *group = map->ctrl + groupSlot;
+		u32 matches     = DqnHashMapInternal_GroupMatch(group, tag);
+		u32 empties     = DqnHashMapInternal_GroupMatch(group, DQN_HASH_MAP_CTRL_EMPTY);
+
+		// NOTE: Without tombstones a probe run ends at its first empty slot, matches after it belong
+		// to other runs
+		if (empties) matches &= (empties & (0 - empties)) - 1;
+		while (matches)
+		{
+			u64 candidate = (groupSlot + DqnHashMapInternal_LowestBit(matches)) & mask;
+			if (map->entries[candidate].key == key)
+			{
+				*slot = candidate;
+				return true;
+			}
+			matches &= matches - 1;
+		}
+
+		if (empties)
+		{
+			*slot = (groupSlot + DqnHashMapInternal_LowestBit(empties)) & mask;
+			return false;
+		}
+	}
+}
+
+template <typename K, typename V>
+bool DqnHashMapInternal_Allocate(DqnHashMap<K, V> *const map, const u64 capacity)
+{
+	static_assert(std::is_trivially_copyable<K>::value && std::is_trivially_copyable<V>::value,
+	              "DqnHashMap keys and values are memcpy'd so must be trivially copyable");
+	if (!map->memAPI.callback) map->memAPI = DqnMemAPI_DefaultUseCalloc();
+
+	size_t entriesSize = (size_t)capacity * sizeof(DqnHashMapEntry<K, V>);
+	size_t ctrlSize    = (size_t)capacity + DQN_HASH_MAP_GROUP_SIZE - 1;
+
+	DqnMemAPICallbackResult memResult = {0};
+	DqnMemAPICallbackInfo info = DqnMemAPIInternal_CallbackInfoAskAlloc(map->memAPI, entriesSize + ctrlSize);
+	map->memAPI.callback(info, &memResult);
+	if (!DQN_ASSERT_MSG(memResult.type == DqnMemAPICallbackType_Alloc, DQN_MEM_API_CALLBACK_RESULT_TYPE_INCORRECT))
+	{
+		return false;
+	}
+
+	if (!memResult.newMemPtr) return false;
+
+	map->entries  = (DqnHashMapEntry<K, V> *)memResult.newMemPtr;
+	map->ctrl     = (u8 *)memResult.newMemPtr + entriesSize;
+	map->capacity = capacity;
+	map->count    = 0;
+	memset(map->ctrl, DQN_HASH_MAP_CTRL_EMPTY, ctrlSize);
+	return true;
+}
+
+template <typename K, typename V>
+void DqnHashMapInternal_FreeMem(DqnHashMap<K, V> *const map, DqnHashMapEntry<K, V> *const entries,
+                                const u64 capacity)
+{
+	size_t size = ((size_t)capacity * sizeof(DqnHashMapEntry<K, V>)) + (size_t)capacity + DQN_HASH_MAP_GROUP_SIZE - 1;
+	DqnMemAPICallbackInfo info = DqnMemAPIInternal_CallbackInfoAskFree(map->memAPI, entries, size);
+	map->memAPI.callback(info, NULL);
+}
+
+// capacity: Rounded up to a power of 2, at least DQN_HASH_MAP_MIN_CAPACITY.
+// return:   FALSE if out of memory.
+template <typename K, typename V>
+bool DqnHashMap_Init(DqnHashMap<K, V> *const map, const u64 capacity,
+                     const DqnMemAPI memAPI = DqnMemAPI_DefaultUseCalloc())
+{
+	if (!map) return false;
+	if (map->entries) DqnHashMap_Free(map);
+
+	u64 roundedCapacity = DQN_HASH_MAP_MIN_CAPACITY;
+	while (roundedCapacity < capacity) roundedCapacity *= 2;
+
+	map->memAPI = memAPI;
+	bool result = DqnHashMapInternal_Allocate(map, roundedCapacity);
+	return result;
+}
+
+template <typename K, typename V>
+void DqnHashMap_Free(DqnHashMap<K, V> *const map)
+{
+	if (!map || !map->entries) return;
+
+	DqnHashMapInternal_FreeMem(map, map->entries, map->capacity);
+	map->entries  = NULL;
+	map->ctrl     = NULL;
+	map->count    = 0;
+	map->capacity = 0;
+}
+
+// NOTE: The map grows once it's 7/8ths full, linear probing needs the empty slots to keep runs short
+FILE_SCOPE inline u64 DqnHashMapInternal_MaxCount(const u64 capacity) { return capacity - (capacity / 8); }
+
+// Ensure num keys fit without growing.
+// return: FALSE if out of memory, the map is unchanged.
+template <typename K, typename V>
+bool DqnHashMap_Reserve(DqnHashMap<K, V> *const map, const u64 num)
+{
+	if (!map) return false;
+	if (map->capacity && num <= DqnHashMapInternal_MaxCount(map->capacity)) return true;
+
+	u64 newCapacity = DQN_MAX(map->capacity, (u64)DQN_HASH_MAP_MIN_CAPACITY);
+	while (num > DqnHashMapInternal_MaxCount(newCapacity)) newCapacity *= 2;
+
+	DqnHashMap<K, V> oldMap = *map;
+	if (!DqnHashMapInternal_Allocate(map, newCapacity))
+	{
+		*map = oldMap;
+		return false;
+	}
+
+	// NOTE: Keys are unique so each goes straight into the first empty slot of its probe run
+	for (u64 i = 0; i < oldMap.capacity; i++)
+	{
+		if (oldMap.ctrl[i] == DQN_HASH_MAP_CTRL_EMPTY) continue;
+
+		const DqnHashMapEntry<K, V> *entry = &oldMap.entries[i];
+		u64 hash = DqnHashMapInternal_Hash(entry->key);
+		u64 slot;
+		DqnHashMapInternal_Find(map, entry->key, hash, &slot);
+		DqnHashMapInternal_SetCtrl(map, slot, DqnHashMapInternal_Tag(hash));
+		map->entries[slot] = *entry;
+		map->count++;
+	}
+
+	if (oldMap.entries) DqnHashMapInternal_FreeMem(map, oldMap.entries, oldMap.capacity);
+	return true;
+}
+
+// return: The value of key, NULL if it's not in the map. Valid until the map is next modified.
+template <typename K, typename V>
+V *DqnHashMap_Get(DqnHashMap<K, V> *const map, const K key)
+{
+	if (!map || map->count == 0) return NULL;
+
+	u64 slot;
+	if (!DqnHashMapInternal_Find(map, key, DqnHashMapInternal_Hash(key), &slot)) return NULL;
+	return &map->entries[slot].value;
+}
+
+// Insert key or overwrite its value. A zero cleared map is allocated with the default memAPI.
+// return: The value in the map, NULL if out of memory. Valid until the map is next modified.
+template <typename K, typename V>
+V *DqnHashMap_Set(DqnHashMap<K, V> *const map, const K key, const V value)
+{
+	if (!map) return NULL;
+
+	// NOTE: Look the key up before reserving, overwriting a key never needs to grow the map
+	u64 hash = DqnHashMapInternal_Hash(key);
+	u64 slot;
+	if (map->count == 0 || !DqnHashMapInternal_Find(map, key, hash, &slot))
+	{
+		if (!DqnHashMap_Reserve(map, map->count + 1)) return NULL;
+
+		// NOTE: Growing rehashes every key, so find the empty slot again
+		DqnHashMapInternal_Find(map, key, hash, &slot);
+		DqnHashMapInternal_SetCtrl(map, slot, DqnHashMapInternal_Tag(hash));
+		map->entries[slot].key = key;
+		map->count++;
+	}
+
+	map->entries[slot].value = value;
+	return &map->entries[slot].value;
+}
+
+// return: FALSE if key is not in the map.
+template <typename K, typename V>
+bool DqnHashMap_Remove(DqnHashMap<K, V> *const map, const K key)
+{
+	if (!map || map->count == 0) return false;
+
+	u64 hole;
+	if (!DqnHashMapInternal_Find(map, key, DqnHashMapInternal_Hash(key), &hole)) return false;
+
+	// NOTE: Knuth's algorithm R, pull back every later key of the run that would no longer be
+	// reachable from its home slot across the hole
+	const u64 mask = map->capacity - 1;
+	for (u64 slot = (hole + 1) & mask; map->ctrl[slot] != DQN_HASH_MAP_CTRL_EMPTY; slot = (slot + 1) & mask)
+	{
+		u64 home              = DqnHashMapInternal_Hash(map->entries[slot].key) & mask;
+		u64 distanceToHole    = (slot - hole) & mask;
+		u64 distanceFromHome  = (slot - home) & mask;
+		if (distanceFromHome < distanceToHole) continue;
+
+		map->entries[hole] = map->entries[slot];
+		DqnHashMapInternal_SetCtrl(map, hole, map->ctrl[slot]);
+		hole = slot;
+	}
+
+	DqnHashMapInternal_SetCtrl(map, hole, DQN_HASH_MAP_CTRL_EMPTY);
+	map->count--;
+	return true;
+}
+
+// Remove every key, keeping the memory.
+template <typename K, typename V>
+void DqnHashMap_Clear(DqnHashMap<K, V> *const map)
+{
+	if (!map || !map->ctrl) return;
+	memset(map->ctrl, DQN_HASH_MAP_CTRL_EMPTY, (size_t)map->capacity + DQN_HASH_MAP_GROUP_SIZE - 1);
+	map->count = 0;
+}
+
+template <typename K, typename V> bool DqnHashMap<K, V>::Init   (const u64 capacity, DqnMemAPI memAPI) { return DqnHashMap_Init(this, capacity, memAPI); }
+template <typename K, typename V> void DqnHashMap<K, V>::Free   ()                                     { DqnHashMap_Free(this); }
+template <typename K, typename V> bool DqnHashMap<K, V>::Reserve(const u64 num)                        { return DqnHashMap_Reserve(this, num); }
+template <typename K, typename V> V   *DqnHashMap<K, V>::Get    (const K key)                          { return DqnHashMap_Get(this, key); }
+template <typename K, typename V> V   *DqnHashMap<K, V>::Set    (const K key, const V value)           { return DqnHashMap_Set(this, key, value); }
+template <typename K, typename V> bool DqnHashMap<K, V>::Remove (const K key)                          { return DqnHashMap_Remove(this, key); }
+template <typename K, typename V> void DqnHashMap<K, V>::Clear  ()                                     { DqnHashMap_Clear(this); }
 #endif // DQN_CPP_MODE
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -973,6 +1827,189 @@ DQN_FILE_SCOPE void DqnWStr_Reverse           (wchar_t *const buf, const u32 buf
 DQN_FILE_SCOPE i32  Dqn_WStrToI32(const wchar_t *const buf, const i32 bufSize);
 DQN_FILE_SCOPE i32  Dqn_I32ToWStr(i32 value, wchar_t *buf, i32 bufSize);
 
+////////////////////////////////////////////////////////////////////////////////
+// #DqnString Public API - CPP Owned String with Length and Small String Storage
+////////////////////////////////////////////////////////////////////////////////
+// Cplusplus mode only since it uses templates
+// A NUL terminated string that keeps its length, so it's never rescanned. Strings that fit in
+// DQN_STRING_INLINE_BYTES are stored in the struct, i.e. names and labels, longer strings are
+// allocated from the memAPI, which can be DqnMemAPI_StackAllocator() to drop them with the stack.
+// A zero cleared string is empty and allocates from DqnMemAPI_DefaultUseCalloc().
+
+#ifdef DQN_CPP_MODE
+// NOTE: Includes the NUL, so 23 chars or 11 wchar_t's on Win32 (5 elsewhere, wchar_t is 4 bytes)
+#ifndef DQN_STRING_INLINE_BYTES
+	#define DQN_STRING_INLINE_BYTES 24
+#endif
+
+// The characters a string holds without allocating, excluding the NUL
+#define DQN_STRING_INLINE_LEN(T) ((i32)(DQN_STRING_INLINE_BYTES / sizeof(T)) - 1)
+
+template <typename T>
+struct DqnBasicString
+{
+	DqnMemAPI memAPI;
+	i32       len;
+	i32       max; // Characters allocStr holds excluding the NUL, the inline storage is used until it's larger
+
+	// NOTE: Not a pointer to inlineStr, so a string stored inline can still be copied like a POD
+	union
+	{
+		T  inlineStr[DQN_STRING_INLINE_BYTES / sizeof(T)];
+		T *allocStr;
+	};
+
+	// API
+	T       *Str    ();
+	const T *Str    () const;
+	bool     Reserve(const i32 newMax);
+	bool     Set    (const T *const src, const i32 srcLen = -1);
+	bool     Append (const T *const src, const i32 srcLen = -1);
+	void     Clear  ();
+	void     Free   ();
+};
+
+typedef DqnBasicString<char>    DqnString;
+typedef DqnBasicString<wchar_t> DqnWString;
+
+FILE_SCOPE inline i32 DqnStringInternal_Len(const char *const str)    { return DqnStr_Len(str);  }
+FILE_SCOPE inline i32 DqnStringInternal_Len(const wchar_t *const str) { return DqnWStr_Len(str); }
+
+template <typename T>
+bool DqnStringInternal_IsInline(const DqnBasicString<T> *const str)
+{
+	return (str->max <= DQN_STRING_INLINE_LEN(T));
+}
+
+// Start an empty string that allocates from the memAPI once it outgrows the inline storage.
+template <typename T>
+void DqnString_Init(DqnBasicString<T> *const str, const DqnMemAPI memAPI = DqnMemAPI_DefaultUseCalloc())
+{
+	if (!str) return;
+	*str        = {};
+	str->memAPI = memAPI;
+}
+
+// return: The NUL terminated characters, valid until the string is next modified.
+template <typename T>
+T *DqnString_Str(DqnBasicString<T> *const str)
+{
+	return DqnStringInternal_IsInline(str) ? str->inlineStr : str->allocStr;
+}
+
+template <typename T>
+const T *DqnString_Str(const DqnBasicString<T> *const str)
+{
+	return DqnStringInternal_IsInline(str) ? str->inlineStr : str->allocStr;
+}
+
+// Make room for at least newMax characters excluding the NUL. Never shrinks.
+// return: FALSE if the memAPI is out of memory, the string is unchanged.
+template <typename T>
+bool DqnString_Reserve(DqnBasicString<T> *const str, const i32 newMax)
+{
+	if (!str) return false;
+
+	bool isInline = DqnStringInternal_IsInline(str);
+	i32 currMax   = isInline ? DQN_STRING_INLINE_LEN(T) : str->max;
+	if (newMax <= currMax) return true;
+	if (!str->memAPI.callback) str->memAPI = DqnMemAPI_DefaultUseCalloc();
+
+	size_t newSize                    = (size_t)(newMax + 1) * sizeof(T);
+	DqnMemAPICallbackResult memResult = {0};
+	DqnMemAPICallbackInfo info        = isInline
+	    ? DqnMemAPIInternal_CallbackInfoAskAlloc(str->memAPI, newSize)
+	    : DqnMemAPIInternal_CallbackInfoAskRealloc(str->memAPI, str->allocStr, (size_t)(str->max + 1) * sizeof(T), newSize);
+	str->memAPI.callback(info, &memResult);
+	if (!DQN_ASSERT_MSG(memResult.type == info.type, DQN_MEM_API_CALLBACK_RESULT_TYPE_INCORRECT))
+		return false;
+
+	T *newStr = (T *)memResult.newMemPtr;
+	if (!newStr) return false;
+
+	if (isInline) memcpy(newStr, str->inlineStr, (size_t)(str->len + 1) * sizeof(T));
+	str->allocStr = newStr;
+	str->max      = newMax;
+	return true;
+}
+
+// src:    Must not point into the string.
+// srcLen: -1 to take the length of the NUL terminated src.
+// return: FALSE if the memAPI is out of memory, the string is unchanged.
+template <typename T>
+bool DqnString_Set(DqnBasicString<T> *const str, const T *const src, i32 srcLen = -1)
+{
+	if (!str || !src) return false;
+	if (srcLen < 0) srcLen = DqnStringInternal_Len(src);
+	if (!DqnString_Reserve(str, srcLen)) return false;
+
+	T *dest = DqnString_Str(str);
+	memcpy(dest, src, (size_t)srcLen * sizeof(T));
+	dest[srcLen] = 0;
+	str->len     = srcLen;
+	return true;
+}
+
+// src:    Must not point into the string.
+// srcLen: -1 to take the length of the NUL terminated src.
+// return: FALSE if the memAPI is out of memory, the string is unchanged.
+template <typename T>
+bool DqnString_Append(DqnBasicString<T> *const str, const T *const src, i32 srcLen = -1)
+{
+	if (!str || !src) return false;
+	if (srcLen < 0) srcLen = DqnStringInternal_Len(src);
+
+	// NOTE: Grow geometrically so appending in a loop doesn't allocate each time
+	i32 newLen  = str->len + srcLen;
+	i32 currMax = DqnStringInternal_IsInline(str) ? DQN_STRING_INLINE_LEN(T) : str->max;
+	if (newLen > currMax && !DqnString_Reserve(str, DQN_MAX(newLen, currMax * 2))) return false;
+
+	T *dest = DqnString_Str(str);
+	memcpy(dest + str->len, src, (size_t)srcLen * sizeof(T));
+	dest[newLen] = 0;
+	str->len     = newLen;
+	return true;
+}
+
+// Empty the string, keeping its allocation for the next set.
+template <typename T>
+void DqnString_Clear(DqnBasicString<T> *const str)
+{
+	if (!str) return;
+	str->len              = 0;
+	DqnString_Str(str)[0] = 0;
+}
+
+// Give the allocation back to the memAPI, the string is empty and inline again.
+template <typename T>
+void DqnString_Free(DqnBasicString<T> *const str)
+{
+	if (!str) return;
+	if (!DqnStringInternal_IsInline(str))
+	{
+		size_t size                = (size_t)(str->max + 1) * sizeof(T);
+		DqnMemAPICallbackInfo info = DqnMemAPIInternal_CallbackInfoAskFree(str->memAPI, str->allocStr, size);
+		str->memAPI.callback(info, NULL);
+	}
+
+	DqnMemAPI memAPI = str->memAPI;
+	*str             = {};
+	str->memAPI      = memAPI;
+}
+
+// Replace the contents with printf style formatted text, growing to fit.
+// return: FALSE if the memAPI is out of memory, the string is unchanged.
+DQN_FILE_SCOPE bool DqnString_Sprintf(DqnString *const str, const char *const fmt, ...);
+
+template <typename T> T       *DqnBasicString<T>::Str    ()                                     { return DqnString_Str(this); }
+template <typename T> const T *DqnBasicString<T>::Str    () const                               { return DqnString_Str(this); }
+template <typename T> bool     DqnBasicString<T>::Reserve(const i32 newMax)                     { return DqnString_Reserve(this, newMax); }
+template <typename T> bool     DqnBasicString<T>::Set    (const T *const src, const i32 srcLen) { return DqnString_Set(this, src, srcLen); }
+template <typename T> bool     DqnBasicString<T>::Append (const T *const src, const i32 srcLen) { return DqnString_Append(this, src, srcLen); }
+template <typename T> void     DqnBasicString<T>::Clear  ()                                     { DqnString_Clear(this); }
+template <typename T> void     DqnBasicString<T>::Free   ()                                     { DqnString_Free(this); }
+#endif // DQN_CPP_MODE
+
 ////////////////////////////////////////////////////////////////////////////////
 // #DqnRnd Public API - Random Number Generator
 ////////////////////////////////////////////////////////////////////////////////
@@ -994,6 +2031,80 @@ DQN_FILE_SCOPE f32  DqnRnd_PCGNextf(DqnRandPCGState *pcg);
 // return: A random integer N between [min, max]
 DQN_FILE_SCOPE i32  DqnRnd_PCGRange(DqnRandPCGState *pcg, i32 min, i32 max);
 
+////////////////////////////////////////////////////////////////////////////////
+// #DqnTimerWheel Public API - Hierarchical Timer Wheel
+////////////////////////////////////////////////////////////////////////////////
+// Schedules callbacks to run after a delay. Tasks are bucketed by their due tick into
+// DQN_TIMER_WHEEL_LEVELS levels of DQN_TIMER_WHEEL_SLOTS slots, each level covering
+// DQN_TIMER_WHEEL_SLOTS times the range of the one below it. A task sits at the lowest level whose
+// range still shares the upper bits of its due tick with the current tick, and is cascaded down a
+// level as the wheel reaches its slot. Tasks beyond the top level wait in an overflow list.
+//
+// Schedule and Cancel are O(1). Tasks are intrusive and owned by the caller, they must stay at the
+// same address whilst scheduled. The wheel does not read the clock, the caller passes the current
+// time in so it can be driven by DqnTimer_NowInMs() or a simulated clock.
+//
+// How To Use:
+// 1. DqnTimerWheel_Init() with the tick resolution and the current time.
+// 2. Fill out a task's callback and userData, then DqnTimerWheel_Schedule() it.
+// 3. Sleep for DqnTimerWheel_MsUntilNextDue() then DqnTimerWheel_Advance() to dispatch due tasks.
+
+#define DQN_TIMER_WHEEL_SLOT_BITS 6
+#define DQN_TIMER_WHEEL_SLOTS     (1 << DQN_TIMER_WHEEL_SLOT_BITS)
+#define DQN_TIMER_WHEEL_LEVELS    4
+
+typedef struct DqnTimerWheelTask DqnTimerWheelTask;
+typedef void DqnTimerWheel_Callback(DqnTimerWheelTask *const task, const f64 nowInMs);
+
+typedef struct DqnTimerWheelTask
+{
+	// NOTE: Fields to fill out before scheduling.
+	DqnTimerWheel_Callback *callback;
+	void                   *userData;
+	f64                     periodInMs; // If > 0, the task is rescheduled this long after it's dispatched
+
+	// NOTE: Internal, managed by the wheel.
+	u64                       dueTick;
+	struct DqnTimerWheelTask *next;
+	struct DqnTimerWheelTask *prev;
+	struct DqnTimerWheelTask **slot; // The list the task is linked into, NULL if not scheduled
+} DqnTimerWheelTask;
+
+typedef struct DqnTimerWheel
+{
+	DqnTimerWheelTask *slots[DQN_TIMER_WHEEL_LEVELS][DQN_TIMER_WHEEL_SLOTS];
+	u64                occupied[DQN_TIMER_WHEEL_LEVELS]; // Bit per slot, set if the slot has tasks
+	DqnTimerWheelTask *overflow;
+
+	f64 startTimeInMs;
+	f64 tickInMs;
+	u64 currTick;
+	u32 numTasks;
+} DqnTimerWheel;
+
+// tickInMs: The resolution of the wheel, delays are rounded up to a multiple of this.
+// nowInMs:  The current time which all future times passed into the wheel are relative to.
+DQN_FILE_SCOPE void DqnTimerWheel_Init        (DqnTimerWheel *const wheel, const f64 tickInMs, const f64 nowInMs);
+
+// Schedule task to be dispatched delayInMs after the wheel's current time. If the task is already
+// scheduled it is moved. A delay of 0 dispatches on the next tick.
+// NOTE: The wheel's current time is the nowInMs of the last DqnTimerWheel_Advance(), advance after
+// sleeping before scheduling or the task is due early by however long was slept.
+DQN_FILE_SCOPE void DqnTimerWheel_Schedule    (DqnTimerWheel *const wheel, DqnTimerWheelTask *const task, const f64 delayInMs);
+// Unschedule task, does nothing if the task isn't scheduled. Safe to call from a callback.
+DQN_FILE_SCOPE void DqnTimerWheel_Cancel      (DqnTimerWheel *const wheel, DqnTimerWheelTask *const task);
+DQN_FILE_SCOPE bool DqnTimerWheel_IsScheduled (const DqnTimerWheelTask *const task);
+
+// Move the wheel forward to nowInMs, dispatching all tasks that are due in order of due tick.
+// Callbacks may schedule and cancel tasks, including themselves.
+// return: The number of tasks dispatched.
+DQN_FILE_SCOPE u32  DqnTimerWheel_Advance     (DqnTimerWheel *const wheel, const f64 nowInMs);
+
+// return: Milliseconds from nowInMs until the earliest task is due, 0 if already due, or
+//         DQN_TIMER_WHEEL_NO_TASKS if nothing is scheduled.
+#define DQN_TIMER_WHEEL_NO_TASKS -1.0
+DQN_FILE_SCOPE f64  DqnTimerWheel_MsUntilNextDue(const DqnTimerWheel *const wheel, const f64 nowInMs);
+
 ////////////////////////////////////////////////////////////////////////////////
 // #Dqn_* Public API
 ////////////////////////////////////////////////////////////////////////////////
@@ -1262,6 +2373,89 @@ DQN_FILE_SCOPE void DqnLock_Acquire(DqnLock *const lock);
 DQN_FILE_SCOPE void DqnLock_Release(DqnLock *const lock);
 DQN_FILE_SCOPE void DqnLock_Delete (DqnLock *const lock);
 
+////////////////////////////////////////////////////////////////////////////////
+// XPlatform > #DqnMemPoolThreadCache Public API - Per Thread Cache over a Shared DqnMemPool
+////////////////////////////////////////////////////////////////////////////////
+// Lets threads share one DqnMemPool. Each thread allocates and frees through its own cache of free
+// items, and only takes the lock to move a batch of items between its cache and the pool. Items
+// may be freed through a different thread's cache than they were allocated from.
+
+// NOTE: A cache holds up to twice this many free items before giving a batch back
+#define DQN_MEM_POOL_THREAD_CACHE_BATCH 32
+
+typedef struct DqnMemPoolThreadCache
+{
+	DqnMemPool *pool;     // Shared, only touched with the lock held
+	DqnLock    *lock;
+	void       *freeList;
+	u32         numFree;
+} DqnMemPoolThreadCache;
+
+// cache: Pass in a pointer to a zero cleared struct, one per thread.
+// pool:  Shared by every cache. Items held in caches count towards the pool's numItemsInUse.
+// lock:  Initialised lock shared by every cache of the pool.
+DQN_FILE_SCOPE void  DqnMemPoolThreadCache_Init    (DqnMemPoolThreadCache *const cache, DqnMemPool *const pool, DqnLock *const lock);
+
+// return: NULL if the pool is out of memory.
+DQN_FILE_SCOPE void *DqnMemPoolThreadCache_Alloc   (DqnMemPoolThreadCache *const cache, const bool zeroClear = true);
+DQN_FILE_SCOPE void  DqnMemPoolThreadCache_FreeItem(DqnMemPoolThreadCache *const cache, void *const item);
+
+// Give every cached item back to the pool, i.e. before the thread exits.
+DQN_FILE_SCOPE void  DqnMemPoolThreadCache_Flush   (DqnMemPoolThreadCache *const cache);
+
+////////////////////////////////////////////////////////////////////////////////
+// XPlatform > #DqnMemStackConcurrent Public API - Lock Free Push Only Stack Shared Between Threads
+////////////////////////////////////////////////////////////////////////////////
+// A push only DqnMemStack that any number of threads can push onto at once, i.e. jobs on a
+// DqnJobQueue each building part of one result. A push bumps the block's cursor with an atomic add
+// and the thread that runs off the end of the block chains on a new one with a compare swap, so
+// neither takes a lock. There's no pop, everything is given back at once by clear or free.
+
+typedef struct DqnMemStackConcurrentBlock
+{
+	u8                                *memory;
+	size_t                             size;
+	i64 volatile                       used;      // Overshoots size by the pushes that didn't fit
+	struct DqnMemStackConcurrentBlock *prevBlock; // Immutable once the block is chained on
+} DqnMemStackConcurrentBlock;
+
+typedef struct DqnMemStackConcurrent
+{
+	DqnMemStackConcurrentBlock *volatile block; // The newest block, the only one still being pushed onto
+	u32                                  byteAlign;
+	i32 volatile                         numBlocks;
+
+	// Set after init, new blocks grow like a DqnMemStack's
+	f32    blockGrowthFactor; // 0 uses DQN_MEM_STACK_BLOCK_GROWTH_FACTOR
+	size_t maxBlockSize;      // 0 uses DQN_MEM_STACK_MAX_BLOCK_SIZE
+
+#if defined(DQN_CPP_MODE)
+	bool  Init (const size_t size, const u32 byteAlignment = 4);
+	void *Push (const size_t size);
+	void  Clear();
+	void  Free ();
+#endif
+} DqnMemStackConcurrent;
+
+// stack:     Pass in a pointer to a zero cleared struct, or one that's been freed.
+// size:      The size of the first block.
+// byteAlign: Alignment of every push, must be a power of 2.
+// return:    FALSE if args are invalid, the stack already has a block or the first block couldn't be
+//            allocated.
+DQN_FILE_SCOPE bool  DqnMemStackConcurrent_Init (DqnMemStackConcurrent *const stack, const size_t size, const u32 byteAlign = 4);
+
+// Safe to call from any number of threads at once. A push that doesn't fit in the newest block
+// leaves the rest of that block unused.
+// size:   Aligned to the stack's byteAlign.
+// return: NULL if a new block was needed and malloc failed.
+DQN_FILE_SCOPE void *DqnMemStackConcurrent_Push (DqnMemStackConcurrent *const stack, const size_t size);
+
+// NOTE: Not thread safe, call these once every thread has stopped pushing, i.e. after
+// DqnJobQueue_BlockAndCompleteAllJobs(). Every pushed pointer is invalid after either.
+// Free every block but the newest and reset it, so the next round of pushes reuses it.
+DQN_FILE_SCOPE void  DqnMemStackConcurrent_Clear(DqnMemStackConcurrent *const stack);
+DQN_FILE_SCOPE void  DqnMemStackConcurrent_Free (DqnMemStackConcurrent *const stack);
+
 ////////////////////////////////////////////////////////////////////////////////
 // XPlatform > #DqnJobQueue Public API - Multithreaded Job Queue
 ////////////////////////////////////////////////////////////////////////////////
@@ -1329,7 +2523,7 @@ typedef struct DqnJobQueue
 // jobListSize: The number of elements in the jobList array
 // numThreads:  The number of threads the queue should request from the OS for working on the queue
 // return:      FALSE if invalid args i.e. NULL ptrs or jobListSize & numThreads == 0
-DQN_FILE_SCOPE bool DqnJobQueue_Init(DqnJobQueue *const queue, const DqnJob *const jobList,
+DQN_FILE_SCOPE bool DqnJobQueue_Init(DqnJobQueue *const queue, DqnJob *const jobList,
                                      const u32 jobListSize, const u32 numThreads);
 
 // return: FALSE if the job is not able to be added, this occurs if the queue is full.
@@ -1350,34 +2544,124 @@ DQN_FILE_SCOPE bool DqnJobQueue_TryExecuteNextJob(DqnJobQueue *const queue);
 DQN_FILE_SCOPE bool DqnJobQueue_AllJobsComplete  (DqnJobQueue *const queue);
 
 ////////////////////////////////////////////////////////////////////////////////
-// XPlatform > #DqnAtomic Public API - Interlocks/Atomic Operations
+// XPlatform > #DqnJobGraph Public API - Job Dependency Graph
 ////////////////////////////////////////////////////////////////////////////////
-// All atomic operations generate a full read/write barrier. This is implicitly enforced by the
-// OS calls, not explicitly in my code.
+// DqnJobGraph runs a set of jobs with dependencies between them on a DqnJobQueue. A node is pushed
+// onto the queue as soon as the last of its dependencies completes, so independent chains of work
+// overlap across threads without hand written barriers.
 
-// swapVal:    The value to put into "dest", IF at point of read, "dest" has the value of "compareVal"
-// compareVal: The value to check in "dest"
-// return:     Return the original value that was in "dest"
-DQN_FILE_SCOPE i32 DqnAtomic_CompareSwap32(i32 volatile *const dest, const i32 swapVal, const i32 compareVal);
+// Usage
+// 1. DqnJobGraph_Init() with caller allocated node and edge arrays, like DqnJobQueue's jobList.
+// 2. DqnJobGraph_AddNode() for each job, then DqnJobGraph_AddDependency() for each edge.
+// 3. DqnJobGraph_Run() from the thread that owns the queue. It dispatches ready nodes and helps
+//    execute them until the whole graph is complete. The graph can be run again afterwards.
 
-// Add "value" to src
-// return: The new value at src
-DQN_FILE_SCOPE i32 DqnAtomic_Add32(i32 volatile *const src, const i32 value);
+#define DQN_JOB_GRAPH_INVALID_NODE ((u32)-1)
 
-////////////////////////////////////////////////////////////////////////////////
-// XPlatform > #DqnPlatform Public API - Common Platform API Helpers
-////////////////////////////////////////////////////////////////////////////////
-// Uses a single call to DqnMem_Calloc() and DqnMem_Free(). Not completely platform "independent" for Unix.
-// numCores: numThreadsPerCore: Can be NULL, the function will just skip it.
-DQN_FILE_SCOPE void DqnPlatform_GetNumThreadsAndCores(u32 *const numCores, u32 *const numThreadsPerCore);
+typedef struct DqnJobGraph DqnJobGraph;
 
-////////////////////////////////////////////////////////////////////////////////
-// #Platform Public API
-////////////////////////////////////////////////////////////////////////////////
-// Functions here are only available for the #defined sections (i.e. all functions in
-// DQN_WIN32_PLATFORM only have a valid implementation in Win32.
+typedef struct DqnJobGraphNode
+{
+	DqnJob_Callback *callback;
+	void            *userData;
+	DqnJobGraph     *graph;
 
-////////////////////////////////////////////////////////////////////////////////
+	u32 firstDependentEdge; // Singly linked list of edges to nodes that depend on this one
+	u32 numDependencies;
+
+	// NOTE(doyle): Modified by worker threads whilst running
+	i32 volatile numPendingDependencies;
+	i32 volatile readyListEntry; // Slot in the graph's ready list, indexed by order of becoming ready
+} DqnJobGraphNode;
+
+typedef struct DqnJobGraphEdge
+{
+	u32 dependent;
+	u32 next;
+} DqnJobGraphEdge;
+
+typedef struct DqnJobGraph
+{
+	DqnJobQueue     *queue;
+	DqnJobGraphNode *nodes;
+	DqnJobGraphEdge *edges;
+	u32              maxNodes;
+	u32              maxEdges;
+	u32              numNodes;
+	u32              numEdges;
+
+	// NOTE(doyle): Modified by main+worker threads whilst running
+	i32 volatile readyListWriteIndex;
+	i32 volatile numNodesRemaining;
+
+	// NOTE: Modified by main thread ONLY
+	i32 readyListReadIndex;
+
+#if defined(DQN_CPP_MODE)
+	bool Init         (DqnJobQueue *const queue_, DqnJobGraphNode *const nodes_, const u32 maxNodes_,
+	                   DqnJobGraphEdge *const edges_, const u32 maxEdges_);
+	u32  AddNode      (DqnJob_Callback *const callback, void *const userData);
+	bool AddDependency(const u32 node, const u32 dependsOn);
+	bool Run          ();
+#endif
+} DqnJobGraph;
+
+// graph: Pass a pointer to a zero cleared DqnJobGraph struct
+// queue: The queue to run jobs on. It must have room for at least one job.
+// nodes: Pass in a pointer to an array of DqnJobGraphNode's, maxNodes long
+// edges: Pass in a pointer to an array of DqnJobGraphEdge's, maxEdges long
+// return: FALSE if invalid args i.e. NULL ptrs or maxNodes == 0
+DQN_FILE_SCOPE bool DqnJobGraph_Init(DqnJobGraph *const graph, DqnJobQueue *const queue,
+                                     DqnJobGraphNode *const nodes, const u32 maxNodes,
+                                     DqnJobGraphEdge *const edges, const u32 maxEdges);
+
+// return: The index of the node to pass into AddDependency(), DQN_JOB_GRAPH_INVALID_NODE if the
+//         nodes array is full.
+DQN_FILE_SCOPE u32  DqnJobGraph_AddNode      (DqnJobGraph *const graph, DqnJob_Callback *const callback, void *const userData);
+
+// Make "node" wait until "dependsOn" has completed.
+// return: FALSE if the edges array is full or either node is invalid.
+DQN_FILE_SCOPE bool DqnJobGraph_AddDependency(DqnJobGraph *const graph, const u32 node, const u32 dependsOn);
+
+// Execute every node in dependency order, blocking until all are complete. Must be called from the
+// thread that adds jobs to the queue and the queue should have no other jobs in flight.
+// return: FALSE if the graph has a cycle, in which case the nodes in the cycle are never run.
+DQN_FILE_SCOPE bool DqnJobGraph_Run(DqnJobGraph *const graph);
+
+////////////////////////////////////////////////////////////////////////////////
+// XPlatform > #DqnAtomic Public API - Interlocks/Atomic Operations
+////////////////////////////////////////////////////////////////////////////////
+// All atomic operations generate a full read/write barrier. This is implicitly enforced by the
+// OS calls, not explicitly in my code.
+
+// swapVal:    The value to put into "dest", IF at point of read, "dest" has the value of "compareVal"
+// compareVal: The value to check in "dest"
+// return:     Return the original value that was in "dest"
+DQN_FILE_SCOPE i32 DqnAtomic_CompareSwap32(i32 volatile *const dest, const i32 swapVal, const i32 compareVal);
+
+// Add "value" to src
+// return: The new value at src
+DQN_FILE_SCOPE i32 DqnAtomic_Add32(i32 volatile *const src, const i32 value);
+DQN_FILE_SCOPE i64 DqnAtomic_Add64(i64 volatile *const src, const i64 value);
+
+// Pointer sized DqnAtomic_CompareSwap32()
+// return: Return the original value that was in "dest"
+DQN_FILE_SCOPE void *DqnAtomic_CompareSwapPtr(void *volatile *const dest, void *const swapVal, void *const compareVal);
+
+////////////////////////////////////////////////////////////////////////////////
+// XPlatform > #DqnPlatform Public API - Common Platform API Helpers
+////////////////////////////////////////////////////////////////////////////////
+// Uses a single call to DqnMem_Calloc() and DqnMem_Free(). Not completely platform "independent" for Unix.
+// numCores: numThreadsPerCore: Can be NULL, the function will just skip it.
+DQN_FILE_SCOPE void DqnPlatform_GetNumThreadsAndCores(u32 *const numCores, u32 *const numThreadsPerCore);
+
+////////////////////////////////////////////////////////////////////////////////
+// #Platform Public API
+////////////////////////////////////////////////////////////////////////////////
+// Functions here are only available for the #defined sections (i.e. all functions in
+// DQN_WIN32_PLATFORM only have a valid implementation in Win32.
+
+////////////////////////////////////////////////////////////////////////////////
 // #Win32Platform Public API
 ////////////////////////////////////////////////////////////////////////////////
 #if defined(DQN_IS_WIN32)
@@ -1968,15 +3252,24 @@ DQN_FILE_SCOPE bool DqnAssertInternal(const bool result, const char *const file,
 ////////////////////////////////////////////////////////////////////////////////
 // NOTE: All memory allocations in dqn.h go through these functions. So they can
 // be rerouted fairly easily especially for platform specific mallocs.
+FILE_SCOPE DqnMemStats dqnMemStatsInternal;
+
+DQN_FILE_SCOPE DqnMemStats DqnMem_GetStats()
+{
+	return dqnMemStatsInternal;
+}
+
 DQN_FILE_SCOPE void *DqnMem_Alloc(const size_t size)
 {
 	void *result = malloc(size);
+	dqnMemStatsInternal.numAllocs++;
 	return result;
 }
 
 DQN_FILE_SCOPE void *DqnMem_Calloc(const size_t size)
 {
 	void *result = calloc(1, size);
+	dqnMemStatsInternal.numAllocs++;
 	return result;
 }
 
@@ -1988,12 +3281,17 @@ DQN_FILE_SCOPE void DqnMem_Clear(void *const memory, const u8 clearValue, const
 DQN_FILE_SCOPE void *DqnMem_Realloc(void *memory, const size_t newSize)
 {
 	void *result = realloc(memory, newSize);
+	dqnMemStatsInternal.numReallocs++;
 	return result;
 }
 
 DQN_FILE_SCOPE void DqnMem_Free(void *memory)
 {
-	if (memory) free(memory);
+	if (memory)
+	{
+		free(memory);
+		dqnMemStatsInternal.numFrees++;
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2015,13 +3313,143 @@ DqnMemStackInternal_AllocateBlock(u32 byteAlign, size_t size, const bool zeroCle
 
 	if (!result) return NULL;
 
-	result->memory    = (u8 *)DQN_ALIGN_POW_N((u8 *)result + sizeof(*result), byteAlign);
-	result->size      = alignedSize;
-	result->used      = 0;
-	result->prevBlock = NULL;
+	result->memory     = (u8 *)DQN_ALIGN_POW_N((u8 *)result + sizeof(*result), byteAlign);
+	result->size       = alignedSize;
+	result->used       = 0;
+	result->committed  = alignedSize;
+	result->commitSize = 0;
+	result->prevBlock  = NULL;
+	return result;
+}
+
+// NOTE: A virtual memory block lives at the start of its own reservation, "memory" follows it
+#if defined(DQN_UNIX_PLATFORM)
+	#include <sys/mman.h> // mmap(), mprotect(), madvise()
+#endif
+
+FILE_SCOPE size_t DqnMemStackInternal_VirtualReserveSize(const DqnMemStackBlock *const block)
+{
+	size_t result = (size_t)(block->memory - (u8 *)block) + block->size;
 	return result;
 }
 
+// size:   Rounded up to the huge page size on Win32 if large pages are used.
+// return: NULL if the range could not be reserved.
+FILE_SCOPE u8 *DqnMemStackInternal_VirtualReserve(size_t *const size, const bool hugePages,
+                                                  bool *const isCommitted)
+{
+	*isCommitted = false;
+#if defined(DQN_WIN32_PLATFORM)
+	if (hugePages)
+	{
+		// NOTE: Large pages can't be committed piecemeal, they're locked in memory from the start
+		size_t largePageSize = GetLargePageMinimum();
+		if (largePageSize > 0)
+		{
+			size_t largeSize = DQN_ALIGN_POW_N(*size, largePageSize);
+			u8 *result       = (u8 *)VirtualAlloc(NULL, largeSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+			if (result)
+			{
+				*size        = largeSize;
+				*isCommitted = true;
+				return result;
+			}
+		}
+	}
+
+	u8 *result = (u8 *)VirtualAlloc(NULL, *size, MEM_RESERVE, PAGE_NOACCESS);
+	return result;
+
+#elif defined(DQN_UNIX_PLATFORM)
+	// NOTE: Transparent huge pages are only used for 2MB aligned ranges, so over reserve to align
+	// the start and return the slack either side.
+	size_t slack   = (hugePages) ? DQN_MEM_STACK_HUGE_PAGE_SIZE : 0;
+	void *reserved = mmap(NULL, *size + slack, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (reserved == MAP_FAILED) return NULL;
+
+	u8 *result = (u8 *)reserved;
+	if (hugePages)
+	{
+		result           = (u8 *)DQN_ALIGN_POW_N(reserved, DQN_MEM_STACK_HUGE_PAGE_SIZE);
+		size_t headSlack = (size_t)(result - (u8 *)reserved);
+		if (headSlack > 0) munmap(reserved, headSlack);
+		if (slack > headSlack) munmap(result + *size, slack - headSlack);
+
+	#if defined(MADV_HUGEPAGE)
+		madvise(result, *size, MADV_HUGEPAGE);
+	#endif
+	}
+	return result;
+
+#else
+	(void)size; (void)hugePages;
+	return NULL;
+#endif
+}
+
+FILE_SCOPE bool DqnMemStackInternal_VirtualCommit(u8 *const address, const size_t size)
+{
+#if defined(DQN_WIN32_PLATFORM)
+	bool result = (VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) != NULL);
+	return result;
+#elif defined(DQN_UNIX_PLATFORM)
+	bool result = (mprotect(address, size, PROT_READ | PROT_WRITE) == 0);
+	return result;
+#else
+	(void)address; (void)size;
+	return false;
+#endif
+}
+
+FILE_SCOPE void DqnMemStackInternal_VirtualDecommit(u8 *const address, const size_t size, const bool hugePages)
+{
+#if defined(DQN_WIN32_PLATFORM)
+	VirtualFree(address, size, MEM_DECOMMIT);
+	(void)hugePages;
+#elif defined(DQN_UNIX_PLATFORM)
+	// NOTE: Mapping fresh PROT_NONE pages over the range frees the pages and their commit charge in
+	// one call, but it's a new mapping so the huge page advice has to be given again.
+	mmap(address, size, PROT_NONE, MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	#if defined(MADV_HUGEPAGE)
+	if (hugePages) madvise(address, size, MADV_HUGEPAGE);
+	#endif
+#else
+	(void)address; (void)size; (void)hugePages;
+#endif
+}
+
+FILE_SCOPE void DqnMemStackInternal_VirtualRelease(u8 *const address, const size_t size)
+{
+#if defined(DQN_WIN32_PLATFORM)
+	VirtualFree(address, 0, MEM_RELEASE);
+	(void)size;
+#elif defined(DQN_UNIX_PLATFORM)
+	munmap(address, size);
+#else
+	(void)address; (void)size;
+#endif
+}
+
+// Make sure the first "used" bytes of the current block are backed by pages.
+// return: FALSE if the pages could not be committed.
+FILE_SCOPE bool DqnMemStackInternal_Commit(DqnMemStack *const stack, const size_t used)
+{
+	DqnMemStackBlock *block = stack->block;
+	if (used <= block->committed) return true;
+	DQN_ASSERT_HARD(stack->flags & DqnMemStackFlag_IsVirtualMemory);
+
+	// NOTE: Pages are committed from the start of the reservation, which the block header sits in
+	size_t headerSize   = (size_t)(block->memory - (u8 *)block);
+	size_t reserveSize  = DqnMemStackInternal_VirtualReserveSize(block);
+	size_t commitStart  = headerSize + block->committed;
+	size_t commitEnd    = DQN_MIN(DQN_ALIGN_POW_N(headerSize + used, block->commitSize), reserveSize);
+	if (!DqnMemStackInternal_VirtualCommit((u8 *)block + commitStart, commitEnd - commitStart))
+		return false;
+
+	block->committed = commitEnd - headerSize;
+	return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // #DqnMemStack CPP Implementation
 ////////////////////////////////////////////////////////////////////////////////
@@ -2029,13 +3457,15 @@ DqnMemStackInternal_AllocateBlock(u32 byteAlign, size_t size, const bool zeroCle
 bool DqnMemStack::InitWithFixedMem (u8 *const mem,     const size_t memSize, const u32 byteAlignment) { return DqnMemStack_InitWithFixedMem (this, mem, memSize, byteAlignment);    }
 bool DqnMemStack::InitWithFixedSize(const size_t size, const bool zeroClear, const u32 byteAlignment) { return DqnMemStack_InitWithFixedSize(this, size, zeroClear, byteAlignment); }
 bool DqnMemStack::Init             (const size_t size, const bool zeroClear, const u32 byteAlignment) { return DqnMemStack_Init             (this, size, zeroClear, byteAlignment); }
+bool DqnMemStack::InitWithVirtualMem(const size_t reserveSize, const u32 virtualFlags, const u32 byteAlignment) { return DqnMemStack_InitWithVirtualMem(this, reserveSize, virtualFlags, byteAlignment); }
 
-void *DqnMemStack::Push(size_t size)                        { return DqnMemStack_Push(this, size);                }
-void  DqnMemStack::Pop (void *const ptr, size_t size)       {        DqnMemStack_Pop (this, ptr, size);           }
+void *DqnMemStack::Push(size_t size, const u32 alignment)   { return DqnMemStack_Push(this, size, alignment);     }
+void  DqnMemStack::Pop (void *const ptr, size_t size, const u32 alignment) { DqnMemStack_Pop (this, ptr, size, alignment); }
 void  DqnMemStack::Free()                                   {        DqnMemStack_Free(this);                      }
 bool  DqnMemStack::FreeMemBlock(DqnMemStackBlock *memBlock) { return DqnMemStack_FreeMemBlock(this, memBlock);       }
 bool  DqnMemStack::FreeLastBlock()                          { return DqnMemStack_FreeLastBlock(this);             }
 void  DqnMemStack::ClearCurrBlock(const bool zeroClear)     {        DqnMemStack_ClearCurrBlock(this, zeroClear); }
+bool  DqnMemStack::DecommitUnused(const size_t keepSize)    { return DqnMemStack_DecommitUnused(this, keepSize);  }
 
 DqnMemStackTempRegion DqnMemStack::TempRegionBegin()
 {
@@ -2077,6 +3507,7 @@ DQN_FILE_SCOPE bool DqnMemStack_InitWithFixedMem(DqnMemStack *const stack, u8 *c
 	stack->block->memory    = mem + sizeof(DqnMemStackBlock);
 	stack->block->used      = 0;
 	stack->block->size      = memSize - sizeof(DqnMemStackBlock);
+	stack->block->committed = stack->block->size;
 	stack->block->prevBlock = NULL;
 	stack->flags = (DqnMemStackFlag_IsFixedMemoryFromUser | DqnMemStackFlag_IsNotExpandable);
 
@@ -2120,23 +3551,92 @@ DQN_FILE_SCOPE bool DqnMemStack_Init(DqnMemStack *const stack, size_t size, cons
 	return true;
 }
 
+DQN_FILE_SCOPE bool DqnMemStack_InitWithVirtualMem(DqnMemStack *const stack, const size_t reserveSize,
+                                                   const u32 virtualFlags, const u32 byteAlign)
+{
+	if (!stack || reserveSize == 0 || byteAlign == 0) return false;
+	if (!DQN_ASSERT_MSG(!stack->block, "MemStack has pre-existing block already attached"))
+		return false;
+
+	bool hugePages    = (virtualFlags & DqnMemStackVirtualFlag_HugePages) != 0;
+	size_t commitSize = (hugePages) ? DQN_MEM_STACK_HUGE_PAGE_SIZE : DQN_MEM_STACK_COMMIT_SIZE;
+	size_t size       = DQN_ALIGN_POW_N(reserveSize + sizeof(DqnMemStackBlock) + byteAlign, commitSize);
+
+	bool isCommitted;
+	u8 *memory = DqnMemStackInternal_VirtualReserve(&size, hugePages, &isCommitted);
+	if (!memory) return false;
+
+	// NOTE: The block header needs its page before it can be written to
+	if (!isCommitted && !DqnMemStackInternal_VirtualCommit(memory, commitSize))
+	{
+		DqnMemStackInternal_VirtualRelease(memory, size);
+		return false;
+	}
+
+	DqnMemStackBlock *block = (DqnMemStackBlock *)memory;
+	block->memory           = (u8 *)DQN_ALIGN_POW_N(memory + sizeof(DqnMemStackBlock), byteAlign);
+	block->size             = size - (size_t)(block->memory - memory);
+	block->used             = 0;
+	block->committed        = (isCommitted) ? block->size : commitSize - (size_t)(block->memory - memory);
+	block->commitSize       = (isCommitted) ? 0 : commitSize;
+	block->prevBlock        = NULL;
+
+	stack->block           = block;
+	stack->tempRegionCount = 0;
+	stack->byteAlign       = byteAlign;
+	stack->flags           = (DqnMemStackFlag_IsVirtualMemory | DqnMemStackFlag_IsNotExpandable);
+	return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // #DqnMemStack Push/Pop/Free Implementation
 ////////////////////////////////////////////////////////////////////////////////
-DQN_FILE_SCOPE void *DqnMemStack_Push(DqnMemStack *const stack, size_t size)
+// NOTE: A push aligned past the stack's byteAlign stores its padding in the u32 in front of it, since
+// Pop can't tell where the allocation before it ended. Kept a multiple of byteAlign so the padding
+// stays under headerSize + alignment - byteAlign.
+FILE_SCOPE inline size_t DqnMemStackInternal_PaddingHeaderSize(const DqnMemStack *const stack, const u32 alignment)
+{
+	size_t result = (alignment > stack->byteAlign) ? DQN_ALIGN_POW_N(sizeof(u32), stack->byteAlign) : 0;
+	return result;
+}
+
+// headerSize: Bytes that must fit in the padding, in front of the allocation.
+// return: The bytes of padding needed to align the next allocation in block, (size_t)-1 if it doesn't fit.
+FILE_SCOPE size_t DqnMemStackInternal_FitInBlock(const DqnMemStackBlock *const block, const size_t alignedSize,
+                                                 const u32 alignment, const size_t headerSize)
+{
+	if (!block) return (size_t)-1;
+
+	u8 *currPointer = block->memory + block->used;
+	size_t result   = (size_t)((u8 *)DQN_ALIGN_POW_N(currPointer + headerSize, alignment) - currPointer);
+	if (block->used + result + alignedSize > block->size) return (size_t)-1;
+	return result;
+}
+
+DQN_FILE_SCOPE void *DqnMemStack_Push(DqnMemStack *const stack, size_t size, const u32 alignment)
 {
 	if (!stack || size == 0) return NULL;
+	if (!DQN_ASSERT_MSG((alignment & (alignment - 1)) == 0, "alignment must be a power of 2: %d", alignment))
+		return NULL;
 
+	// NOTE: The size stays a multiple of the stack's alignment, so the stack's own pushes stay
+	// aligned after a more strictly aligned one
+	u32 pushAlign      = DQN_MAX(alignment, stack->byteAlign);
 	size_t alignedSize = DQN_ALIGN_POW_N(size, stack->byteAlign);
-	if (!stack->block ||
-	    (stack->block->used + alignedSize) > stack->block->size)
+	size_t headerSize  = DqnMemStackInternal_PaddingHeaderSize(stack, pushAlign);
+	size_t padding     = DqnMemStackInternal_FitInBlock(stack->block, alignedSize, pushAlign, headerSize);
+	if (padding == (size_t)-1)
 	{
-		size_t newBlockSize;
-		// TODO(doyle): Allocate block size based on the aligned size or
-		// a minimum block size? Not allocate based on the current block
-		// size
-		if (stack->block) newBlockSize = DQN_MAX(alignedSize, stack->block->size);
-		else newBlockSize = alignedSize;
+		// NOTE: Blocks are only aligned to the stack's alignment, leave room to align further
+		size_t requiredSize = alignedSize + headerSize + (pushAlign - stack->byteAlign);
+		size_t newBlockSize = requiredSize;
+		if (stack->block)
+		{
+			f32 growthFactor    = (stack->blockGrowthFactor == 0) ? DQN_MEM_STACK_BLOCK_GROWTH_FACTOR : stack->blockGrowthFactor;
+			size_t maxBlockSize = (stack->maxBlockSize == 0) ? (size_t)DQN_MEM_STACK_MAX_BLOCK_SIZE : stack->maxBlockSize;
+			size_t grownSize    = (size_t)(stack->block->size * growthFactor);
+			newBlockSize        = DQN_MAX(requiredSize, DQN_MIN(grownSize, maxBlockSize));
+		}
 
 		DqnMemStackBlock *newBlock = DqnMemStack_AllocateCompatibleBlock(stack, newBlockSize, true);
 		if (newBlock)
@@ -2156,26 +3656,27 @@ DQN_FILE_SCOPE void *DqnMemStack_Push(DqnMemStack *const stack, size_t size)
 			// is configured such that new blocks are not allowed.
 			return NULL;
 		}
+
+		padding = DqnMemStackInternal_FitInBlock(stack->block, alignedSize, pushAlign, headerSize);
+		DQN_ASSERT_HARD(padding != (size_t)-1);
 	}
 
-	u8 *currPointer        = stack->block->memory + stack->block->used;
-	u8 *alignedResult      = (u8 *)DQN_ALIGN_POW_N(currPointer, stack->byteAlign);
-	size_t alignmentOffset = (size_t)(alignedResult - currPointer);
+	if (!DqnMemStackInternal_Commit(stack, stack->block->used + padding + alignedSize))
+		return NULL;
 
-	// NOTE(doyle): Since all stack can't change alignment once they've been
-	// initialised and that the base memory ptr is already aligned, then all
-	// subsequent allocations should also be aligned automatically.
-	// TODO(doyle): In the future, do we want to allow arbitrary alignment PER
-	// allocation, not per MemStack?
-	DQN_ASSERT_HARD(alignmentOffset == 0);
+	u8 *result = stack->block->memory + stack->block->used + padding;
+	if (headerSize > 0)
+	{
+		u32 paddingToStore = (u32)padding;
+		memcpy(result - headerSize, &paddingToStore, sizeof(paddingToStore));
+	}
 
-	void *result = alignedResult;
-	stack->block->used += (alignedSize + alignmentOffset);
+	stack->block->used += (padding + alignedSize);
 	DQN_ASSERT_HARD(stack->block->used <= stack->block->size);
 	return result;
 }
 
-DQN_FILE_SCOPE bool DqnMemStack_Pop(DqnMemStack *const stack, void *ptr, size_t size)
+DQN_FILE_SCOPE bool DqnMemStack_Pop(DqnMemStack *const stack, void *ptr, size_t size, const u32 alignment)
 {
 	if (!stack || !stack->block) return false;
 
@@ -2187,7 +3688,15 @@ DQN_FILE_SCOPE bool DqnMemStack_Pop(DqnMemStack *const stack, void *ptr, size_t
 		size_t sizeAligned = DQN_ALIGN_POW_N(size, stack->byteAlign);
 		if (DQN_ASSERT_MSG(calcSize == sizeAligned, "'ptr' was not the last item allocated to memStack"))
 		{
-			stack->block->used -= sizeAligned;
+			u32 padding       = 0;
+			size_t headerSize = DqnMemStackInternal_PaddingHeaderSize(stack, alignment);
+			if (headerSize > 0) memcpy(&padding, (u8 *)ptr - headerSize, sizeof(padding));
+
+			if (!DQN_ASSERT_MSG(padding <= (size_t)((u8 *)ptr - stack->block->memory),
+			                    "'ptr' was not pushed with the given alignment: %d", alignment))
+				return false;
+
+			stack->block->used -= (sizeAligned + padding);
 			if (stack->block->used == 0 && stack->block->prevBlock)
 			{
 				return DQN_ASSERT(DqnMemStack_FreeLastBlock(stack));
@@ -2217,7 +3726,7 @@ DQN_FILE_SCOPE void DqnMemStack_Free(DqnMemStack *stack)
 
 	// After a stack is free, we reset the not expandable flag so that if we
 	// allocate on an empty stack it still works.
-	stack->flags &= ~DqnMemStackFlag_IsNotExpandable;
+	stack->flags &= ~(DqnMemStackFlag_IsNotExpandable | DqnMemStackFlag_IsVirtualMemory);
 }
 
 DQN_FILE_SCOPE bool DqnMemStack_FreeMemBlock(DqnMemStack *const stack, DqnMemStackBlock *memBlock)
@@ -2234,7 +3743,10 @@ DQN_FILE_SCOPE bool DqnMemStack_FreeMemBlock(DqnMemStack *const stack, DqnMemSta
 	{
 		DqnMemStackBlock *blockToFree = *blockPtr;
 		(*blockPtr)                    = blockToFree->prevBlock;
-		DqnMem_Free(blockToFree);
+		if (stack->flags & DqnMemStackFlag_IsVirtualMemory)
+			DqnMemStackInternal_VirtualRelease((u8 *)blockToFree, DqnMemStackInternal_VirtualReserveSize(blockToFree));
+		else
+			DqnMem_Free(blockToFree);
 
 		// No more blocks, then last block has been freed
 		if (!stack->block) DQN_ASSERT_HARD(stack->tempRegionCount == 0);
@@ -2258,11 +3770,34 @@ DQN_FILE_SCOPE void DqnMemStack_ClearCurrBlock(DqnMemStack *const stack, const b
 		stack->block->used = 0;
 		if (zeroClear)
 		{
-			DqnMem_Clear(stack->block->memory, 0, stack->block->size);
+			DqnMem_Clear(stack->block->memory, 0, stack->block->committed);
 		}
 	}
 }
 
+DQN_FILE_SCOPE bool DqnMemStack_DecommitUnused(DqnMemStack *const stack, const size_t keepSize)
+{
+	if (!stack || !stack->block || !(stack->flags & DqnMemStackFlag_IsVirtualMemory)) return false;
+
+	DqnMemStackBlock *block = stack->block;
+	if (block->commitSize == 0) return true;
+
+	// NOTE: Never decommit the page the block header is in
+	size_t headerSize = (size_t)(block->memory - (u8 *)block);
+	size_t keepEnd    = DQN_MAX(headerSize + block->used + keepSize, block->commitSize);
+	keepEnd           = DQN_MIN(DQN_ALIGN_POW_N(keepEnd, block->commitSize), DqnMemStackInternal_VirtualReserveSize(block));
+
+	size_t commitEnd = headerSize + block->committed;
+	if (keepEnd < commitEnd)
+	{
+		bool hugePages = (block->commitSize == DQN_MEM_STACK_HUGE_PAGE_SIZE);
+		DqnMemStackInternal_VirtualDecommit((u8 *)block + keepEnd, commitEnd - keepEnd, hugePages);
+		block->committed = keepEnd - headerSize;
+	}
+
+	return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // #DqnMemStackTempRegion Implementation
 ////////////////////////////////////////////////////////////////////////////////
@@ -2376,66 +3911,230 @@ DQN_FILE_SCOPE void DqnMemStack_FreeDetachedBlock(DqnMemStackBlock *memBlock)
 ////////////////////////////////////////////////////////////////////////////////
 // #DqnMemAPIInternal Implementation
 ////////////////////////////////////////////////////////////////////////////////
-FILE_SCOPE inline DqnMemAPICallbackInfo
-DqnMemAPIInternal_CallbackInfoAskRealloc(const DqnMemAPI memAPI,
-                                         void *const oldMemPtr,
-                                         const size_t oldSize,
-                                         const size_t newSize)
+FILE_SCOPE void DqnMemAPIInternal_ValidateCallbackInfo(DqnMemAPICallbackInfo info)
 {
-	DqnMemAPICallbackInfo info = {0};
-	info.type           = DqnMemAPICallbackType_Realloc;
-	info.userContext    = memAPI.userContext;
-	info.newRequestSize = newSize;
-	info.oldMemPtr      = oldMemPtr;
-	info.oldSize        = oldSize;
-	return info;
+	DQN_ASSERT_HARD(info.type != DqnMemAPICallbackType_Invalid);
+
+	switch(info.type)
+	{
+		case DqnMemAPICallbackType_Alloc:
+		{
+			DQN_ASSERT_HARD(info.requestSize > 0);
+		}
+		break;
+
+		case DqnMemAPICallbackType_Realloc:
+		{
+			DQN_ASSERT_HARD(info.oldSize > 0);
+			DQN_ASSERT_HARD(info.requestSize > 0);
+			DQN_ASSERT_HARD(info.oldMemPtr);
+		}
+		break;
+
+		case DqnMemAPICallbackType_Free:
+		{
+			// nothing to validate
+		}
+		break;
+
+		default:
+		{
+			DQN_ASSERT_HARD(DQN_INVALID_CODE_PATH);
+		}
+		break;
+	}
+}
+
+FILE_SCOPE void DqnMemAPIInternal_DefaultUseCallocCallback(DqnMemAPICallbackInfo info,
+                                                           DqnMemAPICallbackResult *result)
+{
+	DQN_ASSERT_HARD(!info.userContext);
+
+	DqnMemAPIInternal_ValidateCallbackInfo(info);
+	switch(info.type)
+	{
+		case DqnMemAPICallbackType_Alloc:
+		{
+			result->type = info.type;
+			result->newMemPtr = DqnMem_Calloc(info.requestSize);
+		}
+		break;
+
+		case DqnMemAPICallbackType_Realloc:
+		{
+			result->type = info.type;
+			result->newMemPtr =
+			    DqnMem_Realloc(info.oldMemPtr, info.newRequestSize);
+		}
+		break;
+
+		case DqnMemAPICallbackType_Free:
+		{
+			// NOTE(doyle): We can pass in NULL as result if we're freeing since
+			// there's nothing to return. But if the callback result has been
+			// passed in, we can fill the type data out.
+			if (result) result->type = info.type;
+			DqnMem_Free(info.ptrToFree);
+		}
+		break;
+
+		default:
+		{
+			DQN_ASSERT_HARD(DQN_INVALID_CODE_PATH);
+		}
+		break;
+	}
+}
+
+// NOTE: Only the last allocation in the stack's current block can be popped or resized in place
+FILE_SCOPE bool DqnMemAPIInternal_StackIsLastAllocation(const DqnMemStack *const stack,
+                                                        const void *const ptr, const size_t size)
+{
+	if (!stack->block || !ptr) return false;
+
+	const u8 *start = stack->block->memory;
+	const u8 *end   = stack->block->memory + stack->block->used;
+	bool result     = ((const u8 *)ptr >= start && (const u8 *)ptr + DQN_ALIGN_POW_N(size, stack->byteAlign) == end);
+	return result;
+}
+
+FILE_SCOPE void DqnMemAPIInternal_StackAllocatorCallback(DqnMemAPICallbackInfo info,
+                                                         DqnMemAPICallbackResult *result)
+{
+	DqnMemStack *stack = (DqnMemStack *)info.userContext;
+	DQN_ASSERT_HARD(stack);
+
+	DqnMemAPIInternal_ValidateCallbackInfo(info);
+	switch(info.type)
+	{
+		case DqnMemAPICallbackType_Alloc:
+		{
+			result->type      = info.type;
+			result->newMemPtr = DqnMemStack_Push(stack, info.requestSize);
+			if (result->newMemPtr) memset(result->newMemPtr, 0, info.requestSize);
+		}
+		break;
+
+		case DqnMemAPICallbackType_Realloc:
+		{
+			result->type = info.type;
+			if (DqnMemAPIInternal_StackIsLastAllocation(stack, info.oldMemPtr, info.oldSize))
+			{
+				DqnMemStackBlock *block = stack->block;
+				size_t offset           = (size_t)((u8 *)info.oldMemPtr - block->memory);
+				size_t newUsed          = offset + DQN_ALIGN_POW_N(info.newRequestSize, stack->byteAlign);
+				if (newUsed <= block->size && DqnMemStackInternal_Commit(stack, newUsed))
+				{
+					block->used       = newUsed;
+					result->newMemPtr = info.oldMemPtr;
+					break;
+				}
+			}
+
+			// NOTE: The old allocation is left behind until the stack is cleared
+			result->newMemPtr = DqnMemStack_Push(stack, info.newRequestSize);
+			if (result->newMemPtr)
+				memcpy(result->newMemPtr, info.oldMemPtr, DQN_MIN(info.oldSize, info.newRequestSize));
+		}
+		break;
+
+		case DqnMemAPICallbackType_Free:
+		{
+			if (result) result->type = info.type;
+			if (DqnMemAPIInternal_StackIsLastAllocation(stack, info.ptrToFree, info.sizeToFree))
+				DqnMemStack_Pop(stack, info.ptrToFree, info.sizeToFree);
+		}
+		break;
+
+		default:
+		{
+			DQN_ASSERT_HARD(DQN_INVALID_CODE_PATH);
+		}
+		break;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// #DqnMemAPI Implementation
+////////////////////////////////////////////////////////////////////////////////
+DQN_FILE_SCOPE DqnMemAPI DqnMemAPI_DefaultUseCalloc()
+{
+	DqnMemAPI result   = {0};
+	result.callback    = DqnMemAPIInternal_DefaultUseCallocCallback;
+	result.userContext = NULL;
+	return result;
+}
+
+DQN_FILE_SCOPE DqnMemAPI DqnMemAPI_StackAllocator(DqnMemStack *const stack)
+{
+	DqnMemAPI result   = {0};
+	result.callback    = DqnMemAPIInternal_StackAllocatorCallback;
+	result.userContext = stack;
+	return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// #DqnMemPoolInternal Implementation
+////////////////////////////////////////////////////////////////////////////////
+FILE_SCOPE size_t DqnMemPoolInternal_SlabSize(const DqnMemPool *const pool)
+{
+	size_t result = sizeof(DqnMemPoolSlab) + (pool->byteAlign - 1) + (pool->itemSize * pool->itemsPerSlab);
+	return result;
 }
 
-FILE_SCOPE inline DqnMemAPICallbackInfo
-DqnMemAPIInternal_CallbackInfoAskAlloc(const DqnMemAPI memAPI,
-                                       const size_t size)
+FILE_SCOPE DqnMemPoolSlab *DqnMemPoolInternal_AllocateSlab(DqnMemPool *const pool)
 {
-	DqnMemAPICallbackInfo info = {0};
-	info.type        = DqnMemAPICallbackType_Alloc;
-	info.userContext = memAPI.userContext;
-	info.requestSize = size;
-	return info;
+	size_t size                = DqnMemPoolInternal_SlabSize(pool);
+	DqnMemAPICallbackInfo info = DqnMemAPIInternal_CallbackInfoAskAlloc(pool->memAPI, size);
+	DqnMemAPICallbackResult memResult = {0};
+	pool->memAPI.callback(info, &memResult);
+
+	DqnMemPoolSlab *result = (DqnMemPoolSlab *)memResult.newMemPtr;
+	if (!result) return NULL;
+
+	result->prevSlab = pool->slab;
+	result->items    = (u8 *)DQN_ALIGN_POW_N((u8 *)result + sizeof(*result), pool->byteAlign);
+	result->used     = 0;
+	pool->slab       = result;
+	pool->numSlabs++;
+	return result;
 }
 
-FILE_SCOPE DqnMemAPICallbackInfo DqnMemAPIInternal_CallbackInfoAskFree(
-    const DqnMemAPI memAPI, void *const ptrToFree, const size_t sizeToFree)
+FILE_SCOPE void DqnMemPoolInternal_FreeSlab(DqnMemPool *const pool, DqnMemPoolSlab *const slab)
 {
-	DqnMemAPICallbackInfo info = {0};
-	info.type        = DqnMemAPICallbackType_Free;
-	info.userContext = memAPI.userContext;
-	info.ptrToFree   = ptrToFree;
-	info.sizeToFree  = sizeToFree;
-	return info;
+	DqnMemAPICallbackInfo info =
+	    DqnMemAPIInternal_CallbackInfoAskFree(pool->memAPI, slab, DqnMemPoolInternal_SlabSize(pool));
+	pool->memAPI.callback(info, NULL);
+	pool->numSlabs--;
 }
 
-FILE_SCOPE void DqnMemAPIInternal_ValidateCallbackInfo(DqnMemAPICallbackInfo info)
+FILE_SCOPE void DqnMemAPIInternal_PoolAllocatorCallback(DqnMemAPICallbackInfo info,
+                                                        DqnMemAPICallbackResult *result)
 {
-	DQN_ASSERT_HARD(info.type != DqnMemAPICallbackType_Invalid);
+	DqnMemPool *pool = (DqnMemPool *)info.userContext;
+	DQN_ASSERT_HARD(pool);
 
+	DqnMemAPIInternal_ValidateCallbackInfo(info);
 	switch(info.type)
 	{
 		case DqnMemAPICallbackType_Alloc:
 		{
-			DQN_ASSERT_HARD(info.requestSize > 0);
+			result->type      = info.type;
+			result->newMemPtr = (info.requestSize <= pool->itemSize) ? DqnMemPool_Alloc(pool) : NULL;
 		}
 		break;
 
 		case DqnMemAPICallbackType_Realloc:
 		{
-			DQN_ASSERT_HARD(info.oldSize > 0);
-			DQN_ASSERT_HARD(info.requestSize > 0);
-			DQN_ASSERT_HARD(info.oldMemPtr);
+			result->type      = info.type;
+			result->newMemPtr = (info.newRequestSize <= pool->itemSize) ? info.oldMemPtr : NULL;
 		}
 		break;
 
 		case DqnMemAPICallbackType_Free:
 		{
-			// nothing to validate
+			if (result) result->type = info.type;
+			DqnMemPool_FreeItem(pool, info.ptrToFree);
 		}
 		break;
 
@@ -2447,57 +4146,185 @@ FILE_SCOPE void DqnMemAPIInternal_ValidateCallbackInfo(DqnMemAPICallbackInfo inf
 	}
 }
 
-FILE_SCOPE void DqnMemAPIInternal_DefaultUseCallocCallback(DqnMemAPICallbackInfo info,
-                                                           DqnMemAPICallbackResult *result)
+DQN_FILE_SCOPE DqnMemAPI DqnMemAPI_PoolAllocator(DqnMemPool *const pool)
 {
-	DQN_ASSERT_HARD(!info.userContext);
+	DqnMemAPI result   = {0};
+	result.callback    = DqnMemAPIInternal_PoolAllocatorCallback;
+	result.userContext = pool;
+	return result;
+}
 
-	DqnMemAPIInternal_ValidateCallbackInfo(info);
-	switch(info.type)
+////////////////////////////////////////////////////////////////////////////////
+// #DqnMemPool CPP Implementation
+////////////////////////////////////////////////////////////////////////////////
+#if defined(DQN_CPP_MODE)
+bool  DqnMemPool::Init(const size_t itemSize_, const u32 itemsPerSlab_, const DqnMemAPI memAPI_, const u32 byteAlignment)
+{
+	return DqnMemPool_Init(this, itemSize_, itemsPerSlab_, memAPI_, byteAlignment);
+}
+
+void *DqnMemPool::Alloc   (const bool zeroClear) { return DqnMemPool_Alloc   (this, zeroClear); }
+void  DqnMemPool::FreeItem(void *const item)     {        DqnMemPool_FreeItem(this, item);      }
+void  DqnMemPool::Clear   ()                     {        DqnMemPool_Clear   (this);            }
+void  DqnMemPool::Free    ()                     {        DqnMemPool_Free    (this);            }
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// #DqnMemPool Implementation
+////////////////////////////////////////////////////////////////////////////////
+DQN_FILE_SCOPE bool DqnMemPool_Init(DqnMemPool *const pool, const size_t itemSize, const u32 itemsPerSlab,
+                                    const DqnMemAPI memAPI, const u32 byteAlign)
+{
+	if (!pool || itemSize == 0 || itemsPerSlab == 0 || !memAPI.callback) return false;
+	if (byteAlign == 0 || (byteAlign & (byteAlign - 1)) != 0) return false;
+	if (!DQN_ASSERT_MSG(!pool->slab, "MemPool has pre-existing slabs allocated")) return false;
+
+	// NOTE: Free items hold the free list pointer in their first bytes
+	pool->memAPI        = memAPI;
+	pool->slab          = NULL;
+	pool->freeList      = NULL;
+	pool->itemSize      = DQN_ALIGN_POW_N(DQN_MAX(itemSize, sizeof(void *)), byteAlign);
+	pool->itemsPerSlab  = itemsPerSlab;
+	pool->byteAlign     = byteAlign;
+	pool->numSlabs      = 0;
+	pool->numItemsInUse = 0;
+	return true;
+}
+
+DQN_FILE_SCOPE void *DqnMemPool_Alloc(DqnMemPool *const pool, const bool zeroClear)
+{
+	if (!pool) return NULL;
+
+	void *result;
+	if (pool->freeList)
 	{
-		case DqnMemAPICallbackType_Alloc:
+		result         = pool->freeList;
+		pool->freeList = *((void **)result);
+	}
+	else
+	{
+		// NOTE: Slabs are bumped into rather than threaded onto the free list when allocated, so a
+		// new slab's memory isn't touched until it's used
+		if (!pool->slab || pool->slab->used == pool->itemsPerSlab)
 		{
-			result->type = info.type;
-			result->newMemPtr = DqnMem_Calloc(info.requestSize);
+			if (!DqnMemPoolInternal_AllocateSlab(pool)) return NULL;
 		}
-		break;
 
-		case DqnMemAPICallbackType_Realloc:
-		{
-			result->type = info.type;
-			result->newMemPtr =
-			    DqnMem_Realloc(info.oldMemPtr, info.newRequestSize);
-		}
-		break;
+		result = pool->slab->items + (pool->itemSize * pool->slab->used++);
+	}
 
-		case DqnMemAPICallbackType_Free:
-		{
-			// NOTE(doyle): We can pass in NULL as result if we're freeing since
-			// there's nothing to return. But if the callback result has been
-			// passed in, we can fill the type data out.
-			if (result) result->type = info.type;
-			DqnMem_Free(info.ptrToFree);
-		}
-		break;
+	pool->numItemsInUse++;
+	if (zeroClear) DqnMem_Clear(result, 0, pool->itemSize);
+	return result;
+}
 
-		default:
-		{
-			DQN_ASSERT_HARD(DQN_INVALID_CODE_PATH);
-		}
-		break;
+DQN_FILE_SCOPE void DqnMemPool_FreeItem(DqnMemPool *const pool, void *const item)
+{
+	if (!pool || !item) return;
+	DQN_ASSERT(pool->numItemsInUse > 0);
+
+	*((void **)item) = pool->freeList;
+	pool->freeList   = item;
+	pool->numItemsInUse--;
+}
+
+DQN_FILE_SCOPE void DqnMemPool_Clear(DqnMemPool *const pool)
+{
+	if (!pool || !pool->slab) return;
+
+	while (pool->slab->prevSlab)
+	{
+		DqnMemPoolSlab *slabToFree = pool->slab->prevSlab;
+		pool->slab->prevSlab       = slabToFree->prevSlab;
+		DqnMemPoolInternal_FreeSlab(pool, slabToFree);
+	}
+
+	pool->slab->used    = 0;
+	pool->freeList      = NULL;
+	pool->numItemsInUse = 0;
+}
+
+DQN_FILE_SCOPE void DqnMemPool_Free(DqnMemPool *const pool)
+{
+	if (!pool) return;
+
+	while (pool->slab)
+	{
+		DqnMemPoolSlab *slabToFree = pool->slab;
+		pool->slab                 = slabToFree->prevSlab;
+		DqnMemPoolInternal_FreeSlab(pool, slabToFree);
 	}
+
+	pool->freeList      = NULL;
+	pool->numItemsInUse = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// #DqnMemAPI Implementation
+// #DqnScratch Implementation
 ////////////////////////////////////////////////////////////////////////////////
-DQN_FILE_SCOPE DqnMemAPI DqnMemAPI_DefaultUseCalloc()
+FILE_SCOPE DQN_THREAD_LOCAL DqnMemStack dqnScratchInternalArenas[DQN_SCRATCH_NUM_ARENAS];
+
+DQN_FILE_SCOPE DqnMemStack *DqnScratch_Get(const DqnMemStack *const conflict)
 {
-	DqnMemAPI result   = {0};
-	result.callback    = DqnMemAPIInternal_DefaultUseCallocCallback;
-	result.userContext = NULL;
+	for (i32 i = 0; i < DQN_SCRATCH_NUM_ARENAS; i++)
+	{
+		DqnMemStack *arena = &dqnScratchInternalArenas[i];
+		if (arena == conflict) continue;
+
+		// NOTE: Prefer reserved address space, an expandable stack frees the blocks it chained on
+		// at the end of every region that outgrew the first block.
+		if (!arena->block)
+		{
+			if (!DqnMemStack_InitWithVirtualMem(arena, DQN_SCRATCH_RESERVE_SIZE) &&
+			    !DqnMemStack_Init(arena, DQN_SCRATCH_BLOCK_SIZE, false))
+			{
+				return NULL;
+			}
+		}
+
+		return arena;
+	}
+
+	return NULL;
+}
+
+DQN_FILE_SCOPE DqnMemStack *DqnScratch_Begin(DqnMemStackTempRegion *const region, const DqnMemStack *const conflict)
+{
+	if (!region) return NULL;
+
+	DqnMemStack *result = DqnScratch_Get(conflict);
+	if (result) DqnMemStackTempRegion_Begin(region, result);
+	return result;
+}
+
+DQN_FILE_SCOPE void DqnScratch_FreeThreadArenas()
+{
+	for (i32 i = 0; i < DQN_SCRATCH_NUM_ARENAS; i++)
+	{
+		DqnMemStack *arena = &dqnScratchInternalArenas[i];
+		DQN_ASSERT(arena->tempRegionCount == 0);
+		DqnMemStack_Free(arena);
+	}
+}
+
+#ifdef DQN_CPP_MODE
+DqnScratchGuard::DqnScratchGuard(const DqnMemStack *const conflict)
+{
+	this->region = {};
+	this->arena  = DqnScratch_Begin(&this->region, conflict);
+}
+
+DqnScratchGuard::~DqnScratchGuard()
+{
+	if (this->arena) DqnMemStackTempRegion_End(this->region);
+}
+
+void *DqnScratchGuard::Push(const size_t size)
+{
+	void *result = (this->arena) ? DqnMemStack_Push(this->arena, size) : NULL;
 	return result;
 }
+#endif
 
 ////////////////////////////////////////////////////////////////////////////////
 // #DqnMath Implementation
@@ -4040,6 +5867,37 @@ DQN_FILE_SCOPE i32 Dqn_I32ToWstr(i32 value, wchar_t *buf, i32 bufSize)
 	return charIndex;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// #DqnString Implementation
+////////////////////////////////////////////////////////////////////////////////
+#ifdef DQN_CPP_MODE
+FILE_SCOPE char *DqnStringInternal_CountCallback(char *buf, void *user, int len)
+{
+	*((i32 *)user) += len;
+	return buf; // NOTE: Nothing is kept, keep formatting into the same scratch buffer
+}
+
+DQN_FILE_SCOPE bool DqnString_Sprintf(DqnString *const str, const char *const fmt, ...)
+{
+	if (!str || !fmt) return false;
+
+	// NOTE: Measure first so a failed grow leaves the string as it was
+	char scratch[STB_SPRINTF_MIN];
+	i32 len = 0;
+	va_list argList;
+	va_start(argList, fmt);
+	Dqn_vsprintfcb(DqnStringInternal_CountCallback, &len, scratch, fmt, argList);
+	va_end(argList);
+
+	if (!DqnString_Reserve(str, len)) return false;
+
+	va_start(argList, fmt);
+	str->len = Dqn_vsprintf(DqnString_Str(str), fmt, argList);
+	va_end(argList);
+	return true;
+}
+#endif // DQN_CPP_MODE
+
 ////////////////////////////////////////////////////////////////////////////////
 // #DqnRnd Implementation
 ////////////////////////////////////////////////////////////////////////////////
@@ -4066,71 +5924,303 @@ FILE_SCOPE f32 DqnRnd_F32NormalizedFromU32Internal(u32 value)
 	return uf.float32 - 1.0f;
 }
 
-FILE_SCOPE u64 DqnRnd_Murmur3Avalanche64Internal(u64 h)
+FILE_SCOPE u64 DqnRnd_Murmur3Avalanche64Internal(u64 h)
+{
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccd;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53;
+	h ^= h >> 33;
+	return h;
+}
+
+#if defined(DQN_UNIX_PLATFORM)
+	#include <x86intrin.h> // __rdtsc
+#endif
+
+FILE_SCOPE u32 DqnRnd_MakeSeedInternal()
+{
+#if defined(DQN_WIN32_PLATFORM) || defined(DQN_UNIX_PLATFORM)
+	i64 numClockCycles = __rdtsc();
+	return (u32)numClockCycles;
+#elif __ANDROID__
+	DQN_ASSERT_MSG(DQN_INVALID_CODE_PATH, "Android path not implemented yet");
+	return 0;
+#else
+	DQN_ASSERT_MSG(DQN_INVALID_CODE_PATH, "Non Win32 path not implemented yet");
+	return 0;
+#endif
+}
+
+DQN_FILE_SCOPE void DqnRnd_PCGInitWithSeed(DqnRandPCGState *pcg, u32 seed)
+{
+	u64 value     = (((u64)seed) << 1ULL) | 1ULL;
+	value         = DqnRnd_Murmur3Avalanche64Internal(value);
+	pcg->state[0] = 0U;
+	pcg->state[1] = (value << 1ULL) | 1ULL;
+	DqnRnd_PCGNext(pcg);
+	pcg->state[0] += DqnRnd_Murmur3Avalanche64Internal(value);
+	DqnRnd_PCGNext(pcg);
+}
+
+DQN_FILE_SCOPE void DqnRnd_PCGInit(DqnRandPCGState *pcg)
+{
+	u32 seed = DqnRnd_MakeSeedInternal();
+	DqnRnd_PCGInitWithSeed(pcg, seed);
+}
+
+DQN_FILE_SCOPE u32 DqnRnd_PCGNext(DqnRandPCGState *pcg)
+{
+	u64 oldstate   = pcg->state[0];
+	pcg->state[0]  = oldstate * 0x5851f42d4c957f2dULL + pcg->state[1];
+	u32 xorshifted = (u32)(((oldstate >> 18ULL) ^ oldstate) >> 27ULL);
+	u32 rot        = (u32)(oldstate >> 59ULL);
+	return (xorshifted >> rot) | (xorshifted << ((-(i32)rot) & 31));
+}
+
+DQN_FILE_SCOPE f32 DqnRnd_PCGNextf(DqnRandPCGState *pcg)
+{
+	return DqnRnd_F32NormalizedFromU32Internal(DqnRnd_PCGNext(pcg));
+}
+
+DQN_FILE_SCOPE i32 DqnRnd_PCGRange(DqnRandPCGState *pcg, i32 min, i32 max)
+{
+	i32 const range = (max - min) + 1;
+	if (range <= 0) return min;
+	i32 const value = (i32)(DqnRnd_PCGNextf(pcg) * range);
+	return min + value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// #DqnTimerWheel Implementation
+////////////////////////////////////////////////////////////////////////////////
+#define DQN_TIMER_WHEEL_SLOT_MASK  (DQN_TIMER_WHEEL_SLOTS - 1)
+#define DQN_TIMER_WHEEL_RANGE_BITS (DQN_TIMER_WHEEL_SLOT_BITS * DQN_TIMER_WHEEL_LEVELS)
+DQN_COMPILE_ASSERT(DQN_TIMER_WHEEL_SLOTS <= 64); // Occupancy is tracked in a u64 per level
+
+FILE_SCOPE u32 DqnTimerWheel_LowestSetBitInternal(u64 value)
+{
+	DQN_ASSERT(value != 0);
+	u32 result = 0;
+	while ((value & 1) == 0)
+	{
+		value >>= 1;
+		result++;
+	}
+	return result;
+}
+
+// NOTE: Tasks at a level are always in a slot after the current one, the current slot of level 0
+// has been dispatched and the current slot of higher levels has been cascaded.
+FILE_SCOPE bool DqnTimerWheel_NextOccupiedSlotInternal(const DqnTimerWheel *const wheel,
+                                                       const u32 level, u32 *const slotIndex)
+{
+	u32 currSlot = (u32)(wheel->currTick >> (level * DQN_TIMER_WHEEL_SLOT_BITS)) & DQN_TIMER_WHEEL_SLOT_MASK;
+	u64 laterSlotsMask = ~((2ULL << currSlot) - 1);
+	u64 laterSlots     = wheel->occupied[level] & laterSlotsMask;
+	if (!laterSlots) return false;
+
+	*slotIndex = DqnTimerWheel_LowestSetBitInternal(laterSlots);
+	return true;
+}
+
+FILE_SCOPE void DqnTimerWheel_LinkInternal(DqnTimerWheelTask **const list, DqnTimerWheelTask *const task)
+{
+	task->slot = list;
+	task->prev = NULL;
+	task->next = *list;
+	if (*list) (*list)->prev = task;
+	*list = task;
+}
+
+FILE_SCOPE void DqnTimerWheel_UnlinkInternal(DqnTimerWheel *const wheel, DqnTimerWheelTask *const task)
+{
+	if (task->prev) task->prev->next = task->next;
+	else            *task->slot      = task->next;
+	if (task->next) task->next->prev = task->prev;
+
+	if (!(*task->slot) && task->slot != &wheel->overflow)
+	{
+		size_t index  = (size_t)(task->slot - &wheel->slots[0][0]);
+		u32 level     = (u32)(index / DQN_TIMER_WHEEL_SLOTS);
+		u32 slotIndex = (u32)(index % DQN_TIMER_WHEEL_SLOTS);
+		wheel->occupied[level] &= ~(1ULL << slotIndex);
+	}
+
+	task->slot = NULL;
+	task->next = NULL;
+	task->prev = NULL;
+}
+
+// Link task into the lowest level whose range shares the upper bits of its due tick with the
+// current tick.
+FILE_SCOPE void DqnTimerWheel_PlaceInternal(DqnTimerWheel *const wheel, DqnTimerWheelTask *const task)
+{
+	for (u32 level = 0; level < DQN_TIMER_WHEEL_LEVELS; level++)
+	{
+		u32 upperShift = (level + 1) * DQN_TIMER_WHEEL_SLOT_BITS;
+		if ((task->dueTick >> upperShift) != (wheel->currTick >> upperShift)) continue;
+
+		u32 slotIndex = (u32)(task->dueTick >> (level * DQN_TIMER_WHEEL_SLOT_BITS)) & DQN_TIMER_WHEEL_SLOT_MASK;
+		DqnTimerWheel_LinkInternal(&wheel->slots[level][slotIndex], task);
+		wheel->occupied[level] |= (1ULL << slotIndex);
+		return;
+	}
+
+	DqnTimerWheel_LinkInternal(&wheel->overflow, task);
+}
+
+// return: The next tick that has tasks to cascade or dispatch, FALSE if the wheel is empty.
+FILE_SCOPE bool DqnTimerWheel_NextEventTickInternal(const DqnTimerWheel *const wheel, u64 *const tick)
 {
-	h ^= h >> 33;
-	h *= 0xff51afd7ed558ccd;
-	h ^= h >> 33;
-	h *= 0xc4ceb9fe1a85ec53;
-	h ^= h >> 33;
-	return h;
-}
+	bool result = false;
+	for (u32 level = 0; level < DQN_TIMER_WHEEL_LEVELS; level++)
+	{
+		u32 slotIndex;
+		if (!DqnTimerWheel_NextOccupiedSlotInternal(wheel, level, &slotIndex)) continue;
 
-#if defined(DQN_UNIX_PLATFORM)
-	#include <x86intrin.h> // __rdtsc
-#endif
+		u32 shift      = level * DQN_TIMER_WHEEL_SLOT_BITS;
+		u32 upperShift = shift + DQN_TIMER_WHEEL_SLOT_BITS;
+		u64 slotTick   = ((wheel->currTick >> upperShift) << upperShift) | ((u64)slotIndex << shift);
+		if (!result || slotTick < *tick) *tick = slotTick;
+		result = true;
+	}
 
-FILE_SCOPE u32 DqnRnd_MakeSeedInternal()
+	if (wheel->overflow)
+	{
+		u64 rangeTick = ((wheel->currTick >> DQN_TIMER_WHEEL_RANGE_BITS) + 1) << DQN_TIMER_WHEEL_RANGE_BITS;
+		if (!result || rangeTick < *tick) *tick = rangeTick;
+		result = true;
+	}
+
+	return result;
+}
+
+DQN_FILE_SCOPE void DqnTimerWheel_Init(DqnTimerWheel *const wheel, const f64 tickInMs, const f64 nowInMs)
 {
-#if defined(DQN_WIN32_PLATFORM) || defined(DQN_UNIX_PLATFORM)
-	i64 numClockCycles = __rdtsc();
-	return (u32)numClockCycles;
-#elif __ANDROID__
-	DQN_ASSERT_MSG(DQN_INVALID_CODE_PATH, "Android path not implemented yet");
-	return 0;
-#else
-	DQN_ASSERT_MSG(DQN_INVALID_CODE_PATH, "Non Win32 path not implemented yet");
-	return 0;
-#endif
+	if (!wheel) return;
+	DQN_ASSERT(tickInMs > 0);
+
+	*wheel               = {};
+	wheel->startTimeInMs = nowInMs;
+	wheel->tickInMs      = tickInMs;
 }
 
-DQN_FILE_SCOPE void DqnRnd_PCGInitWithSeed(DqnRandPCGState *pcg, u32 seed)
+DQN_FILE_SCOPE void DqnTimerWheel_Schedule(DqnTimerWheel *const wheel, DqnTimerWheelTask *const task,
+                                           const f64 delayInMs)
 {
-	u64 value     = (((u64)seed) << 1ULL) | 1ULL;
-	value         = DqnRnd_Murmur3Avalanche64Internal(value);
-	pcg->state[0] = 0U;
-	pcg->state[1] = (value << 1ULL) | 1ULL;
-	DqnRnd_PCGNext(pcg);
-	pcg->state[0] += DqnRnd_Murmur3Avalanche64Internal(value);
-	DqnRnd_PCGNext(pcg);
+	if (!wheel || !task) return;
+	DqnTimerWheel_Cancel(wheel, task);
+
+	u64 delayInTicks = 1;
+	if (delayInMs > 0)
+	{
+		delayInTicks = (u64)(delayInMs / wheel->tickInMs);
+		if ((f64)delayInTicks * wheel->tickInMs < delayInMs) delayInTicks++;
+		if (delayInTicks == 0) delayInTicks = 1;
+	}
+
+	task->dueTick = wheel->currTick + delayInTicks;
+	DqnTimerWheel_PlaceInternal(wheel, task);
+	wheel->numTasks++;
 }
 
-DQN_FILE_SCOPE void DqnRnd_PCGInit(DqnRandPCGState *pcg)
+DQN_FILE_SCOPE void DqnTimerWheel_Cancel(DqnTimerWheel *const wheel, DqnTimerWheelTask *const task)
 {
-	u32 seed = DqnRnd_MakeSeedInternal();
-	DqnRnd_PCGInitWithSeed(pcg, seed);
+	if (!wheel || !task || !task->slot) return;
+	DqnTimerWheel_UnlinkInternal(wheel, task);
+	wheel->numTasks--;
 }
 
-DQN_FILE_SCOPE u32 DqnRnd_PCGNext(DqnRandPCGState *pcg)
+DQN_FILE_SCOPE bool DqnTimerWheel_IsScheduled(const DqnTimerWheelTask *const task)
 {
-	u64 oldstate   = pcg->state[0];
-	pcg->state[0]  = oldstate * 0x5851f42d4c957f2dULL + pcg->state[1];
-	u32 xorshifted = (u32)(((oldstate >> 18ULL) ^ oldstate) >> 27ULL);
-	u32 rot        = (u32)(oldstate >> 59ULL);
-	return (xorshifted >> rot) | (xorshifted << ((-(i32)rot) & 31));
+	bool result = (task && task->slot);
+	return result;
 }
 
-DQN_FILE_SCOPE f32 DqnRnd_PCGNextf(DqnRandPCGState *pcg)
+DQN_FILE_SCOPE u32 DqnTimerWheel_Advance(DqnTimerWheel *const wheel, const f64 nowInMs)
 {
-	return DqnRnd_F32NormalizedFromU32Internal(DqnRnd_PCGNext(pcg));
+	if (!wheel || nowInMs < wheel->startTimeInMs) return 0;
+
+	u64 targetTick = (u64)((nowInMs - wheel->startTimeInMs) / wheel->tickInMs);
+	u32 result     = 0;
+
+	// NOTE: Jump straight between ticks that have work, empty slots are never visited
+	u64 tick = 0;
+	while (DqnTimerWheel_NextEventTickInternal(wheel, &tick) && tick <= targetTick)
+	{
+		wheel->currTick = tick;
+
+		// NOTE: Cascade from the top down so tasks reach their final level before dispatch
+		if ((tick & ((1ULL << DQN_TIMER_WHEEL_RANGE_BITS) - 1)) == 0 && wheel->overflow)
+		{
+			DqnTimerWheelTask *list = wheel->overflow;
+			wheel->overflow         = NULL;
+			while (list)
+			{
+				DqnTimerWheelTask *next = list->next;
+				DqnTimerWheel_PlaceInternal(wheel, list);
+				list = next;
+			}
+		}
+
+		for (u32 level = DQN_TIMER_WHEEL_LEVELS - 1; level > 0; level--)
+		{
+			u32 shift = level * DQN_TIMER_WHEEL_SLOT_BITS;
+			if ((tick & ((1ULL << shift) - 1)) != 0) continue;
+
+			u32 slotIndex                  = (u32)(tick >> shift) & DQN_TIMER_WHEEL_SLOT_MASK;
+			DqnTimerWheelTask *list        = wheel->slots[level][slotIndex];
+			wheel->slots[level][slotIndex] = NULL;
+			wheel->occupied[level] &= ~(1ULL << slotIndex);
+			while (list)
+			{
+				DqnTimerWheelTask *next = list->next;
+				DqnTimerWheel_PlaceInternal(wheel, list);
+				list = next;
+			}
+		}
+
+		// NOTE: Rescheduled periodic tasks are due at least a tick later so can't land in this slot
+		u32 slotIndex = (u32)tick & DQN_TIMER_WHEEL_SLOT_MASK;
+		while (wheel->slots[0][slotIndex])
+		{
+			DqnTimerWheelTask *task = wheel->slots[0][slotIndex];
+			DQN_ASSERT(task->dueTick == tick);
+			DqnTimerWheel_Cancel(wheel, task);
+
+			if (task->periodInMs > 0) DqnTimerWheel_Schedule(wheel, task, task->periodInMs);
+			if (task->callback)       task->callback(task, nowInMs);
+			result++;
+		}
+	}
+
+	if (targetTick > wheel->currTick) wheel->currTick = targetTick;
+	return result;
 }
 
-DQN_FILE_SCOPE i32 DqnRnd_PCGRange(DqnRandPCGState *pcg, i32 min, i32 max)
+DQN_FILE_SCOPE f64 DqnTimerWheel_MsUntilNextDue(const DqnTimerWheel *const wheel, const f64 nowInMs)
 {
-	i32 const range = (max - min) + 1;
-	if (range <= 0) return min;
-	i32 const value = (i32)(DqnRnd_PCGNextf(pcg) * range);
-	return min + value;
+	if (!wheel || wheel->numTasks == 0) return DQN_TIMER_WHEEL_NO_TASKS;
+
+	// NOTE: Slots of a level are ordered by due tick, so the earliest task is in the first occupied
+	// slot of some level, or in the overflow.
+	u64 nextDueTick = (u64)-1;
+	for (u32 level = 0; level < DQN_TIMER_WHEEL_LEVELS; level++)
+	{
+		u32 slotIndex;
+		if (!DqnTimerWheel_NextOccupiedSlotInternal(wheel, level, &slotIndex)) continue;
+
+		for (DqnTimerWheelTask *task = wheel->slots[level][slotIndex]; task; task = task->next)
+			nextDueTick = DQN_MIN(nextDueTick, task->dueTick);
+	}
+
+	for (DqnTimerWheelTask *task = wheel->overflow; task; task = task->next)
+		nextDueTick = DQN_MIN(nextDueTick, task->dueTick);
+
+	f64 dueTimeInMs = wheel->startTimeInMs + ((f64)nextDueTick * wheel->tickInMs);
+	f64 result      = DQN_MAX(dueTimeInMs - nowInMs, 0);
+	return result;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -6600,7 +8690,7 @@ DQN_FILE_SCOPE f64 DqnTimer_NowInMs()
 	}
 	else
 	{
-		result = (f64)((timeSpec.tv_sec * 1000.0f) + (timeSpec.tv_nsec / 1000000.0f));
+		result = ((f64)timeSpec.tv_sec * 1000.0) + ((f64)timeSpec.tv_nsec / 1000000.0);
 	}
 
 #else
@@ -6610,7 +8700,7 @@ DQN_FILE_SCOPE f64 DqnTimer_NowInMs()
 	return result;
 };
 
-DQN_FILE_SCOPE f64 DqnTimer_NowInS() { return DqnTimer_NowInMs() / 1000.0f; }
+DQN_FILE_SCOPE f64 DqnTimer_NowInS() { return DqnTimer_NowInMs() / 1000.0; }
 
 ////////////////////////////////////////////////////////////////////////////////
 // XPlatform > #DqnLock Implementation
@@ -6726,6 +8816,194 @@ DqnLockGuard::~DqnLockGuard()
 	if (this->lock) this->lock->Release();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// XPlatform > #DqnMemPoolThreadCache Implementation
+////////////////////////////////////////////////////////////////////////////////
+DQN_FILE_SCOPE void DqnMemPoolThreadCache_Init(DqnMemPoolThreadCache *const cache, DqnMemPool *const pool,
+                                               DqnLock *const lock)
+{
+	if (!cache) return;
+	cache->pool     = pool;
+	cache->lock     = lock;
+	cache->freeList = NULL;
+	cache->numFree  = 0;
+}
+
+DQN_FILE_SCOPE void *DqnMemPoolThreadCache_Alloc(DqnMemPoolThreadCache *const cache, const bool zeroClear)
+{
+	if (!cache) return NULL;
+
+	// NOTE: Refill a batch at a time, the pool counts them in use from here on
+	if (!cache->freeList)
+	{
+		DqnLock_Acquire(cache->lock);
+		for (u32 i = 0; i < DQN_MEM_POOL_THREAD_CACHE_BATCH; i++)
+		{
+			void *item = DqnMemPool_Alloc(cache->pool, false);
+			if (!item) break;
+
+			*((void **)item) = cache->freeList;
+			cache->freeList  = item;
+			cache->numFree++;
+		}
+		DqnLock_Release(cache->lock);
+
+		if (!cache->freeList) return NULL;
+	}
+
+	void *result    = cache->freeList;
+	cache->freeList = *((void **)result);
+	cache->numFree--;
+
+	if (zeroClear) DqnMem_Clear(result, 0, cache->pool->itemSize);
+	return result;
+}
+
+FILE_SCOPE void DqnMemPoolThreadCacheInternal_GiveBack(DqnMemPoolThreadCache *const cache, u32 numItems)
+{
+	DqnLock_Acquire(cache->lock);
+	for (; numItems > 0 && cache->freeList; numItems--)
+	{
+		void *item      = cache->freeList;
+		cache->freeList = *((void **)item);
+		cache->numFree--;
+		DqnMemPool_FreeItem(cache->pool, item);
+	}
+	DqnLock_Release(cache->lock);
+}
+
+DQN_FILE_SCOPE void DqnMemPoolThreadCache_FreeItem(DqnMemPoolThreadCache *const cache, void *const item)
+{
+	if (!cache || !item) return;
+
+	*((void **)item) = cache->freeList;
+	cache->freeList  = item;
+	cache->numFree++;
+
+	// NOTE: Keep a batch cached so a thread alternating alloc and free doesn't hit the lock each time
+	if (cache->numFree >= DQN_MEM_POOL_THREAD_CACHE_BATCH * 2)
+		DqnMemPoolThreadCacheInternal_GiveBack(cache, DQN_MEM_POOL_THREAD_CACHE_BATCH);
+}
+
+DQN_FILE_SCOPE void DqnMemPoolThreadCache_Flush(DqnMemPoolThreadCache *const cache)
+{
+	if (!cache || !cache->freeList) return;
+	DqnMemPoolThreadCacheInternal_GiveBack(cache, cache->numFree);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// XPlatform > #DqnMemStackConcurrent CPP Implementation
+////////////////////////////////////////////////////////////////////////////////
+#if defined(DQN_CPP_MODE)
+bool  DqnMemStackConcurrent::Init (const size_t size, const u32 byteAlignment) { return DqnMemStackConcurrent_Init (this, size, byteAlignment); }
+void *DqnMemStackConcurrent::Push (const size_t size)                          { return DqnMemStackConcurrent_Push (this, size);                }
+void  DqnMemStackConcurrent::Clear()                                           {        DqnMemStackConcurrent_Clear(this);                      }
+void  DqnMemStackConcurrent::Free ()                                           {        DqnMemStackConcurrent_Free (this);                      }
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// XPlatform > #DqnMemStackConcurrent Implementation
+////////////////////////////////////////////////////////////////////////////////
+FILE_SCOPE DqnMemStackConcurrentBlock *DqnMemStackConcurrentInternal_AllocateBlock(const size_t size,
+                                                                                   const u32 byteAlign)
+{
+	// NOTE: The header and memory share an allocation, leave room to align the memory after the header
+	DqnMemStackConcurrentBlock *result =
+	    (DqnMemStackConcurrentBlock *)DqnMem_Alloc(sizeof(DqnMemStackConcurrentBlock) + byteAlign + size);
+	if (!result) return NULL;
+
+	result->memory    = (u8 *)DQN_ALIGN_POW_N((u8 *)result + sizeof(DqnMemStackConcurrentBlock), byteAlign);
+	result->size      = size;
+	result->used      = 0;
+	result->prevBlock = NULL;
+	return result;
+}
+
+DQN_FILE_SCOPE bool DqnMemStackConcurrent_Init(DqnMemStackConcurrent *const stack, const size_t size,
+                                               const u32 byteAlign)
+{
+	if (!stack || size == 0 || byteAlign == 0 || (byteAlign & (byteAlign - 1)) != 0) return false;
+	if (!DQN_ASSERT_MSG(!stack->block, "MemStackConcurrent has pre-existing block already attached"))
+		return false;
+
+	DqnMemStackConcurrentBlock *block = DqnMemStackConcurrentInternal_AllocateBlock(size, byteAlign);
+	if (!block) return false;
+
+	stack->block     = block;
+	stack->byteAlign = byteAlign;
+	stack->numBlocks = 1;
+	return true;
+}
+
+DQN_FILE_SCOPE void *DqnMemStackConcurrent_Push(DqnMemStackConcurrent *const stack, const size_t size)
+{
+	if (!stack || !stack->block || size == 0) return NULL;
+
+	size_t alignedSize = DQN_ALIGN_POW_N(size, stack->byteAlign);
+	for (;;)
+	{
+		// NOTE: Once the cursor is past the end every later add fails too, so no push can land in a
+		// block after a push that didn't fit in it. A thread holding an older block can still land
+		// in its tail, which is fine as the add hands that space to it alone.
+		DqnMemStackConcurrentBlock *block = stack->block;
+		i64 end = DqnAtomic_Add64(&block->used, (i64)alignedSize);
+		if (end <= (i64)block->size) return block->memory + (end - (i64)alignedSize);
+
+		f32 growthFactor    = (stack->blockGrowthFactor == 0) ? DQN_MEM_STACK_BLOCK_GROWTH_FACTOR : stack->blockGrowthFactor;
+		size_t maxBlockSize = (stack->maxBlockSize == 0) ? (size_t)DQN_MEM_STACK_MAX_BLOCK_SIZE : stack->maxBlockSize;
+		size_t grownSize    = (size_t)(block->size * growthFactor);
+		size_t newBlockSize = DQN_MAX(alignedSize, DQN_MIN(grownSize, maxBlockSize));
+
+		// NOTE: The new block already holds this push. The compare swap is a full barrier so the
+		// block is filled in before other threads can see it. If another thread chained its block on
+		// first, throw ours away and push onto theirs.
+		DqnMemStackConcurrentBlock *newBlock = DqnMemStackConcurrentInternal_AllocateBlock(newBlockSize, stack->byteAlign);
+		if (!newBlock) return NULL;
+		newBlock->used      = (i64)alignedSize;
+		newBlock->prevBlock = block;
+
+		if (DqnAtomic_CompareSwapPtr((void *volatile *)&stack->block, newBlock, block) == block)
+		{
+			DqnAtomic_Add32(&stack->numBlocks, 1);
+			return newBlock->memory;
+		}
+		DqnMem_Free(newBlock);
+	}
+}
+
+DQN_FILE_SCOPE void DqnMemStackConcurrent_Clear(DqnMemStackConcurrent *const stack)
+{
+	if (!stack || !stack->block) return;
+
+	DqnMemStackConcurrentBlock *block = stack->block->prevBlock;
+	while (block)
+	{
+		DqnMemStackConcurrentBlock *prevBlock = block->prevBlock;
+		DqnMem_Free(block);
+		block = prevBlock;
+	}
+
+	stack->block->prevBlock = NULL;
+	stack->block->used      = 0;
+	stack->numBlocks        = 1;
+}
+
+DQN_FILE_SCOPE void DqnMemStackConcurrent_Free(DqnMemStackConcurrent *const stack)
+{
+	if (!stack) return;
+
+	DqnMemStackConcurrentBlock *block = stack->block;
+	while (block)
+	{
+		DqnMemStackConcurrentBlock *prevBlock = block->prevBlock;
+		DqnMem_Free(block);
+		block = prevBlock;
+	}
+
+	stack->block     = NULL;
+	stack->numBlocks = 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // XPlatform > #DqnJobQueueInternal Implementation
 ////////////////////////////////////////////////////////////////////////////////
@@ -6935,12 +9213,163 @@ void DqnJobQueue::BlockAndCompleteAllJobs()           {        DqnJobQueue_Block
 bool DqnJobQueue::TryExecuteNextJob()                 { return DqnJobQueue_TryExecuteNextJob(this);       }
 bool DqnJobQueue::AllJobsComplete  ()                 { return DqnJobQueue_AllJobsComplete(this);         }
 
+////////////////////////////////////////////////////////////////////////////////
+// XPlatform > #DqnJobGraph Implementation
+////////////////////////////////////////////////////////////////////////////////
+#define DQN_JOB_GRAPH_INTERNAL_READY_LIST_EMPTY -1
+
+// NOTE: Every node becomes ready exactly once per run, so the ready list needs one slot per node. It
+// is stored in the nodes array, slot i being nodes[i].readyListEntry. Worker threads reserve a slot
+// with an atomic add then write the node index, the main thread is the only reader and waits for
+// a reserved slot to be written.
+FILE_SCOPE void DqnJobGraphInternal_PushReady(DqnJobGraph *const graph, const u32 nodeIndex)
+{
+	i32 slot = DqnAtomic_Add32(&graph->readyListWriteIndex, 1) - 1;
+	DQN_ASSERT((u32)slot < graph->numNodes);
+	DqnAtomic_CompareSwap32(&graph->nodes[slot].readyListEntry, (i32)nodeIndex,
+	                        DQN_JOB_GRAPH_INTERNAL_READY_LIST_EMPTY);
+}
+
+FILE_SCOPE void DqnJobGraphInternal_ExecuteNode(DqnJobQueue *const queue, void *const userData)
+{
+	DqnJobGraphNode *node = (DqnJobGraphNode *)userData;
+	DqnJobGraph *graph    = node->graph;
+	if (node->callback) node->callback(queue, node->userData);
+
+	for (u32 edgeIndex = node->firstDependentEdge; edgeIndex != DQN_JOB_GRAPH_INVALID_NODE;
+	     edgeIndex     = graph->edges[edgeIndex].next)
+	{
+		u32 dependent = graph->edges[edgeIndex].dependent;
+		if (DqnAtomic_Add32(&graph->nodes[dependent].numPendingDependencies, -1) == 0)
+			DqnJobGraphInternal_PushReady(graph, dependent);
+	}
+
+	DqnAtomic_Add32(&graph->numNodesRemaining, -1);
+}
+
+DQN_FILE_SCOPE bool DqnJobGraph_Init(DqnJobGraph *const graph, DqnJobQueue *const queue,
+                                     DqnJobGraphNode *const nodes, const u32 maxNodes,
+                                     DqnJobGraphEdge *const edges, const u32 maxEdges)
+{
+	if (!graph || !queue || !nodes || maxNodes == 0 || (!edges && maxEdges > 0)) return false;
+
+	graph->queue    = queue;
+	graph->nodes    = nodes;
+	graph->edges    = edges;
+	graph->maxNodes = maxNodes;
+	graph->maxEdges = maxEdges;
+	graph->numNodes = 0;
+	graph->numEdges = 0;
+	return true;
+}
+
+DQN_FILE_SCOPE u32 DqnJobGraph_AddNode(DqnJobGraph *const graph, DqnJob_Callback *const callback,
+                                       void *const userData)
+{
+	if (!graph || graph->numNodes >= graph->maxNodes) return DQN_JOB_GRAPH_INVALID_NODE;
+
+	u32 result            = graph->numNodes++;
+	DqnJobGraphNode *node = &graph->nodes[result];
+	node->callback           = callback;
+	node->userData           = userData;
+	node->graph              = graph;
+	node->firstDependentEdge = DQN_JOB_GRAPH_INVALID_NODE;
+	node->numDependencies    = 0;
+	return result;
+}
+
+DQN_FILE_SCOPE bool DqnJobGraph_AddDependency(DqnJobGraph *const graph, const u32 node,
+                                              const u32 dependsOn)
+{
+	if (!graph || graph->numEdges >= graph->maxEdges) return false;
+	if (node >= graph->numNodes || dependsOn >= graph->numNodes) return false;
+
+	u32 edgeIndex         = graph->numEdges++;
+	DqnJobGraphEdge *edge = &graph->edges[edgeIndex];
+	edge->dependent       = node;
+	edge->next            = graph->nodes[dependsOn].firstDependentEdge;
+
+	graph->nodes[dependsOn].firstDependentEdge = edgeIndex;
+	graph->nodes[node].numDependencies++;
+	return true;
+}
+
+DQN_FILE_SCOPE bool DqnJobGraph_Run(DqnJobGraph *const graph)
+{
+	if (!graph) return false;
+	if (graph->numNodes == 0) return true;
+
+	graph->readyListWriteIndex = 0;
+	graph->readyListReadIndex  = 0;
+	graph->numNodesRemaining   = (i32)graph->numNodes;
+	for (u32 i = 0; i < graph->numNodes; i++)
+	{
+		DqnJobGraphNode *node        = &graph->nodes[i];
+		node->numPendingDependencies = (i32)node->numDependencies;
+		node->readyListEntry         = DQN_JOB_GRAPH_INTERNAL_READY_LIST_EMPTY;
+	}
+
+	// NOTE: Workers may start pushing as soon as the first root is queued, so gather the roots
+	// through the ready list as well.
+	for (u32 i = 0; i < graph->numNodes; i++)
+	{
+		if (graph->nodes[i].numDependencies == 0) DqnJobGraphInternal_PushReady(graph, i);
+	}
+
+	while (graph->numNodesRemaining > 0)
+	{
+		bool madeProgress = false;
+		while (graph->readyListReadIndex < graph->readyListWriteIndex)
+		{
+			// NOTE: A slot can be reserved but not yet written, wait for the writer to finish
+			DqnJobGraphNode *entry = &graph->nodes[graph->readyListReadIndex];
+			if (entry->readyListEntry == DQN_JOB_GRAPH_INTERNAL_READY_LIST_EMPTY) break;
+
+			DqnJobGraphNode *node = &graph->nodes[entry->readyListEntry];
+			DqnJob job            = {};
+			job.callback          = DqnJobGraphInternal_ExecuteNode;
+			job.userData          = node;
+
+			// NOTE: If the queue is full, run the job on this thread instead
+			if (!DqnJobQueue_AddJob(graph->queue, job)) job.callback(graph->queue, job.userData);
+
+			graph->readyListReadIndex++;
+			madeProgress = true;
+		}
+
+		if (DqnJobQueue_TryExecuteNextJob(graph->queue)) continue;
+		if (madeProgress) continue;
+
+		// NOTE: Nothing ready, nothing queued and nothing running means the rest are in a cycle
+		if (DqnJobQueue_AllJobsComplete(graph->queue) &&
+		    graph->readyListReadIndex == graph->readyListWriteIndex &&
+		    graph->numNodesRemaining > 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool DqnJobGraph::Init(DqnJobQueue *const queue_, DqnJobGraphNode *const nodes_, const u32 maxNodes_,
+                       DqnJobGraphEdge *const edges_, const u32 maxEdges_)
+{
+	bool result = DqnJobGraph_Init(this, queue_, nodes_, maxNodes_, edges_, maxEdges_);
+	return result;
+}
+
+u32  DqnJobGraph::AddNode      (DqnJob_Callback *const callback, void *const userData) { return DqnJobGraph_AddNode(this, callback, userData);        }
+bool DqnJobGraph::AddDependency(const u32 node, const u32 dependsOn)                   { return DqnJobGraph_AddDependency(this, node, dependsOn);    }
+bool DqnJobGraph::Run          ()                                                      { return DqnJobGraph_Run(this);                               }
+
 ////////////////////////////////////////////////////////////////////////////////
 // XPlatform > #DqnAtomic Implementation
 ////////////////////////////////////////////////////////////////////////////////
 
 #if defined(DQN_WIN32_PLATFORM)
-	DQN_COMPILE_ASSERT(sizeof(LONG) == sizeof(i32));
+	DQN_COMPILE_ASSERT(sizeof(LONG)   == sizeof(i32));
+	DQN_COMPILE_ASSERT(sizeof(LONG64) == sizeof(i64));
 #endif
 
 DQN_FILE_SCOPE i32 DqnAtomic_CompareSwap32(i32 volatile *const dest, const i32 swapVal,
@@ -6977,6 +9406,40 @@ DQN_FILE_SCOPE i32 DqnAtomic_Add32(i32 volatile *const src, const i32 value)
 	return result;
 }
 
+DQN_FILE_SCOPE i64 DqnAtomic_Add64(i64 volatile *const src, const i64 value)
+{
+	i64 result = 0;
+#if defined(DQN_WIN32_PLATFORM)
+	result = (i64)InterlockedAdd64((LONG64 volatile *)src, value);
+
+#elif defined(DQN_UNIX_PLATFORM)
+	result = __sync_add_and_fetch(src, value);
+
+#else
+	#error Unsupported platform
+
+#endif
+
+	return result;
+}
+
+DQN_FILE_SCOPE void *DqnAtomic_CompareSwapPtr(void *volatile *const dest, void *const swapVal,
+                                              void *const compareVal)
+{
+	void *result = NULL;
+#if defined(DQN_WIN32_PLATFORM)
+	result = InterlockedCompareExchangePointer(dest, swapVal, compareVal);
+
+#elif defined(DQN_UNIX_PLATFORM)
+	result = __sync_val_compare_and_swap(dest, compareVal, swapVal);
+
+#else
+	#error Unsupported platform
+
+#endif
+	return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // XPlatform > #DqnPlatformInternal Implementation
 ////////////////////////////////////////////////////////////////////////////////
@@ -8,6 +8,7 @@
 #include <stdio.h>
 
 #include "Config.h"
+#include "Profiler.h"
 #include "Wchar.h"
 
 #define DQN_PLATFORM_HEADER
@@ -21,7 +22,8 @@
 
 
 #define WIN32_UI_MARGIN 5
-#define WIN32_MAX_PROGRAM_TITLE DQN_ARRAY_COUNT(((Win32Program *)0)->title)
+#define WIN32_MAX_PROGRAM_TITLE DQN_ARRAY_COUNT(((WinjumpProgram *)0)->title)
+#define WINJUMP_TRACE_PATH "winjump_session.wjtrace" // Written on exit with -record-trace
 FILE_SCOPE WinjumpState globalState;
 FILE_SCOPE bool         globalRunning;
 FILE_SCOPE bool         globalWindowIsInactive;
@@ -35,36 +37,41 @@ FILE_SCOPE void Win32DisplayWindow(HWND window)
 	SetForegroundWindow(window);
 }
 
-// Create the friendly name for representation in the list box
-// - out: The output buffer
-// - outLen: Length of the output buffer
-// Returns the number of characters stored into the buffer
-#define FRIENDLY_NAME_LEN 512
-FILE_SCOPE i32 Winjump_GetProgramFriendlyName(const Win32Program *program,
-                                              wchar_t *out, i32 outLen)
+// Get the file name of the process's exe, i.e. "firefox.exe". Thread safe.
+// return: The length of the name written to exe, 0 if the process could not be queried.
+FILE_SCOPE i32 Win32ResolveProcessExe(const DWORD pid, wchar_t *const exe, const i32 exeSize)
 {
+	i32 result    = 0;
+	HANDLE handle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+	if (handle != nullptr)
+	{
+		DWORD len = exeSize;
+		if (QueryFullProcessImageNameW(handle, 0, exe, &len))
+		{
+			// Len is input as the initial size of array, it then gets modified
+			// and returns the number of characters in the result. If len is
+			// then the len of the array, there's potential that the path name
+			// got clipped.
+			DQN_ASSERT(len != (DWORD)exeSize);
+
+			PathStripPathW(exe);
+			result = DqnWStr_Len(exe);
+		}
+		CloseHandle(handle);
+	}
 
-	// Friendly Name Format
-	// <Index>: <Program Title> - <Program Exe>
-
-	// For example
-	// 1: Google Search - firefox.exe
-	// 2: Winjump.cpp + (C:\winjump.cpp) - GVIM64 - firefox.exe
-	i32 numStored = _snwprintf_s(out, outLen, outLen, L"%2d: %s - %s",
-	                             program->lastStableIndex + 1, program->title,
-	                             program->exe);
-	DQN_ASSERT(numStored < FRIENDLY_NAME_LEN);
-
-	return numStored;
+	if (result == 0) exe[0] = 0;
+	return result;
 }
 
 BOOL CALLBACK Win32EnumWindowsCallback(HWND window, LPARAM lParam)
 {
-	DqnArray<Win32Program> *programArray = &globalState.programArray;
-	Win32Program program = {};
-	i32 titleLen =
-	    GetWindowTextW(window, program.title, WIN32_MAX_PROGRAM_TITLE);
-	program.titleLen = titleLen;
+	WinjumpCore *core = (WinjumpCore *)lParam;
+	DqnScratchGuard scratch;
+	wchar_t *title = (wchar_t *)scratch.Push(WIN32_MAX_PROGRAM_TITLE * sizeof(wchar_t));
+	if (!title) return false;
+
+	i32 titleLen = GetWindowTextW(window, title, WIN32_MAX_PROGRAM_TITLE);
 
 	// If we receive an empty string as a window title, then we want to
 	// ignore it. So if the string is defined, then we increment index
@@ -85,31 +92,10 @@ BOOL CALLBACK Win32EnumWindowsCallback(HWND window, LPARAM lParam)
 			lastPopup = GetLastActivePopup(rootWindow);
 			if (IsWindowVisible(lastPopup) && lastPopup == window)
 			{
-				GetWindowThreadProcessId(window, &program.pid);
-
-				program.window = window;
-				HANDLE handle  = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION,
-				                            FALSE, program.pid);
-				if (handle != nullptr)
-				{
-					DWORD len   = DQN_ARRAY_COUNT(program.exe);
-					BOOL result = QueryFullProcessImageNameW(handle, 0,
-					                                         program.exe, &len);
-					DQN_ASSERT(result != 0);
-
-					// Len is input as the initial size of array, it then
-					// gets modified and returns the number of characters in
-					// the result. If len is then the len of the array,
-					// there's potential that the path name got clipped.
-					DQN_ASSERT(len != DQN_ARRAY_COUNT(program.exe));
-
-					PathStripPathW(program.exe);
-					program.exeLen = DqnWStr_Len(program.exe);
-					CloseHandle(handle);
-				}
-
-				Win32Program *result = DqnArray_Push(programArray, program);
-				if (result) result->lastStableIndex = (i32)programArray->count - 1;
+				// NOTE: Stop enumerating if out of memory, the list just comes up short
+				DWORD pid = 0;
+				GetWindowThreadProcessId(window, &pid);
+				if (!WinjumpCore_PushWindow(core, window, pid, title, titleLen)) return false;
 				break;
 			}
 
@@ -235,14 +221,14 @@ FILE_SCOPE LRESULT CALLBACK Win32EditBoxCallback(HWND window, UINT msg, WPARAM w
 			{
 				case VK_RETURN:
 				{
-					DqnArray<Win32Program> *programArray =
-					    &globalState.programArray;
+					DqnArray<WinjumpProgram> *programArray =
+					    &globalState.core.programArray;
 
-					if (programArray->count > 0)
+					if (WinjumpCore_NumProgramsToDisplay(&globalState.core) > 0)
 					{
-						Win32Program programToShow = programArray->data[0];
+						WinjumpProgram programToShow = programArray->data[0];
 
-						Win32DisplayWindow(programToShow.window);
+						Win32DisplayWindow((HWND)programToShow.window);
 						SetWindowText(window, "");
 						ShowWindow(globalState.window[WinjumpWindow_MainClient]
 						               .handle,
@@ -251,6 +237,19 @@ FILE_SCOPE LRESULT CALLBACK Win32EditBoxCallback(HWND window, UINT msg, WPARAM w
 				}
 				break;
 
+#if WINJUMP_PROFILER
+				case VK_F12:
+				{
+					// Dump the profiler ring for chrome://tracing or Perfetto
+					if (msg == WM_KEYDOWN && !Profiler_WriteChromeTrace("winjump_trace.json"))
+					{
+						DqnWin32_OutputDebugString(
+						    "Profiler_WriteChromeTrace() failed: Could not write winjump_trace.json");
+					}
+				}
+				break;
+#endif
+
 				default:
 				{
 					return CallWindowProcW(win32Window->defaultProc, window,
@@ -421,23 +420,33 @@ bool Winjump_HotkeyIsValid(AppHotkey hotkey) {
 	return false;
 }
 
-// Returns the len of the buffer used
-u32 Winjump_HotkeyToString(AppHotkey hotkey, char *const buf, u32 bufSize)
+bool Winjump_HotkeyToString(AppHotkey hotkey, DqnString *const str)
 {
-	if (!buf) return 0;
+	if (!str) return false;
 
-	char *stringPtr = buf;
+	const char *modifier = "";
+	if      (hotkey.win32ModifierKey == MOD_ALT)     modifier = "Alt-";
+	else if (hotkey.win32ModifierKey == MOD_CONTROL) modifier = "Ctrl-";
+	else if (hotkey.win32ModifierKey == MOD_SHIFT)   modifier = "Shift-";
 
-	if      (hotkey.win32ModifierKey == MOD_ALT)     stringPtr += Dqn_sprintf(stringPtr, "%s", "Alt-");
-	else if (hotkey.win32ModifierKey == MOD_CONTROL) stringPtr += Dqn_sprintf(stringPtr, "%s", "Ctrl-");
-	else if (hotkey.win32ModifierKey == MOD_SHIFT)   stringPtr += Dqn_sprintf(stringPtr, "%s", "Shift-");
+	bool result = DqnString_Set(str, modifier) && DqnString_Append(str, &hotkey.win32VirtualKey, 1);
+	DQN_ASSERT(result && str->len <= DQN_STRING_INLINE_LEN(char));
+	return result;
+}
 
-	Dqn_sprintf(stringPtr, "%c", hotkey.win32VirtualKey);
+void Winjump_SetActivateTitle(HWND window, AppHotkey hotkey)
+{
+	DqnString hotkeyString = {};
+	Winjump_HotkeyToString(hotkey, &hotkeyString);
 
-	u32 len = (u32)((stringPtr - buf) + 1);
-	DQN_ASSERT(len < bufSize);
+	// NOTE: Too long to be stored inline, format it in the scratch arena instead of the heap
+	DqnScratchGuard scratch;
+	if (!scratch.arena) return;
 
-	return len;
+	DqnString title = {};
+	DqnString_Init(&title, DqnMemAPI_StackAllocator(scratch.arena));
+	if (DqnString_Sprintf(&title, "Winjump | Press %s to activate Winjump", hotkeyString.Str()))
+		SetWindowText(window, title.Str());
 }
 
 FILE_SCOPE LRESULT CALLBACK Win32_HotkeyWinjumpActivateCallback(HWND window, UINT msg,
@@ -516,8 +525,8 @@ FILE_SCOPE LRESULT CALLBACK Win32_HotkeyWinjumpActivateCallback(HWND window, UIN
 			///////////////////////////////////////////////////////////////////
 			// Draw Hotkey + Caret
 			///////////////////////////////////////////////////////////////////
-			char hotkeyString[32] = {};
-			Winjump_HotkeyToString(*currHotkey, hotkeyString, DQN_ARRAY_COUNT(hotkeyString));
+			DqnString hotkeyString = {};
+			Winjump_HotkeyToString(*currHotkey, &hotkeyString);
 
 			RECT rect;
 			GetClientRect(window, &rect);
@@ -526,11 +535,11 @@ FILE_SCOPE LRESULT CALLBACK Win32_HotkeyWinjumpActivateCallback(HWND window, UIN
 			HDC deviceContext = GetDC(window);
 
 			LONG stringWidth, stringHeight;
-			Win32FontCalculateDim(deviceContext, globalState.font, hotkeyString, &stringWidth, &stringHeight);
+			Win32FontCalculateDim(deviceContext, globalState.font, hotkeyString.Str(), &stringWidth, &stringHeight);
 			rect.right = rect.left + stringWidth;
 
 			SelectObject(deviceContext, globalState.font);
-			DrawText(deviceContext, hotkeyString, -1, &rect, DT_VCENTER | DT_SINGLELINE);
+			DrawText(deviceContext, hotkeyString.Str(), hotkeyString.len, &rect, DT_VCENTER | DT_SINGLELINE);
 
 			const i32 NUDGE_X = 1;
 			SetCaretPos(rect.right + NUDGE_X, rect.bottom - stringHeight - (i32)(0.25f * stringHeight));
@@ -544,10 +553,7 @@ FILE_SCOPE LRESULT CALLBACK Win32_HotkeyWinjumpActivateCallback(HWND window, UIN
 				HWND textValidHotkey = globalState.window[WinjumpWindow_TextHotkeyIsValid].handle;
 				if (newHotkeyRegisteredSuccessfully)
 				{
-					char newWindowTitle[256] = {};
-					Dqn_sprintf  (newWindowTitle, "Winjump | Press %s to activate Winjump", hotkeyString);
-					SetWindowText(client, newWindowTitle);
-
+					Winjump_SetActivateTitle(client, *currHotkey);
 					SetWindowText(textValidHotkey, "Hotkey is vacant and valid");
 				}
 				else
@@ -604,17 +610,17 @@ FILE_SCOPE LRESULT CALLBACK Win32TabCtrlCallback(HWND window, UINT msg, WPARAM w
 					// NOTE: LB_ERR if list unselected
 					if (selectedIndex != LB_ERR)
 					{
-						DqnArray<Win32Program> *programArray =
-						    &globalState.programArray;
+						DqnArray<WinjumpProgram> *programArray =
+						    &globalState.core.programArray;
 						DQN_ASSERT((i32)selectedIndex < programArray->count);
 
-						Win32Program showProgram =
+						WinjumpProgram showProgram =
 						    programArray->data[selectedIndex];
 						LRESULT itemPid = SendMessageW(handle, LB_GETITEMDATA,
 						                               selectedIndex, 0);
 						DQN_ASSERT((u32)itemPid == showProgram.pid);
 						SendMessageW(handle, LB_SETCURSEL, (WPARAM)-1, 0);
-						Win32DisplayWindow(showProgram.window);
+						Win32DisplayWindow((HWND)showProgram.window);
 					}
 				}
 				else
@@ -980,10 +986,18 @@ FILE_SCOPE LRESULT CALLBACK Win32MainCallback(HWND window, UINT msg, WPARAM wPar
 
 		case WM_HOTKEY:
 		{
+			// NOTE: The list is kept current whilst hidden so showing the window is just a paint.
+			// Paint synchronously so the recorded latency covers the first visible frame.
+			// GetMessageTime() is when the hotkey was posted, on the GetTickCount() clock, so the
+			// time it waited in the queue for the loop to wake is counted too.
+			DWORD msInQueue = GetTickCount() - (DWORD)GetMessageTime();
+			f64 hotkeyTime  = DqnTimer_NowInMs() - (f64)msInQueue;
 			Win32DisplayWindow(window);
 			HWND editBox =
 			    globalState.window[WinjumpWindow_InputSearchEntries].handle;
 			SetFocus(editBox);
+			RedrawWindow(window, NULL, NULL, RDW_INVALIDATE | RDW_UPDATENOW | RDW_ALLCHILDREN);
+			Profiler_Record(ProfilerZone_HotkeyToVisible, hotkeyTime, DqnTimer_NowInMs());
 		}
 		break;
 
@@ -998,13 +1012,15 @@ FILE_SCOPE LRESULT CALLBACK Win32MainCallback(HWND window, UINT msg, WPARAM wPar
 			////////////////////////////////////////////////////////////////////
 			HWND status = globalState.window[WinjumpWindow_StatusBar].handle;
 			{
-				// Setup the parts of the status bar
-				const WPARAM numParts  = 3;
+				// Setup the parts of the status bar. The last part holds the profiler
+				// zone timings, which is the longest string so it gets half the bar.
+				const WPARAM numParts  = 4;
 				i32 partsPos[numParts] = {};
 
-				i32 partsInterval = clientWidth / numParts;
-				for (i32 i      = 0; i < numParts; i++)
+				i32 partsInterval = (clientWidth / 2) / (numParts - 1);
+				for (i32 i      = 0; i < numParts - 1; i++)
 					partsPos[i] = partsInterval * (i + 1);
+				partsPos[numParts - 1] = -1; // Extend to the right edge
 				SendMessageW(status, SB_SETPARTS, numParts, (LPARAM)partsPos);
 
 				// Pass through message so windows can handle anchoring the bar
@@ -1072,47 +1088,65 @@ FILE_SCOPE LRESULT CALLBACK Win32MainCallback(HWND window, UINT msg, WPARAM wPar
 	return result;
 }
 
-FILE_SCOPE bool
-Winjump_ProgramArrayShallowCopyArrayInternal(DqnArray<Win32Program> *src,
-                                             DqnArray<Win32Program> *dest)
+////////////////////////////////////////////////////////////////////////////////
+// Win32 Window Source
+////////////////////////////////////////////////////////////////////////////////
+FILE_SCOPE void Win32WindowSourceEnumerate(WinjumpWindowSource *const source, WinjumpCore *const core)
 {
-	if (src && dest)
-	{
-		// NOTE: Once we take a snapshot, we stop enumerating windows, so we
-		// only need to allocate exactly array->count
-		if (DqnArray_Init(dest, (size_t)src->count))
-		{
-			DQN_ASSERT(src->data && dest->data);
-			memcpy(dest->data, src->data, (size_t)src->count * sizeof(*src->data));
-			DQN_ASSERT(src->data && dest->data);
-			dest->count = src->count;
-			return true;
-		}
-	}
-
-	return false;
+	EnumWindows(Win32EnumWindowsCallback, (LPARAM)core);
 }
 
-FILE_SCOPE bool
-Winjump_ProgramArrayRestoreSnapshot(WinjumpState *state,
-                                       DqnArray<Win32Program> *snapshot)
+FILE_SCOPE i32 Win32WindowSourceResolveExe(WinjumpWindowSource *const source, const u32 pid,
+                                           wchar_t *const exe, const i32 exeSize)
 {
-	bool result = Winjump_ProgramArrayShallowCopyArrayInternal(
-	    snapshot, &state->programArray);
+	i32 result = Win32ResolveProcessExe(pid, exe, exeSize);
 	return result;
 }
 
-FILE_SCOPE bool
-Winjump_ProgramArrayCreateSnapshot(WinjumpState *state,
-                                      DqnArray<Win32Program> *snapshot)
+// NOTE: Wake the event loop, the exe is merged into the list on the next update
+FILE_SCOPE void Win32WindowSourceOnExeResolved(WinjumpWindowSource *const source)
 {
-	bool result = Winjump_ProgramArrayShallowCopyArrayInternal(
-	    &state->programArray, snapshot);
-	return result;
+	HWND mainWindow = (HWND)source->userData;
+	PostMessageW(mainWindow, WINJUMP_WM_EXE_RESOLVED, 0, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Win32 List View
+////////////////////////////////////////////////////////////////////////////////
+FILE_SCOPE void Win32ListViewSetRow(WinjumpListView *const view, const i32 index,
+                                    const WinjumpProgram *const program)
+{
+	HWND listBox = (HWND)view->userData;
+	SendMessageW(listBox, LB_INSERTSTRING, index, (LPARAM)program->friendlyName);
+	SendMessageW(listBox, LB_DELETESTRING, index + 1, 0);
+	SendMessageW(listBox, LB_SETITEMDATA, index, program->pid);
+}
+
+FILE_SCOPE void Win32ListViewAddRow(WinjumpListView *const view, const WinjumpProgram *const program)
+{
+	HWND listBox        = (HWND)view->userData;
+	LRESULT insertIndex = SendMessageW(listBox, LB_ADDSTRING, 0, (LPARAM)program->friendlyName);
+	SendMessageW(listBox, LB_SETITEMDATA, insertIndex, program->pid);
 }
 
-DQN_FILE_SCOPE inline void WStrToLower(wchar_t *const str, const i32 len) {
-	for (i32 i = 0; i < len; i++) str[i] = DqnWChar_ToLower(str[i]);
+FILE_SCOPE void Win32ListViewRemoveRow(WinjumpListView *const view, const i32 index)
+{
+	HWND listBox = (HWND)view->userData;
+	SendMessageW(listBox, LB_DELETESTRING, index, 0);
+}
+
+// Schedule the wake up for the next enumeration. Enumeration is frozen whilst filtering, so the
+// task waits until the search is cleared.
+FILE_SCOPE void Winjump_EnumerateTaskReschedule(WinjumpState *const state)
+{
+	if (state->core.isFilteringResults)
+	{
+		DqnTimerWheel_Cancel(&state->timerWheel, &state->enumerateTask);
+		return;
+	}
+
+	f64 msUntilDue = WinjumpCore_MsUntilEnumerateDue(&state->core, DqnTimer_NowInMs());
+	DqnTimerWheel_Schedule(&state->timerWheel, &state->enumerateTask, msUntilDue);
 }
 
 void Winjump_Update(WinjumpState *state)
@@ -1120,231 +1154,503 @@ void Winjump_Update(WinjumpState *state)
 	HWND listBox = state->window[WinjumpWindow_ListProgramEntries].handle;
 	i32 firstVisibleIndex = (i32)SendMessageW(listBox, LB_GETTOPINDEX, 0, 0);
 
-	// NOTE: Set first char is size of buffer as required by win32
-	wchar_t newSearchStr[WIN32_MAX_PROGRAM_TITLE] = {};
-	newSearchStr[0]  = DQN_ARRAY_COUNT(newSearchStr);
+	DqnScratchGuard scratch;
+	wchar_t *newSearchStr = (wchar_t *)scratch.Push(WIN32_MAX_PROGRAM_TITLE * sizeof(wchar_t));
+	if (!newSearchStr)
+	{
+		DQN_WIN32_ERROR_BOX("Winjump_Update() failed: Out of memory ", NULL);
+		globalRunning = false;
+		return;
+	}
+
+	// NOTE: Set first char is size of buffer as required by win32, the line isn't null terminated
+	newSearchStr[0]  = (wchar_t)WIN32_MAX_PROGRAM_TITLE;
 	HWND editBox     = state->window[WinjumpWindow_InputSearchEntries].handle;
 	i32 newSearchLen = (i32)SendMessageW(editBox, EM_GETLINE, 0, (LPARAM)newSearchStr);
+	newSearchLen     = DQN_MIN(newSearchLen, (i32)WIN32_MAX_PROGRAM_TITLE - 1);
+
+	newSearchStr[newSearchLen] = 0;
+
+	if (state->isRecordingTrace)
+		WinjumpTraceRecorder_RecordQuery(&state->traceRecorder, newSearchStr, newSearchLen);
+
+	bool filterFinished = true;
+	if (!WinjumpCore_Update(&state->core, newSearchStr, newSearchLen, &filterFinished))
+	{
+		DQN_WIN32_ERROR_BOX("WinjumpCore_Update() failed: Out of memory ", NULL);
+		globalRunning = false;
+		return;
+	}
+
+	if (state->isDaemonRunning && !WinjumpDaemon_Publish(&state->daemon, &state->core))
+	{
+		DQN_WIN32_ERROR_BOX("WinjumpDaemon_Publish() failed: Out of memory ", NULL);
+		globalRunning = false;
+		return;
+	}
+
+	if (state->isSharingTable) WinjumpSharedTable_Publish(&state->sharedTable, &state->core);
+
+	// NOTE: Come back for the rest on the next update, after any pending input is handled
+	if (!filterFinished) state->updateRequested = true;
+	Winjump_EnumerateTaskReschedule(state);
+
+	if (!WinjumpCore_ListSync(&state->core, &state->listView))
+	{
+		DQN_WIN32_ERROR_BOX("WinjumpCore_ListSync() failed: Out of memory ", NULL);
+		globalRunning = false;
+		return;
+	}
+	SendMessageW(listBox, LB_SETTOPINDEX, firstVisibleIndex, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Timer Tasks
+////////////////////////////////////////////////////////////////////////////////
+#define WINJUMP_TIMER_WHEEL_TICK_MS        1.0
+#define WINJUMP_MEMORY_POLL_INTERVAL_MS    1000.0
+#define WINJUMP_PROFILER_STATUS_REFRESH_MS 500.0
+#define WINJUMP_CONFIG_FLUSH_DELAY_MS      2000.0
+
+// NOTE: The loop makes the actual decision to enumerate in Winjump_Update(), the task only makes
+// sure we wake up for it.
+FILE_SCOPE void Winjump_EnumerateTaskCallback(DqnTimerWheelTask *const task, const f64 nowInMs)
+{
+	WinjumpState *state    = (WinjumpState *)task->userData;
+	state->updateRequested = true;
+}
+
+FILE_SCOPE void Winjump_MemoryPollTaskCallback(DqnTimerWheelTask *const task, const f64 nowInMs)
+{
+	WinjumpState *state = (WinjumpState *)task->userData;
+	HWND status         = state->window[WinjumpWindow_StatusBar].handle;
+
+	PROCESS_MEMORY_COUNTERS memCounter = {};
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &memCounter, sizeof(memCounter)))
+	{
+		WPARAM partToDisplayAt = 1;
+		char text[32]          = {};
+		Dqn_sprintf(text, "Memory: %'dkb", (u32)(memCounter.WorkingSetSize / 1024.0f));
+		SendMessage(status, SB_SETTEXT, partToDisplayAt, (LPARAM)text);
+	}
+}
+
+FILE_SCOPE void Winjump_ProfilerStatusTaskCallback(DqnTimerWheelTask *const task, const f64 nowInMs)
+{
+#if WINJUMP_PROFILER
+	// p50/p99 in ms per profiler zone in Status Bar
+	WinjumpState *state = (WinjumpState *)task->userData;
+	HWND status         = state->window[WinjumpWindow_StatusBar].handle;
+
+	ProfilerZoneStats stats[ProfilerZone_Count] = {};
+	Profiler_GetZoneStats(stats);
+
+	WPARAM partToDisplayAt = 3;
+	char text[256]         = {};
+	Profiler_ZoneStatsToString(stats, text, DQN_ARRAY_COUNT(text));
+	SendMessage(status, SB_SETTEXT, partToDisplayAt, (LPARAM)text);
+#endif
+}
 
-	LONG width, height;
-	DqnWin32_GetClientDim(editBox, &width, &height);
+FILE_SCOPE void Winjump_ConfigFlushTaskCallback(DqnTimerWheelTask *const task, const f64 nowInMs)
+{
+	WinjumpState *state = (WinjumpState *)task->userData;
+	if (state->configIsStale)
+	{
+		Config_WriteToDisk(state);
+		state->configIsStale = false;
+	}
+}
 
-	///////////////////////////////////////////////////////////////////////////
-	// Enumerate windows or initiate state for filtering
-	///////////////////////////////////////////////////////////////////////////
-	state->isFilteringResults            = (newSearchLen > 0);
-	DqnArray<Win32Program> *programArray = &state->programArray;
+// NOTE: The status bar tasks only refresh text nobody can see whilst hidden, so they're cancelled
+// rather than waking the loop. Showing refreshes the memory usage straight away.
+FILE_SCOPE void Winjump_StatusTasksSetActive(WinjumpState *const state, const bool active)
+{
+	if (active)
+	{
+		DqnTimerWheel_Schedule(&state->timerWheel, &state->memoryPollTask, 0);
+#if WINJUMP_PROFILER
+		DqnTimerWheel_Schedule(&state->timerWheel, &state->profilerStatusTask, WINJUMP_PROFILER_STATUS_REFRESH_MS);
+#endif
+	}
+	else
+	{
+		DqnTimerWheel_Cancel(&state->timerWheel, &state->memoryPollTask);
+		DqnTimerWheel_Cancel(&state->timerWheel, &state->profilerStatusTask);
+	}
+}
+
+FILE_SCOPE void Winjump_InitTimerTasks(WinjumpState *const state)
+{
+	DqnTimerWheel_Init(&state->timerWheel, WINJUMP_TIMER_WHEEL_TICK_MS, DqnTimer_NowInMs());
+
+	state->enumerateTask.callback = Winjump_EnumerateTaskCallback;
+	state->enumerateTask.userData = state;
 
-	// NOTE: If we are filtering, stop clearing out our array and freeze its
-	// state by stopping window enumeration on the array and instead work
-	// with a stack of snapshots of the state
-	if (state->isFilteringResults)
+	state->memoryPollTask.callback   = Winjump_MemoryPollTaskCallback;
+	state->memoryPollTask.userData   = state;
+	state->memoryPollTask.periodInMs = WINJUMP_MEMORY_POLL_INTERVAL_MS;
+
+#if WINJUMP_PROFILER
+	state->profilerStatusTask.callback   = Winjump_ProfilerStatusTaskCallback;
+	state->profilerStatusTask.userData   = state;
+	state->profilerStatusTask.periodInMs = WINJUMP_PROFILER_STATUS_REFRESH_MS;
+#endif
+
+	state->configFlushTask.callback = Winjump_ConfigFlushTaskCallback;
+	state->configFlushTask.userData = state;
+	Winjump_StatusTasksSetActive(state, true);
+}
+
+// Dispatch all timer tasks that are due. Config changes are flushed on a delay so a burst of edits
+// only writes once.
+FILE_SCOPE void Winjump_DispatchTimerTasks(WinjumpState *const state)
+{
+	DqnTimerWheel_Advance(&state->timerWheel, DqnTimer_NowInMs());
+
+	// NOTE: Schedule after advancing, delays count from the wheel's current tick which is otherwise
+	// still the one from before the loop slept.
+	if (state->configIsStale && !DqnTimerWheel_IsScheduled(&state->configFlushTask))
+		DqnTimerWheel_Schedule(&state->timerWheel, &state->configFlushTask, WINJUMP_CONFIG_FLUSH_DELAY_MS);
+}
+
+FILE_SCOPE void Winjump_UpdateStatusBar(WinjumpState *const state, const f64 frameTimeInMs)
+{
+	PROFILER_ZONE(ProfilerZone_StatusBar);
+	HWND status = state->window[WinjumpWindow_StatusBar].handle;
+
+	// Ms Per Frame and speculation hit rate text in Status Bar
 	{
-		DQN_ASSERT(newSearchLen > 0);
-		WStrToLower(newSearchStr, newSearchLen);
-		if (state->searchStringLen == newSearchLen)
+		WPARAM partToDisplayAt = 0;
+		char text[64]          = {};
+		const WinjumpSpeculationState *speculation = &state->core.speculation;
+		u32 numGuesses = speculation->numHits + speculation->numMisses;
+		if (numGuesses > 0)
 		{
-			// NOTE: It's possible to remove more than 1 character from the
-			// search string per frame
+			Dqn_sprintf(text, "MsPerFrame: %.2f Hits: %d%%", (f32)frameTimeInMs,
+			            (i32)((speculation->numHits * 100.0f) / numGuesses));
 		}
 		else
 		{
-			bool searchSpaceDecreased = (newSearchLen > state->searchStringLen);
-			if (searchSpaceDecreased)
-			{
-				if (state->programArray.count > 0)
-				{
-					DqnArray<Win32Program> snapshot = {};
-					if (Winjump_ProgramArrayCreateSnapshot(state, &snapshot))
-					{
-						DqnArray_Push(&state->programArraySnapshotStack, snapshot);
-					}
-					else
-					{
-						DQN_WIN32_ERROR_BOX("Winjump_ProgramArrayCreateSnapshot() failed: Out of memory ", NULL);
-						globalRunning = false;
-						return;
-					}
-				}
-			}
-			else
-			{
-				if (state->programArraySnapshotStack.count > 0)
-				{
-					DqnArray<Win32Program> *snapshot = &state->programArraySnapshotStack.data[state->programArraySnapshotStack.count- 1];
-					DqnArray_Pop(&state->programArraySnapshotStack);
-
-					Winjump_ProgramArrayRestoreSnapshot(state, snapshot);
-					DqnArray_Free(snapshot);
-				}
-			}
+			Dqn_sprintf(text, "MsPerFrame: %.2f", (f32)frameTimeInMs);
 		}
+		SendMessage(status, SB_SETTEXT, partToDisplayAt, (LPARAM)text);
 	}
-	else
+
+	// Active Windows text in Status Bar, or the filter's progress whilst it's running
 	{
-		for (i32 i = 0; i < state->programArraySnapshotStack.count; i++)
+		WPARAM partToDisplayAt = 2;
+		char text[32]          = {};
+		i32 numChecked         = state->core.filterNumChecked;
+		i32 numToCheck         = state->core.filterNumToCheck;
+		if (state->core.isFilteringResults && numChecked < numToCheck)
 		{
-			DqnArray<Win32Program> *result =
-			    &state->programArraySnapshotStack.data[i];
-			DqnArray_Free(result);
+			Dqn_sprintf(text, "Filtering: %d%%", (i32)((numChecked * 100.0f) / numToCheck));
 		}
-		DqnArray_Clear(programArray);
-		DqnArray_Clear(&state->programArraySnapshotStack);
+		else
+		{
+			Dqn_sprintf(text, "Active Windows: %d",
+			            state->core.programArray.count);
+		}
+		SendMessage(status, SB_SETTEXT, partToDisplayAt, (LPARAM)text);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main Loop
+////////////////////////////////////////////////////////////////////////////////
+// NOTE: Only the events that can change the Alt-Tab list are hooked, the object id check drops the
+// ones raised for child objects such as controls and carets.
+FILE_SCOPE void CALLBACK Win32WinEventCallback(HWINEVENTHOOK hook, DWORD event, HWND window,
+                                               LONG objectId, LONG childId, DWORD eventThread,
+                                               DWORD eventTime)
+{
+	if (objectId != OBJID_WINDOW || childId != CHILDID_SELF) return;
 
-		EnumWindows(Win32EnumWindowsCallback, (LPARAM)programArray);
+	switch (event)
+	{
+		case EVENT_OBJECT_CREATE:
+		case EVENT_OBJECT_DESTROY:
+		case EVENT_OBJECT_SHOW:
+		case EVENT_OBJECT_HIDE:
+		case EVENT_OBJECT_NAMECHANGE:
+		{
+			// NOTE: Don't wake for every event whilst hidden, the enumerate task is brought forward
+			// to the end of the batch window instead.
+			globalState.core.enumerateSchedule.windowsChanged = true;
+			if (globalState.core.isHidden) Winjump_EnumerateTaskReschedule(&globalState);
+			else                           globalState.updateRequested = true;
+		}
+		break;
 	}
-	state->searchStringLen = newSearchLen;
+}
 
-	////////////////////////////////////////////////////////////////////////////
-	// Filter program array if user is actively searching
-	////////////////////////////////////////////////////////////////////////////
-	if (state->isFilteringResults)
+struct Win32WinEventHooks
+{
+	HWINEVENTHOOK lifetime;   // EVENT_OBJECT_CREATE to EVENT_OBJECT_HIDE
+	HWINEVENTHOOK nameChange; // EVENT_OBJECT_NAMECHANGE
+};
+
+// NOTE: Out of context hooks are delivered through our message queue, so they also wake the event
+// loop. A hook covers a contiguous range of events, a single range from create to name change would
+// also take focus, selection, state and location changes which are raised for every caret and
+// cursor movement on the desktop, so the two ranges are hooked separately. A hook that could not be
+// installed is left NULL, in which case the event loop still refreshes on its fallback interval.
+FILE_SCOPE Win32WinEventHooks Win32RegisterWinEventHooks()
+{
+	const DWORD FLAGS         = WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS;
+	Win32WinEventHooks result = {};
+	result.lifetime   = SetWinEventHook(EVENT_OBJECT_CREATE, EVENT_OBJECT_HIDE, NULL,
+	                                    Win32WinEventCallback, 0, 0, FLAGS);
+	result.nameChange = SetWinEventHook(EVENT_OBJECT_NAMECHANGE, EVENT_OBJECT_NAMECHANGE, NULL,
+	                                    Win32WinEventCallback, 0, 0, FLAGS);
+	return result;
+}
+
+FILE_SCOPE void Win32UnregisterWinEventHooks(Win32WinEventHooks *const hooks)
+{
+	if (hooks->lifetime)   UnhookWinEvent(hooks->lifetime);
+	if (hooks->nameChange) UnhookWinEvent(hooks->nameChange);
+	*hooks = {};
+}
+
+FILE_SCOPE bool Win32MessageIsUserInput(const UINT msg)
+{
+	if (msg >= WM_KEYFIRST   && msg <= WM_KEYLAST)   return true;
+	if (msg >= WM_MOUSEFIRST && msg <= WM_MOUSELAST) return true;
+	if (msg == WM_HOTKEY) return true;
+	return false;
+}
+
+// Dispatch all pending messages, requests an update if any of them were user input or a finished
+// exe resolve job.
+// return: The number of messages dispatched.
+FILE_SCOPE u32 Win32PumpMessages(HWND window)
+{
+	u32 result = 0;
+	MSG msg;
+	while (PeekMessageW(&msg, window, 0, 0, PM_REMOVE))
 	{
-		DQN_ASSERT(newSearchLen < WIN32_MAX_PROGRAM_TITLE);
+		if (Win32MessageIsUserInput(msg.message) || msg.message == WINJUMP_WM_EXE_RESOLVED)
+			globalState.updateRequested = true;
+		TranslateMessage(&msg);
+		DispatchMessageW(&msg);
+		result++;
+	}
 
-		// NOTE: Really doubt we neeed any more than that
-		i32 userSpecifiedIndex      = 0;
-		i32 userSpecifiedNumbers[8] = {};
+	return result;
+}
 
-		for (i32 j = 0; j < newSearchLen && newSearchStr[j]; j++)
+// NOTE: When window is inactive, GetMessage will suspend the process if there are no messages. But
+// then once it gets activate it'll break out of the loop and continue as normal until window
+// becomes inactive.
+FILE_SCOPE void Win32BlockWhileInactive(HWND window)
+{
+	MSG msg;
+	while (globalWindowIsInactive && globalRunning)
+	{
+		BOOL result = GetMessageW(&msg, window, 0, 0);
+		if (result > 0)
 		{
-			if (DqnWChar_IsDigit(newSearchStr[j]))
-			{
-				i32 numberFoundInString =
-				    Dqn_WStrToI32(&newSearchStr[j], newSearchLen - j);
+			TranslateMessage(&msg);
+			DispatchMessageW(&msg);
+		}
+	}
 
-				// However many number of digits, increment the search ptr,
-				// because there may be multiple numbers in the search string
-				i32 tmp = userSpecifiedIndex;
-				do
-				{
-					tmp /= 10;
-					j++;
-				} while (tmp > 0);
+	// NOTE: Anything may have changed whilst we were away
+	globalState.updateRequested                       = true;
+	globalState.core.enumerateSchedule.windowsChanged = true;
+}
 
-				if (userSpecifiedIndex == DQN_ARRAY_COUNT(userSpecifiedNumbers))
-				{
-					DQN_WIN32_ERROR_BOX(
-					    "Winjump_Update() warning: No more space for user "
-					    "specified indexes", NULL);
-					break;
-				}
+struct WinjumpLoopStats
+{
+	u32 numWakeups; // Times the loop left the OS wait
+	u32 numUpdates; // Times Winjump_Update() was run
+};
+
+#define WINJUMP_LOOP_RUN_FOREVER 0
+#define WINJUMP_POLL_LOOP_FRAMES_PER_SECOND 24.0f
+
+// Fixed frame rate loop, runs a full update every frame whether or not anything changed.
+// runForMs:       Return after this many milliseconds, or WINJUMP_LOOP_RUN_FOREVER
+// ignoreInactive: Keep updating whilst the window is inactive, used for benchmarking
+FILE_SCOPE void Winjump_RunPollLoop(HWND mainWindow, const f64 runForMs, const bool ignoreInactive,
+                                    WinjumpLoopStats *const stats)
+{
+	const f32 targetFramesPerSecond = WINJUMP_POLL_LOOP_FRAMES_PER_SECOND;
+	f32 targetSecondsPerFrame       = 1 / targetFramesPerSecond;
+	f32 targetMsPerFrame            = targetSecondsPerFrame * 1000.0f;
 
-				userSpecifiedNumbers[userSpecifiedIndex++] =
-				    numberFoundInString;
-			}
-		}
+	f64 loopEndTime = DqnTimer_NowInMs() + runForMs;
+	while (globalRunning)
+	{
+		f64 startFrameTime = DqnTimer_NowInMs();
+		if (runForMs != WINJUMP_LOOP_RUN_FOREVER && startFrameTime >= loopEndTime) break;
 
-		u64 arraySize = programArray->count;
-		for (i32 index = 0; index < arraySize; index++)
-		{
-			Win32Program *program = &programArray->data[index];
-			wchar_t friendlyName[FRIENDLY_NAME_LEN] = {};
-			Winjump_GetProgramFriendlyName(program, friendlyName,
-			                                  DQN_ARRAY_COUNT(friendlyName));
-
-			// NOTE: +1 to lastStableIndex since list displays elements starting
-			// from 1 and lastStableIndex is zero-based
-			i32 programIndex             = program->lastStableIndex + 1;
-			bool specifiedNumberWasValid = false;
-			for (i32 i = 0; i < userSpecifiedIndex; i++)
-			{
-				// NOTE: Suppose we have indexes, 1 and 14. If 1 is input, we
-				// need both to remain in list entries. We can do this by
-				// eliminating digits from 14 by dividing by 10 until it
-				// matches.
-				i32 specifiedNumber = userSpecifiedNumbers[i];
-				i32 programIndexDigitCheck = programIndex;
-				do
-				{
-					if (specifiedNumber == programIndexDigitCheck)
-					{
-						specifiedNumberWasValid = true;
-						break;
-					}
-					programIndexDigitCheck /= 10;
-				} while (programIndexDigitCheck > 0);
+		if (!ignoreInactive) Win32BlockWhileInactive(mainWindow);
+		Win32PumpMessages(mainWindow);
+		Winjump_DispatchTimerTasks(&globalState);
 
-			}
-			if (specifiedNumberWasValid) continue;
+		Winjump_Update(&globalState);
+		globalState.updateRequested = false;
+		stats->numUpdates++;
 
-			if (!DqnWStr_HasSubstring(friendlyName, FRIENDLY_NAME_LEN, newSearchStr, newSearchLen))
-			{
-				// If search string doesn't match, delete it from display
-				DQN_ASSERT(DqnArray_RemoveStable(programArray, index--));
-				// Update index so we continue iterating over the correct
-				// elements after removing it from the list since the for
-				// loop is post increment and we're removing elements from
-				// the list
-				arraySize--;
-			}
+		////////////////////////////////////////////////////////////////////////
+		// Frame Limiting
+		////////////////////////////////////////////////////////////////////////
+		f64 endWorkTime  = DqnTimer_NowInMs();
+		f64 workTimeInMs = endWorkTime - startFrameTime;
+
+		if (workTimeInMs < targetMsPerFrame)
+		{
+			DWORD remainingTimeInMs = (DWORD)(targetMsPerFrame - workTimeInMs);
+			Sleep(remainingTimeInMs);
 		}
+		stats->numWakeups++;
+
+		f64 endFrameTime  = DqnTimer_NowInMs();
+		f64 frameTimeInMs = endFrameTime - startFrameTime;
+		Winjump_UpdateStatusBar(&globalState, frameTimeInMs);
 	}
+}
 
-	////////////////////////////////////////////////////////////////////////////
-	// Compare internal list with list box and remove dead ones
-	////////////////////////////////////////////////////////////////////////////
+// Blocks in MsgWaitForMultipleObjectsEx() until there's input, a hotkey, a window change
+// notification or the scheduled enumeration is due, and only then runs Winjump_Update(). The
+// scheduled enumeration catches changes that don't raise a WinEvent, i.e. a window becoming an
+// Alt-Tab candidate via a style change, and backs off whilst nothing changes.
+// runForMs:       Return after this many milliseconds, or WINJUMP_LOOP_RUN_FOREVER
+// ignoreInactive: Update at the visible cadence whilst the window is inactive, used for benchmarking
+FILE_SCOPE void Winjump_RunEventLoop(const f64 runForMs, const bool ignoreInactive,
+                                     WinjumpLoopStats *const stats)
+{
+	f64 loopEndTime = DqnTimer_NowInMs() + runForMs;
+
+	globalState.updateRequested = true;
+	while (globalRunning)
 	{
-		// Check displayed list entries against our new enumerated programs list
-		i32 programArraySize   = (i32)programArray->count;
-		const i32 listSize = (i32)SendMessageW(listBox, LB_GETCOUNT, 0, 0);
-		for (LRESULT index = 0;
-		     (index < listSize) && (index < programArraySize); index++)
+		f64 now = DqnTimer_NowInMs();
+		if (runForMs != WINJUMP_LOOP_RUN_FOREVER && now >= loopEndTime) break;
+
+		// NOTE: Keep running whilst hidden, enumeration drops to the hidden cadence so the list is
+		// already current when the hotkey brings the window back.
+		WinjumpCore *core = &globalState.core;
+		bool wasHidden    = core->isHidden;
+		core->isHidden    = (!ignoreInactive && globalWindowIsInactive);
+		if (wasHidden && !core->isHidden)
+		{
+			WinjumpCore_EnumerateScheduleReset(core);
+			Winjump_EnumerateTaskReschedule(&globalState);
+			Winjump_StatusTasksSetActive(&globalState, true);
+			if (core->enumerateSchedule.windowsChanged) globalState.updateRequested = true;
+		}
+		else if (!wasHidden && core->isHidden)
 		{
-			Win32Program *program = &programArray->data[index];
+			Winjump_StatusTasksSetActive(&globalState, false);
+		}
 
-			// TODO(doyle): Tighten memory alloc using len vars in program
-			wchar_t friendlyName[FRIENDLY_NAME_LEN] = {};
-			Winjump_GetProgramFriendlyName(program, friendlyName,
-			                               DQN_ARRAY_COUNT(friendlyName));
+		if (!globalState.updateRequested)
+		{
+			if (!core->isHidden) WinjumpCore_SpeculateNextChars(core);
 
-			wchar_t entry[FRIENDLY_NAME_LEN] = {};
-			LRESULT entryLen =
-			    SendMessageW(listBox, LB_GETTEXT, index, (LPARAM)entry);
-			if (DqnWStr_Cmp(friendlyName, entry) != 0)
+			// NOTE: Sleep until the next timer task is due, or indefinitely if there are none
+			f64 msUntilNextDue = DqnTimerWheel_MsUntilNextDue(&globalState.timerWheel, now);
+			if (runForMs != WINJUMP_LOOP_RUN_FOREVER)
 			{
-				LRESULT insertIndex = SendMessageW(listBox, LB_INSERTSTRING,
-				                                   index, (LPARAM)friendlyName);
-
-				LRESULT itemCount =
-				    SendMessageW(listBox, LB_DELETESTRING, index + 1, 0);
+				f64 msUntilLoopEnd = loopEndTime - now;
+				if (msUntilNextDue == DQN_TIMER_WHEEL_NO_TASKS || msUntilLoopEnd < msUntilNextDue)
+					msUntilNextDue = msUntilLoopEnd;
 			}
 
-			// Compare list entry item data, pid
-			LRESULT entryPid =
-			    SendMessageW(listBox, LB_GETITEMDATA, index, 0);
-			if (program->pid != (DWORD)entryPid)
+			DWORD timeoutMs = INFINITE;
+			if (msUntilNextDue != DQN_TIMER_WHEEL_NO_TASKS)
 			{
-				LRESULT result = SendMessageW(listBox, LB_SETITEMDATA, index,
-				                              program->pid);
+				// NOTE: Round up, waking a hair early would just spin until the task is due
+				timeoutMs = (DWORD)msUntilNextDue;
+				if ((f64)timeoutMs < msUntilNextDue) timeoutMs++;
 			}
-		}
 
-		// Fill the remainder of the list
-		if (listSize < programArraySize)
-		{
-			for (i32 i = listSize; i < programArraySize; i++)
-			{
-				Win32Program *program = &programArray->data[i];
-				wchar_t friendlyName[FRIENDLY_NAME_LEN] = {};
-				Winjump_GetProgramFriendlyName(program, friendlyName,
-				                               DQN_ARRAY_COUNT(friendlyName));
-
-				LRESULT insertIndex = SendMessageW(listBox, LB_ADDSTRING, 0,
-				                                   (LPARAM)friendlyName);
-				LRESULT result = SendMessageW(listBox, LB_SETITEMDATA,
-				                              insertIndex, program->pid);
-			}
-		}
-		else
-		{
-			for (i32 i = programArraySize; i < listSize; i++)
-			{
-				LRESULT result = SendMessageW(listBox, LB_DELETESTRING, i, 0);
-			}
+			MsgWaitForMultipleObjectsEx(0, NULL, timeoutMs, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+			stats->numWakeups++;
 		}
 
-		SendMessageW(listBox, LB_SETTOPINDEX, firstVisibleIndex, 0);
+		// NOTE: Advance the wheel before pumping too, tasks scheduled by the WinEvent hook are
+		// relative to the wheel's current time which is stale after a long wait.
+		Winjump_DispatchTimerTasks(&globalState);
+
+		// NOTE: Pump for all windows on the thread (NULL) so WinEvent hook callbacks are delivered
+		Win32PumpMessages(NULL);
+		Winjump_DispatchTimerTasks(&globalState);
+		if (!globalState.updateRequested) continue;
+
+		f64 startWorkTime = DqnTimer_NowInMs();
+		globalState.updateRequested = false;
+		Winjump_Update(&globalState);
+		stats->numUpdates++;
+
+		f64 endWorkTime = DqnTimer_NowInMs();
+		Winjump_UpdateStatusBar(&globalState, endWorkTime - startWorkTime);
+	}
+}
+
+// Total user + kernel CPU time the process has consumed
+FILE_SCOPE f64 Win32GetProcessCPUTimeInMs()
+{
+	FILETIME creationTime, exitTime, kernelTime, userTime;
+	if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+		return 0;
+
+	ULARGE_INTEGER kernel, user;
+	kernel.LowPart  = kernelTime.dwLowDateTime;
+	kernel.HighPart = kernelTime.dwHighDateTime;
+	user.LowPart    = userTime.dwLowDateTime;
+	user.HighPart   = userTime.dwHighDateTime;
+
+	// NOTE: FILETIME is in 100 nanosecond intervals
+	f64 result = (kernel.QuadPart + user.QuadPart) / 10000.0;
+	return result;
+}
+
+// Runs the poll and event loops back to back with the window hidden and no user input, then writes
+// the CPU time, wakeups and updates per second of each to winjump_bench_idle.txt.
+FILE_SCOPE void Winjump_BenchmarkIdle(HWND mainWindow)
+{
+	const f64 RUN_FOR_MS = 10000;
+	ShowWindow(mainWindow, SW_HIDE);
+	Win32WinEventHooks winEventHooks = Win32RegisterWinEventHooks();
+
+	char report[1024] = {};
+	char *reportPtr   = report;
+	reportPtr += Dqn_sprintf(reportPtr, "Winjump idle benchmark, %.0fms per mode\n", RUN_FOR_MS);
+
+	const char *const MODE_NAMES[] = {"Poll ", "Event"};
+	for (i32 mode = 0; mode < DQN_ARRAY_COUNT(MODE_NAMES); mode++)
+	{
+		WinjumpLoopStats stats = {};
+		f64 startCPUTime       = Win32GetProcessCPUTimeInMs();
+		f64 startTime          = DqnTimer_NowInMs();
+
+		if (mode == 0) Winjump_RunPollLoop(mainWindow, RUN_FOR_MS, true, &stats);
+		else           Winjump_RunEventLoop(RUN_FOR_MS, true, &stats);
+
+		f64 elapsedS  = (DqnTimer_NowInMs() - startTime) / 1000.0;
+		f64 cpuTimeMs = Win32GetProcessCPUTimeInMs() - startCPUTime;
+		reportPtr += Dqn_sprintf(reportPtr,
+		                         "%s | CPU: %.2f%% (%.2fms) | Wakeups/s: %.2f | Updates/s: %.2f\n",
+		                         MODE_NAMES[mode], (cpuTimeMs / (elapsedS * 1000.0)) * 100.0,
+		                         cpuTimeMs, stats.numWakeups / elapsedS,
+		                         stats.numUpdates / elapsedS);
+	}
+	DQN_ASSERT((size_t)(reportPtr - report) < DQN_ARRAY_COUNT(report));
+	Win32UnregisterWinEventHooks(&winEventHooks);
+
+	DqnWin32_OutputDebugString("%s", report);
+	DqnFile file = {};
+	const char *const BENCH_OUTPUT_PATH = "winjump_bench_idle.txt";
+	if (DqnFile_Open(BENCH_OUTPUT_PATH, &file, DqnFilePermissionFlag_Write, DqnFileAction_ClearIfExist) ||
+	    DqnFile_Open(BENCH_OUTPUT_PATH, &file, DqnFilePermissionFlag_Write, DqnFileAction_CreateIfNotExist))
+	{
+		DqnFile_Write(&file, (u8 *)report, (size_t)(reportPtr - report), 0);
+		DqnFile_Close(&file);
 	}
 }
 
@@ -1401,19 +1707,67 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance,
 		return -1;
 	}
 
-	if (!DqnArray_Init(&globalState.programArray, 4))
+	globalState.windowSource.Enumerate     = Win32WindowSourceEnumerate;
+	globalState.windowSource.ResolveExe    = Win32WindowSourceResolveExe;
+	globalState.windowSource.OnExeResolved = Win32WindowSourceOnExeResolved;
+	globalState.windowSource.userData      = mainWindow;
+
+	globalState.listView.SetRow    = Win32ListViewSetRow;
+	globalState.listView.AddRow    = Win32ListViewAddRow;
+	globalState.listView.RemoveRow = Win32ListViewRemoveRow;
+	globalState.listView.userData  = globalState.window[WinjumpWindow_ListProgramEntries].handle;
+
+	// Command line switches
+	// -poll         Use the fixed frame rate poll-and-sleep loop instead of the event driven one
+	// -bench-idle   Hide the window, run both loop modes idle and write their CPU cost to disk
+	// -record-trace Record the window tables and searches to WINJUMP_TRACE_PATH for replaying
+	// -daemon       Serve searches of the window table to other processes at WINJUMP_DAEMON_ADDRESS
+	// -shared-table Publish the window table to shared memory at WINJUMP_SHARED_TABLE_NAME
+	i32 cmdLineLen = DqnStr_Len(lpCmdLine);
+	WinjumpWindowSource *windowSource = &globalState.windowSource;
+	if (DqnStr_HasSubstring(lpCmdLine, cmdLineLen, "-record-trace", DqnStr_Len("-record-trace")))
 	{
-		DQN_WIN32_ERROR_BOX("DqnArray_Init() failed: Not enough memory.",
-		                    NULL);
-		return -1;
+		if (!WinjumpTraceRecorder_Init(&globalState.traceRecorder, windowSource))
+		{
+			DQN_WIN32_ERROR_BOX("WinjumpTraceRecorder_Init() failed: Not enough memory.", NULL);
+			return -1;
+		}
+
+		globalState.isRecordingTrace = true;
+		windowSource                 = &globalState.traceRecorder.source;
 	}
 
-	if (!DqnArray_Init(&globalState.programArraySnapshotStack, 4))
+	if (!WinjumpCore_Init(&globalState.core, windowSource))
 	{
-		DQN_WIN32_ERROR_BOX("DqnArray_Init() failed: Not enough memory.", NULL);
+		DQN_WIN32_ERROR_BOX("WinjumpCore_Init() failed: Not enough memory or could not create worker threads.", NULL);
 		return -1;
 	}
 
+	if (DqnStr_HasSubstring(lpCmdLine, cmdLineLen, "-daemon", DqnStr_Len("-daemon")))
+	{
+		char address[DQN_ARRAY_COUNT(globalState.daemon.address)];
+		if (!WinjumpDaemon_GetDefaultAddress(address, DQN_ARRAY_COUNT(address)) ||
+		    !WinjumpDaemon_Start(&globalState.daemon, address))
+		{
+			DQN_WIN32_ERROR_BOX("WinjumpDaemon_Start() failed: Could not create the pipe, is another Winjump already serving queries?", NULL);
+			return -1;
+		}
+
+		globalState.isDaemonRunning = true;
+	}
+
+	if (DqnStr_HasSubstring(lpCmdLine, cmdLineLen, "-shared-table", DqnStr_Len("-shared-table")))
+	{
+		if (!WinjumpSharedTable_Create(&globalState.sharedTable, WINJUMP_SHARED_TABLE_NAME))
+		{
+			DQN_WIN32_ERROR_BOX("WinjumpSharedTable_Create() failed: Could not create the shared memory.", NULL);
+			return -1;
+		}
+
+		globalState.isSharingTable = true;
+	}
+
+	Winjump_InitTimerTasks(&globalState);
 
 	////////////////////////////////////////////////////////////////////////////
 	// Read Configuration if Exist
@@ -1425,94 +1779,37 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance,
 	////////////////////////////////////////////////////////////////////////////
 	// Update loop
 	////////////////////////////////////////////////////////////////////////////
-	const f32 targetFramesPerSecond = 24.0f;
-	f32 targetSecondsPerFrame       = 1 / targetFramesPerSecond;
-	f32 targetMsPerFrame            = targetSecondsPerFrame * 1000.0f;
-	f32 frameTimeInS                = 0.0f;
-
-	while (globalRunning)
+	if (DqnStr_HasSubstring(lpCmdLine, cmdLineLen, "-bench-idle", DqnStr_Len("-bench-idle")))
 	{
-		f64 startFrameTime = DqnTimer_NowInMs();
-
-		// NOTE: When window is inactive, GetMessage will suspend the process if
-		// there are no messages. But then once it gets activate it'll break out
-		// of the loop and continue as normal until window becomes inactive.
-		MSG msg;
-		while (globalWindowIsInactive)
-		{
-			BOOL result = GetMessageW(&msg, mainWindow, 0, 0);
-			if (result > 0)
-			{
-				TranslateMessage(&msg);
-				DispatchMessageW(&msg);
-			}
-		}
-
-		while (PeekMessageW(&msg, mainWindow, 0, 0, PM_REMOVE))
-		{
-			TranslateMessage(&msg);
-			DispatchMessageW(&msg);
-		}
-		Winjump_Update(&globalState);
-
-		////////////////////////////////////////////////////////////////////////
-		// Update Status Bar
-		////////////////////////////////////////////////////////////////////////
-		HWND status = globalState.window[WinjumpWindow_StatusBar].handle;
-		{
-			// Active Windows text in Status Bar
-			{
-				WPARAM partToDisplayAt = 2;
-				char text[32]          = {};
-				Dqn_sprintf(text, "Active Windows: %d",
-				            globalState.programArray.count);
-				SendMessage(status, SB_SETTEXT, partToDisplayAt, (LPARAM)text);
-			}
-
-			// Mem usage text in Status Bar
-			{
-				PROCESS_MEMORY_COUNTERS memCounter = {};
-				if (GetProcessMemoryInfo(GetCurrentProcess(), &memCounter,
-				                         sizeof(memCounter)))
-				{
-					WPARAM partToDisplayAt = 1;
-					char text[32]          = {};
-					Dqn_sprintf(text, "Memory: %'dkb",
-					              (u32)(memCounter.WorkingSetSize / 1024.0f));
-					SendMessage(status, SB_SETTEXT, partToDisplayAt,
-					            (LPARAM)text);
-				}
-			}
-		}
-
-		////////////////////////////////////////////////////////////////////////
-		// Frame Limiting
-		////////////////////////////////////////////////////////////////////////
-		f64 endWorkTime  = DqnTimer_NowInMs();
-		f64 workTimeInMs = endWorkTime - startFrameTime;
-
-		if (workTimeInMs < targetMsPerFrame)
-		{
-			DWORD remainingTimeInMs = (DWORD)(targetMsPerFrame - workTimeInMs);
-			Sleep(remainingTimeInMs);
-		}
+		Winjump_BenchmarkIdle(mainWindow);
+		return 0;
+	}
 
-		f64 endFrameTime  = DqnTimer_NowInMs();
-		f64 frameTimeInMs = endFrameTime - startFrameTime;
+	if (DqnStr_HasSubstring(lpCmdLine, cmdLineLen, "-poll", DqnStr_Len("-poll")))
+		globalState.loopMode = WinjumpLoopMode_Poll;
+	else
+		globalState.loopMode = WinjumpLoopMode_Event;
 
-		// Ms Per Frame text in Status Bar
-		{
-			WPARAM partToDisplayAt = 0;
-			char text[32]          = {};
-			Dqn_sprintf(text, "MsPerFrame: %.2f", (f32)frameTimeInMs);
-			SendMessage(status, SB_SETTEXT, partToDisplayAt, (LPARAM)text);
-		}
-	}
+	Win32WinEventHooks winEventHooks = Win32RegisterWinEventHooks();
+	WinjumpLoopStats loopStats       = {};
+	if (globalState.loopMode == WinjumpLoopMode_Poll)
+		Winjump_RunPollLoop(mainWindow, WINJUMP_LOOP_RUN_FOREVER, false, &loopStats);
+	else
+		Winjump_RunEventLoop(WINJUMP_LOOP_RUN_FOREVER, false, &loopStats);
+	Win32UnregisterWinEventHooks(&winEventHooks);
+	if (globalState.isDaemonRunning) WinjumpDaemon_Stop(&globalState.daemon);
+	if (globalState.isSharingTable)  WinjumpSharedTable_Destroy(&globalState.sharedTable);
 
 	////////////////////////////////////////////////////////////////////////////
 	// Write Config to Disk
 	////////////////////////////////////////////////////////////////////////////
 	if (globalState.configIsStale) Config_WriteToDisk(&globalState);
 
+	if (globalState.isRecordingTrace &&
+	    !WinjumpTraceRecorder_Write(&globalState.traceRecorder, WINJUMP_TRACE_PATH))
+	{
+		DQN_WIN32_ERROR_BOX("WinjumpTraceRecorder_Write() failed: Could not write " WINJUMP_TRACE_PATH, NULL);
+	}
+
 	return 0;
 }